@@ -0,0 +1,121 @@
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "src/render.h"
+
+namespace {
+
+static const char* kScenePath = "test/cornell_box/cornell_box.pbrt";
+static const char* kReferenceSampler =
+    "\"sobol\" \"integer pixelsamples\" 1024";
+
+// Returns the Cornell box scene with its Sampler directive replaced.
+std::string MakeScene(const std::string& sampler) {
+  std::ifstream file(kScenePath);
+  if (!file) {
+    std::cerr << "ERROR: Failed to open scene: " << kScenePath << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::string scene;
+  for (std::string line; std::getline(file, line);) {
+    if (line.compare(0, 8, "Sampler ") == 0) {
+      line = absl::StrCat("Sampler ", sampler);
+    }
+    absl::StrAppend(&scene, line, "\n");
+  }
+
+  return scene;
+}
+
+std::vector<COLOR3> Render(const std::string& sampler) {
+  std::stringstream input(MakeScene(sampler));
+  auto parser = iris::Parser::Create(input);
+  auto result = iris::RenderToFramebuffer(
+      parser, 0, 0.001, std::thread::hardware_concurrency(), false,
+      absl::nullopt, absl::nullopt, absl::nullopt);
+
+  size_t num_columns, num_rows;
+  FramebufferGetSize(std::get<0>(result).get(), &num_columns, &num_rows);
+
+  std::vector<COLOR3> pixels;
+  for (size_t row = 0; row < num_rows; row++) {
+    for (size_t column = 0; column < num_columns; column++) {
+      COLOR3 color;
+      ISTATUS status =
+          FramebufferGetPixel(std::get<0>(result).get(), column, row, &color);
+      if (status != ISTATUS_SUCCESS) {
+        exit(EXIT_FAILURE);
+      }
+      pixels.push_back(ColorConvert(color, COLOR_SPACE_XYZ));
+    }
+  }
+
+  return pixels;
+}
+
+const std::vector<COLOR3>& Reference() {
+  static const auto* reference =
+      new std::vector<COLOR3>(Render(kReferenceSampler));
+  return *reference;
+}
+
+double RootMeanSquaredError(const std::vector<COLOR3>& pixels) {
+  const auto& reference = Reference();
+
+  double sum = 0.0;
+  for (size_t i = 0; i < pixels.size(); i++) {
+    for (size_t j = 0; j < 3; j++) {
+      double error = pixels[i].values[j] - reference[i].values[j];
+      sum += error * error;
+    }
+  }
+
+  return std::sqrt(sum / (3.0 * pixels.size()));
+}
+
+// Reports the error of each sampler against a high sample count render at
+// equal numbers of samples per pixel. The time of each iteration is the time
+// taken to render.
+void BM_Convergence(benchmark::State& state, const char* sampler) {
+  std::string parameters =
+      absl::StrCat("\"", sampler, "\" \"integer pixelsamples\" ",
+                   state.range(0));
+  Reference();
+
+  double error = 0.0;
+  for (auto _ : state) {
+    error = RootMeanSquaredError(Render(parameters));
+  }
+  state.counters["rmse"] = error;
+}
+
+BENCHMARK_CAPTURE(BM_Convergence, halton, "halton")
+    ->Arg(4)
+    ->Arg(16)
+    ->Arg(64)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Convergence, sobol, "sobol")
+    ->Arg(4)
+    ->Arg(16)
+    ->Arg(64)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Convergence, zsobol, "zsobol")
+    ->Arg(4)
+    ->Arg(16)
+    ->Arg(64)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_Convergence, pmj02bn, "pmj02bn")
+    ->Arg(4)
+    ->Arg(16)
+    ->Arg(64)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
\ No newline at end of file
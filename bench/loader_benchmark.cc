@@ -0,0 +1,361 @@
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "iris_physx_toolkit/shapes/sphere.h"
+#include "src/common/error.h"
+#include "src/common/tokenizer.h"
+#include "src/directives/parser.h"
+#include "src/directives/scene_builder.h"
+#include "src/shapes/plymesh.h"
+#include "zlib.h"
+
+namespace {
+
+static const char* kSceneHeader =
+    "Film \"image\" \"integer xresolution\" 1 \"integer yresolution\" 1\n"
+    "Camera \"perspective\"\n"
+    "WorldBegin\n";
+
+// The inputs of the benchmarks are generated once into the temporary
+// directory of the run so that none need to be checked in.
+std::string TempPath(const std::string& name) {
+  const char* directory = getenv("TEST_TMPDIR");
+  return absl::StrCat(directory ? directory : "/tmp", "/", name);
+}
+
+void WriteFile(const std::string& path, const std::string& contents) {
+  std::ofstream file(path, std::ios::binary);
+  file << contents;
+  if (!file) {
+    std::cerr << "ERROR: Failed to write file: " << path << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+void Parse(const std::string& scene) {
+  std::stringstream input(scene);
+  auto parser = iris::Parser::Create(input);
+  benchmark::DoNotOptimize(
+      parser.Next(absl::nullopt, absl::nullopt, absl::nullopt));
+}
+
+// A square grid of num_cells by num_cells quads each split into two
+// triangles, with normals and uvs.
+struct Grid {
+  explicit Grid(size_t num_cells) : size(num_cells + 1) {}
+
+  size_t NumVertices() const { return size * size; }
+  size_t NumTriangles() const { return 2 * (size - 1) * (size - 1); }
+
+  template <typename Function>
+  void ForEachVertex(Function function) const {
+    for (size_t y = 0; y < size; y++) {
+      for (size_t x = 0; x < size; x++) {
+        float u = static_cast<float>(x) / (size - 1);
+        float v = static_cast<float>(y) / (size - 1);
+        function(u, v);
+      }
+    }
+  }
+
+  template <typename Function>
+  void ForEachTriangle(Function function) const {
+    for (size_t y = 0; y + 1 < size; y++) {
+      for (size_t x = 0; x + 1 < size; x++) {
+        int32_t v0 = static_cast<int32_t>(y * size + x);
+        function(v0, v0 + 1, v0 + static_cast<int32_t>(size) + 1);
+        function(v0, v0 + static_cast<int32_t>(size) + 1,
+                 v0 + static_cast<int32_t>(size));
+      }
+    }
+  }
+
+  size_t size;
+};
+
+template <typename Type>
+void Append(std::string* output, Type value) {
+  output->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+std::string MakeBinaryPly(const Grid& grid) {
+  std::string result = absl::StrCat(
+      "ply\n"
+      "format binary_little_endian 1.0\n"
+      "element vertex ",
+      grid.NumVertices(),
+      "\n"
+      "property float x\n"
+      "property float y\n"
+      "property float z\n"
+      "property float nx\n"
+      "property float ny\n"
+      "property float nz\n"
+      "property float u\n"
+      "property float v\n"
+      "element face ",
+      grid.NumTriangles(),
+      "\n"
+      "property list uchar int vertex_indices\n"
+      "end_header\n");
+
+  grid.ForEachVertex([&](float u, float v) {
+    for (float value : {u, v, 0.0f, 0.0f, 0.0f, 1.0f, u, v}) {
+      Append(&result, value);
+    }
+  });
+
+  grid.ForEachTriangle([&](int32_t v0, int32_t v1, int32_t v2) {
+    Append(&result, static_cast<uint8_t>(3));
+    Append(&result, v0);
+    Append(&result, v1);
+    Append(&result, v2);
+  });
+
+  return result;
+}
+
+std::string MakeTriangleMeshScene(const Grid& grid) {
+  std::string scene = kSceneHeader;
+  absl::StrAppend(&scene, "Shape \"trianglemesh\" \"integer indices\" [");
+  grid.ForEachTriangle([&](int32_t v0, int32_t v1, int32_t v2) {
+    absl::StrAppend(&scene, " ", v0, " ", v1, " ", v2);
+  });
+  absl::StrAppend(&scene, " ] \"point P\" [");
+  grid.ForEachVertex([&](float u, float v) {
+    absl::StrAppend(&scene, " ", u, " ", v, " 0");
+  });
+  absl::StrAppend(&scene, " ] \"normal N\" [");
+  grid.ForEachVertex([&](float, float) { absl::StrAppend(&scene, " 0 0 1"); });
+  absl::StrAppend(&scene, " ] \"float uv\" [");
+  grid.ForEachVertex(
+      [&](float u, float v) { absl::StrAppend(&scene, " ", u, " ", v); });
+  absl::StrAppend(&scene, " ]\nWorldEnd\n");
+  return scene;
+}
+
+// An RGB PNG with 8 bit channels compressed at the default level.
+std::string MakePng(size_t size) {
+  std::string pixels;
+  for (size_t y = 0; y < size; y++) {
+    pixels.push_back(0);  // No filtering
+    for (size_t x = 0; x < size; x++) {
+      pixels.push_back(static_cast<char>(x * 255 / size));
+      pixels.push_back(static_cast<char>(y * 255 / size));
+      pixels.push_back(static_cast<char>(((x ^ y) & 16) ? 255 : 0));
+    }
+  }
+
+  uLongf compressed_size = compressBound(pixels.size());
+  std::string compressed(compressed_size, '\0');
+  compress2(reinterpret_cast<Bytef*>(&compressed[0]), &compressed_size,
+            reinterpret_cast<const Bytef*>(pixels.data()), pixels.size(),
+            Z_DEFAULT_COMPRESSION);
+  compressed.resize(compressed_size);
+
+  auto append_big_endian = [](std::string* output, uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      output->push_back(static_cast<char>((value >> shift) & 0xFF));
+    }
+  };
+
+  std::string result = "\x89PNG\r\n\x1A\n";
+  auto append_chunk = [&](const char* type, const std::string& data) {
+    std::string chunk = type;
+    chunk += data;
+    append_big_endian(&result, static_cast<uint32_t>(data.size()));
+    result += chunk;
+    append_big_endian(
+        &result, crc32(0, reinterpret_cast<const Bytef*>(chunk.data()),
+                       chunk.size()));
+  };
+
+  std::string header;
+  append_big_endian(&header, static_cast<uint32_t>(size));
+  append_big_endian(&header, static_cast<uint32_t>(size));
+  header += std::string("\x08\x02\x00\x00\x00", 5);  // 8 bit RGB
+
+  append_chunk("IHDR", header);
+  append_chunk("IDAT", compressed);
+  append_chunk("IEND", "");
+
+  return result;
+}
+
+void BM_TokenizerNext(benchmark::State& state) {
+  std::string scene = kSceneHeader;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    absl::StrAppend(&scene, "AttributeBegin\n", "Translate ", i, " 0.5 -2\n",
+                    "Material \"plastic\" \"rgb Kd\" [0.25 0.5 0.75] "
+                    "\"float roughness\" 0.1\n",
+                    "Shape \"sphere\" \"float radius\" 0.5\n",
+                    "AttributeEnd\n");
+  }
+  absl::StrAppend(&scene, "WorldEnd\n");
+
+  std::string path = TempPath("tokenizer_benchmark.pbrt");
+  WriteFile(path, scene);
+
+  for (auto _ : state) {
+    auto tokenizer = iris::Tokenizer::CreateFromFile(path);
+    while (auto token = tokenizer.Next()) {
+      benchmark::DoNotOptimize(token);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * scene.size());
+}
+
+BENCHMARK(BM_TokenizerNext)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+
+// Includes creating the mesh and building its BVH, which are small next to
+// parsing the arrays of its parameters.
+void BM_ParseLargeArrays(benchmark::State& state) {
+  Grid grid(state.range(0));
+  std::string scene = MakeTriangleMeshScene(grid);
+  for (auto _ : state) {
+    Parse(scene);
+  }
+  state.SetBytesProcessed(state.iterations() * scene.size());
+  state.SetItemsProcessed(state.iterations() *
+                          (3 * grid.NumTriangles() + 8 * grid.NumVertices()));
+}
+
+BENCHMARK(BM_ParseLargeArrays)
+    ->Arg(128)
+    ->Arg(512)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_ReadPlyMesh(benchmark::State& state) {
+  Grid grid(state.range(0));
+  std::string path = TempPath(absl::StrCat("grid_", state.range(0), ".ply"));
+  WriteFile(path, MakeBinaryPly(grid));
+
+  for (auto _ : state) {
+    std::vector<POINT3> vertices;
+    std::vector<VECTOR3> normals;
+    std::vector<std::pair<float_t, float_t>> uvs;
+    std::vector<size_t> faces;
+    iris::ReadPlyMesh(path, path, &vertices, &normals, &uvs, &faces);
+    benchmark::DoNotOptimize(faces.data());
+  }
+  state.SetItemsProcessed(state.iterations() * grid.NumTriangles());
+}
+
+BENCHMARK(BM_ReadPlyMesh)
+    ->Arg(256)
+    ->Arg(1024)
+    ->Unit(benchmark::kMillisecond);
+
+// Parses a scene with a single plymesh shape, which also creates the mesh
+// and builds the BVH of the scene.
+void BM_ParsePlyMesh(benchmark::State& state) {
+  Grid grid(state.range(0));
+  std::string path = TempPath(absl::StrCat("grid_", state.range(0), ".ply"));
+  WriteFile(path, MakeBinaryPly(grid));
+
+  std::string scene = absl::StrCat(kSceneHeader,
+                                   "Shape \"plymesh\" \"string filename\" \"",
+                                   path, "\"\nWorldEnd\n");
+  for (auto _ : state) {
+    Parse(scene);
+  }
+  state.SetItemsProcessed(state.iterations() * grid.NumTriangles());
+}
+
+BENCHMARK(BM_ParsePlyMesh)
+    ->Arg(256)
+    ->Arg(1024)
+    ->Unit(benchmark::kMillisecond);
+
+// The transform stack is only reachable through the parser, so the chains
+// are pushed and popped without any shapes being created.
+void BM_TransformChain(benchmark::State& state) {
+  std::string scene = kSceneHeader;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    absl::StrAppend(&scene, "TransformBegin\n", "Translate ", i, " 1 2\n",
+                    "Rotate 30 0 1 0\n", "Scale 2 2 2\n",
+                    "ConcatTransform [1 0 0 0 0 1 0 0 0 0 1 0 1 2 3 1]\n",
+                    "TransformEnd\n");
+  }
+  absl::StrAppend(&scene, "WorldEnd\n");
+
+  for (auto _ : state) {
+    Parse(scene);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * 4);
+}
+
+BENCHMARK(BM_TransformChain)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+
+// Decodes the image and builds its mipmap with trilinear filtering, if the
+// second argument is non-zero, or EWA filtering.
+void BM_LoadImageMap(benchmark::State& state) {
+  std::string path =
+      TempPath(absl::StrCat("imagemap_", state.range(0), ".png"));
+  WriteFile(path, MakePng(state.range(0)));
+
+  std::string scene = absl::StrCat(
+      kSceneHeader, "Texture \"image\" \"spectrum\" \"imagemap\" ",
+      "\"string filename\" \"", path, "\" \"bool trilinear\" \"",
+      state.range(1) ? "true" : "false", "\"\nWorldEnd\n");
+  for (auto _ : state) {
+    Parse(scene);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) *
+                          state.range(0));
+}
+
+BENCHMARK(BM_LoadImageMap)
+    ->Args({512, 1})
+    ->Args({2048, 1})
+    ->Args({2048, 0})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_SceneBuilderBuild(benchmark::State& state) {
+  std::vector<iris::Shape> shapes;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    POINT3 origin = PointCreate(static_cast<float_t>(i % 100),
+                                static_cast<float_t>(i / 100 % 100),
+                                static_cast<float_t>(i / 10000));
+    iris::Shape shape;
+    ISTATUS status = EmissiveSphereAllocate(
+        origin, (float_t)0.25, nullptr, nullptr, nullptr, nullptr,
+        shape.release_and_get_address());
+    iris::SuccessOrOOM(status);
+    shapes.push_back(std::move(shape));
+  }
+
+  iris::Matrix identity;
+  for (auto _ : state) {
+    state.PauseTiming();
+    iris::SceneBuilder builder;
+    for (const auto& shape : shapes) {
+      builder.AddShape(shape, identity);
+    }
+    state.ResumeTiming();
+
+    benchmark::DoNotOptimize(builder.Build());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_SceneBuilderBuild)
+    ->Arg(10000)
+    ->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
\ No newline at end of file
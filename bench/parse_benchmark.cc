@@ -0,0 +1,80 @@
+#include <sstream>
+#include <string>
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "src/directives/parser.h"
+
+// These benchmarks only use the public parser interface so that the same file
+// can be built against earlier revisions of the parser to compare them.
+
+namespace {
+
+static const char kSceneHeader[] =
+    "Film \"image\" \"integer xresolution\" 1 \"integer yresolution\" 1\n"
+    "Camera \"perspective\"\n"
+    "WorldBegin\n";
+
+static const size_t kDirectivesPerObject = 5;
+
+std::string MakeScene(size_t num_objects) {
+  std::string scene = kSceneHeader;
+  for (size_t i = 0; i < num_objects; i++) {
+    absl::StrAppend(&scene, "AttributeBegin\n", "Translate ", i, " 0 0\n",
+                    "Material \"matte\" \"rgb Kd\" [0.5 0.5 0.5]\n",
+                    "Shape \"sphere\" \"float radius\" 0.5\n",
+                    "AttributeEnd\n");
+  }
+  absl::StrAppend(&scene, "WorldEnd\n");
+  return scene;
+}
+
+static const size_t kParametersPerObject = 8;
+
+// Small meshes and materials with several parameters each, so that most of
+// the time is spent parsing and matching parameters rather than geometry.
+std::string MakeParameterScene(size_t num_objects) {
+  std::string scene = kSceneHeader;
+  for (size_t i = 0; i < num_objects; i++) {
+    absl::StrAppend(
+        &scene, "AttributeBegin\n",
+        "Material \"plastic\" \"rgb Kd\" [0.5 0.5 0.5] \"rgb Ks\" ",
+        "[0.25 0.25 0.25] \"float roughness\" 0.1\n",
+        "Shape \"trianglemesh\" \"integer indices\" [0 1 2] ",
+        "\"point P\" [", i, " 0 0 ", i + 1, " 0 0 ", i, " 1 0] ",
+        "\"normal N\" [0 0 1 0 0 1 0 0 1] ",
+        "\"float uv\" [0 0 1 0 0 1] \"float alpha\" 1\n", "AttributeEnd\n");
+  }
+  absl::StrAppend(&scene, "WorldEnd\n");
+  return scene;
+}
+
+void ParseScene(benchmark::State& state, const std::string& scene) {
+  for (auto _ : state) {
+    std::stringstream input(scene);
+    auto parser = iris::Parser::Create(input);
+    benchmark::DoNotOptimize(
+        parser.Next(absl::nullopt, absl::nullopt, absl::nullopt));
+  }
+}
+
+void BM_ParseScene(benchmark::State& state) {
+  ParseScene(state, MakeScene(state.range(0)));
+  state.SetItemsProcessed(state.iterations() * state.range(0) *
+                          kDirectivesPerObject);
+}
+
+BENCHMARK(BM_ParseScene)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+void BM_ParseParameters(benchmark::State& state) {
+  ParseScene(state, MakeParameterScene(state.range(0)));
+  state.SetItemsProcessed(state.iterations() * state.range(0) *
+                          kParametersPerObject);
+}
+
+BENCHMARK(BM_ParseParameters)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
\ No newline at end of file
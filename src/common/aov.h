@@ -0,0 +1,31 @@
+#ifndef _SRC_COMMON_AOV_
+#define _SRC_COMMON_AOV_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace iris {
+
+// Values recorded at the first surface hit by each camera ray, averaged over
+// the samples of each pixel. Rays that miss the scene contribute zero.
+enum class Aov {
+  ALBEDO,  // The color of the reflector sampled from the BSDF
+  NORMAL,  // The world space shading normal
+  DEPTH    // The distance along the camera ray
+};
+
+// The values of one AOV in row major order, with one value per channel for
+// each pixel. Written as a layer with the given name.
+struct AovBuffer {
+  Aov aov;
+  std::string name;
+  std::vector<std::string> channels;
+  size_t num_columns;
+  size_t num_rows;
+  std::vector<float> values;
+};
+
+}  // namespace iris
+
+#endif  // _SRC_COMMON_AOV_
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include "src/common/arena.h"
+
+#include <cassert>
+
+namespace iris {
+
+void* Arena::Allocate(size_t size, size_t alignment) {
+  assert(size <= kMaxAllocation);
+  assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+  size_t offset = (m_offset + alignment - 1) & ~(alignment - 1);
+  if (m_blocks_used == 0 || kBlockSize < offset ||
+      kBlockSize - offset < size) {
+    if (m_blocks_used == m_blocks.size()) {
+      m_blocks.emplace_back(new char[kBlockSize]);
+    }
+
+    m_blocks_used += 1;
+    offset = 0;
+  }
+
+  m_offset = offset + size;
+  void* result = m_blocks[m_blocks_used - 1].get() + offset;
+
+#ifndef NDEBUG
+  m_live[result] = {m_blocks_used, offset};
+#endif  // NDEBUG
+
+  return result;
+}
+
+void Arena::Rewind(Position position) {
+  assert(position.blocks_used <= m_blocks_used);
+
+#ifndef NDEBUG
+  for (const auto& live : m_live) {
+    assert(live.second.blocks_used < position.blocks_used ||
+           (live.second.blocks_used == position.blocks_used &&
+            live.second.offset < position.offset));
+  }
+#endif  // NDEBUG
+
+  m_blocks_used = position.blocks_used;
+  m_offset = position.offset;
+}
+
+Arena& ThreadArena() {
+  thread_local Arena arena;
+  return arena;
+}
+
+}  // namespace iris
\ No newline at end of file
@@ -0,0 +1,130 @@
+#ifndef _SRC_COMMON_ARENA_
+#define _SRC_COMMON_ARENA_
+
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace iris {
+
+// A bump allocator for short lived parse temporaries. Memory is never freed
+// individually; instead the arena is rewound to a previously marked position
+// and the blocks it owns are reused by later allocations.
+class Arena {
+ public:
+  static constexpr size_t kBlockSize = 64 * 1024;
+  static constexpr size_t kMaxAllocation = 4 * 1024;
+
+  struct Position {
+    size_t blocks_used;
+    size_t offset;
+  };
+
+  Arena() : m_blocks_used(0), m_offset(0) {}
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  void* Allocate(size_t size, size_t alignment);
+
+  // Called when an allocation is no longer in use. Debug builds check that
+  // the arena is never rewound past an allocation that is still live.
+  void Release(const void* pointer) {
+#ifndef NDEBUG
+    m_live.erase(pointer);
+#endif  // NDEBUG
+  }
+
+  Position Mark() const { return {m_blocks_used, m_offset}; }
+  void Rewind(Position position);
+
+ private:
+  std::vector<std::unique_ptr<char[]>> m_blocks;
+  size_t m_blocks_used;
+  size_t m_offset;
+
+#ifndef NDEBUG
+  std::map<const void*, Position> m_live;
+#endif  // NDEBUG
+};
+
+// Returns the arena used by the calling thread for parameter storage.
+Arena& ThreadArena();
+
+// Standard allocator backed by an arena. Allocations larger than
+// Arena::kMaxAllocation, and all allocations made by a default constructed
+// allocator, come from the heap instead so that large arrays can outlive the
+// arena they were parsed into.
+template <typename T>
+class ArenaAllocator {
+ public:
+  typedef T value_type;
+  typedef std::true_type propagate_on_container_move_assignment;
+  typedef std::true_type propagate_on_container_swap;
+
+  ArenaAllocator() : m_arena(nullptr) {}
+  explicit ArenaAllocator(Arena& arena) : m_arena(&arena) {}
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : m_arena(other.m_arena) {}
+
+  T* allocate(size_t n) {
+    if (!UsesArena(n)) {
+      return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    return static_cast<T*>(m_arena->Allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* pointer, size_t n) {
+    if (!UsesArena(n)) {
+      ::operator delete(pointer);
+    } else {
+      m_arena->Release(pointer);
+    }
+  }
+
+  ArenaAllocator select_on_container_copy_construction() const {
+    return ArenaAllocator();
+  }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& other) const {
+    return m_arena == other.m_arena;
+  }
+
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U>& other) const {
+    return m_arena != other.m_arena;
+  }
+
+ private:
+  bool UsesArena(size_t n) const {
+    return m_arena && n <= Arena::kMaxAllocation / sizeof(T);
+  }
+
+  Arena* m_arena;
+
+  template <typename U>
+  friend class ArenaAllocator;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// Returns the contents of vector in storage that stays valid after the arena
+// it was allocated from is rewound. Arrays too large for the arena are already
+// on the heap and are moved without copying.
+template <typename T>
+ArenaVector<T> Steal(ArenaVector<T>& vector) {
+  if (vector.capacity() > Arena::kMaxAllocation / sizeof(T)) {
+    return std::move(vector);
+  }
+  return ArenaVector<T>(std::make_move_iterator(vector.begin()),
+                        std::make_move_iterator(vector.end()));
+}
+
+}  // namespace iris
+
+#endif  // _SRC_COMMON_ARENA_
\ No newline at end of file
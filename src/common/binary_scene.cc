@@ -0,0 +1,267 @@
+#include "src/common/binary_scene.h"
+
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+// TODO: Make this platform independent
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace iris {
+namespace {
+
+static const char kMagic[8] = {'I', 'R', 'I', 'S', 'P', 'B', 'R', 'T'};
+static const size_t kAlignment = 4;
+
+static size_t AlignOffset(size_t offset) {
+  return (offset + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+static bool IsLittleEndian() {
+  uint32_t value = 1;
+  char first_byte;
+  memcpy(&first_byte, &value, 1);
+  return first_byte == 1;
+}
+
+}  // namespace
+
+BinarySceneReader::BinarySceneReader(std::string path, const char* data,
+                                     size_t size)
+    : m_path(std::move(path)),
+      m_data(data),
+      m_size(size),
+      m_offset(sizeof(kMagic)) {
+  ReadStringTable();
+}
+
+BinarySceneReader::BinarySceneReader(std::string path, std::string contents)
+    : m_path(std::move(path)),
+      m_contents(std::move(contents)),
+      m_data(m_contents.data()),
+      m_size(m_contents.size()),
+      m_offset(sizeof(kMagic)) {
+  ReadStringTable();
+}
+
+void BinarySceneReader::ReadStringTable() {
+  uint32_t num_strings = ReadUInt32();
+  for (uint32_t i = 0; i < num_strings; i++) {
+    uint32_t length = ReadUInt32();
+    if (m_size - m_offset < length) {
+      Error();
+    }
+    m_strings.emplace_back(m_data + m_offset, length);
+    m_offset += length;
+  }
+  m_offset = AlignOffset(m_offset);
+}
+
+BinarySceneReader::~BinarySceneReader() {
+  if (m_contents.empty()) {
+    munmap(const_cast<char*>(m_data), m_size);
+  }
+}
+
+std::unique_ptr<BinarySceneReader> BinarySceneReader::Open(
+    const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+
+  char magic[sizeof(kMagic)];
+  struct stat file_stat;
+  if (read(fd, magic, sizeof(magic)) != sizeof(magic) ||
+      memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+      fstat(fd, &file_stat) != 0) {
+    close(fd);
+    return nullptr;
+  }
+
+  if (!IsLittleEndian()) {
+    std::cerr << "ERROR: Binary scenes are only supported on little-endian "
+                 "machines"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  size_t size = file_stat.st_size;
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if (data == MAP_FAILED) {
+    std::cerr << "ERROR: Error mapping file: " << path << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  madvise(data, size, MADV_SEQUENTIAL);
+
+  return std::unique_ptr<BinarySceneReader>(
+      new BinarySceneReader(path, static_cast<const char*>(data), size));
+}
+
+std::unique_ptr<BinarySceneReader> BinarySceneReader::Open(
+    const BinarySceneWriter& writer) {
+  std::ostringstream output;
+  writer.Write(output);
+  return std::unique_ptr<BinarySceneReader>(
+      new BinarySceneReader("<memory>", output.str()));
+}
+
+absl::optional<BinaryRecord> BinarySceneReader::PeekRecord() const {
+  if (m_offset == m_size) {
+    return absl::nullopt;
+  }
+
+  uint8_t tag = static_cast<uint8_t>(m_data[m_offset]);
+  if (static_cast<uint8_t>(BinaryRecord::INTS) < tag) {
+    Error();
+  }
+
+  return static_cast<BinaryRecord>(tag);
+}
+
+bool BinarySceneReader::NextToken(absl::string_view* token) {
+  auto record = PeekRecord();
+  if (!record) {
+    return false;
+  }
+
+  if (*record != BinaryRecord::TOKEN) {
+    std::cerr << "ERROR: Unexpected value array in binary scene: " << m_path
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  m_offset += 1;
+  uint32_t index = ReadUInt32();
+  if (m_strings.size() <= index) {
+    Error();
+  }
+
+  *token = m_strings[index];
+  return true;
+}
+
+bool BinarySceneReader::NextIsArray() const {
+  auto record = PeekRecord();
+  return record && *record != BinaryRecord::TOKEN;
+}
+
+absl::optional<absl::Span<const float>> BinarySceneReader::NextFloats() {
+  static_assert(sizeof(float) == sizeof(uint32_t));
+
+  auto record = PeekRecord();
+  if (!record || *record != BinaryRecord::FLOATS) {
+    return absl::nullopt;
+  }
+
+  m_offset = AlignOffset(m_offset + 1);
+  uint32_t count = ReadUInt32();
+  if ((m_size - m_offset) / sizeof(float) < count) {
+    Error();
+  }
+
+  const float* values = reinterpret_cast<const float*>(m_data + m_offset);
+  m_offset += count * sizeof(float);
+
+  return absl::MakeConstSpan(values, count);
+}
+
+absl::optional<absl::Span<const int32_t>> BinarySceneReader::NextInts() {
+  auto record = PeekRecord();
+  if (!record || *record != BinaryRecord::INTS) {
+    return absl::nullopt;
+  }
+
+  m_offset = AlignOffset(m_offset + 1);
+  uint32_t count = ReadUInt32();
+  if ((m_size - m_offset) / sizeof(int32_t) < count) {
+    Error();
+  }
+
+  const int32_t* values = reinterpret_cast<const int32_t*>(m_data + m_offset);
+  m_offset += count * sizeof(int32_t);
+
+  return absl::MakeConstSpan(values, count);
+}
+
+uint32_t BinarySceneReader::ReadUInt32() {
+  if (m_size < m_offset || m_size - m_offset < sizeof(uint32_t)) {
+    Error();
+  }
+
+  uint32_t result;
+  memcpy(&result, m_data + m_offset, sizeof(uint32_t));
+  m_offset += sizeof(uint32_t);
+
+  return result;
+}
+
+void BinarySceneReader::Error [[noreturn]] () const {
+  std::cerr << "ERROR: Malformed binary scene: " << m_path << std::endl;
+  exit(EXIT_FAILURE);
+}
+
+void BinarySceneWriter::AddToken(absl::string_view token) {
+  auto iter = m_string_indices.find(token);
+  if (iter == m_string_indices.end()) {
+    uint32_t index = static_cast<uint32_t>(m_strings.size());
+    m_strings.emplace_back(token);
+    iter = m_string_indices.emplace(m_strings.back(), index).first;
+  }
+
+  m_records.push_back(static_cast<char>(BinaryRecord::TOKEN));
+  AddUInt32(iter->second);
+}
+
+void BinarySceneWriter::AddFloats(absl::Span<const float> values) {
+  m_records.push_back(static_cast<char>(BinaryRecord::FLOATS));
+  m_records.resize(AlignOffset(m_records.size()), '\0');
+  AddUInt32(static_cast<uint32_t>(values.size()));
+  m_records.append(reinterpret_cast<const char*>(values.data()),
+                   values.size() * sizeof(float));
+}
+
+void BinarySceneWriter::AddInts(absl::Span<const int32_t> values) {
+  m_records.push_back(static_cast<char>(BinaryRecord::INTS));
+  m_records.resize(AlignOffset(m_records.size()), '\0');
+  AddUInt32(static_cast<uint32_t>(values.size()));
+  m_records.append(reinterpret_cast<const char*>(values.data()),
+                   values.size() * sizeof(int32_t));
+}
+
+bool BinarySceneWriter::Write(std::ostream& output) const {
+  if (!IsLittleEndian()) {
+    std::cerr << "ERROR: Binary scenes are only supported on little-endian "
+                 "machines"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::string header(kMagic, sizeof(kMagic));
+
+  uint32_t num_strings = static_cast<uint32_t>(m_strings.size());
+  header.append(reinterpret_cast<const char*>(&num_strings), sizeof(uint32_t));
+  for (const auto& entry : m_strings) {
+    uint32_t length = static_cast<uint32_t>(entry.size());
+    header.append(reinterpret_cast<const char*>(&length), sizeof(uint32_t));
+    header.append(entry);
+  }
+  header.resize(AlignOffset(header.size()), '\0');
+
+  output.write(header.data(), header.size());
+  output.write(m_records.data(), m_records.size());
+
+  return output.good();
+}
+
+void BinarySceneWriter::AddUInt32(uint32_t value) {
+  m_records.append(reinterpret_cast<const char*>(&value), sizeof(uint32_t));
+}
+
+}  // namespace iris
\ No newline at end of file
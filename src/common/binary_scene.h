@@ -0,0 +1,90 @@
+#ifndef _SRC_COMMON_BINARY_SCENE_
+#define _SRC_COMMON_BINARY_SCENE_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+
+namespace iris {
+
+class BinarySceneWriter;
+
+// A binary encoding of the token stream of a pbrt file, produced by
+// iris_convert. The file begins with an 8 byte magic number, followed by a
+// string table holding every distinct token and then a stream of records.
+// Each record is a one byte tag followed by either a string table index or a
+// count and an array of raw little-endian 32-bit values. Arrays are padded to
+// 4 byte alignment so that they can be read in place from the mapped file.
+enum class BinaryRecord : uint8_t {
+  TOKEN = 0,
+  FLOATS = 1,
+  INTS = 2,
+};
+
+class BinarySceneReader {
+ public:
+  BinarySceneReader(const BinarySceneReader&) = delete;
+  BinarySceneReader& operator=(const BinarySceneReader&) = delete;
+  ~BinarySceneReader();
+
+  // Returns nullptr if the file is not a binary scene
+  static std::unique_ptr<BinarySceneReader> Open(const std::string& path);
+
+  // Reads back the records added to writer so far from memory
+  static std::unique_ptr<BinarySceneReader> Open(
+      const BinarySceneWriter& writer);
+
+  // Returns false once the end of the file has been reached
+  bool NextToken(absl::string_view* token);
+  bool NextIsArray() const;
+  absl::optional<absl::Span<const float>> NextFloats();
+  absl::optional<absl::Span<const int32_t>> NextInts();
+
+ private:
+  BinarySceneReader(std::string path, const char* data, size_t size);
+  BinarySceneReader(std::string path, std::string contents);
+
+  void ReadStringTable();
+  absl::optional<BinaryRecord> PeekRecord() const;
+  uint32_t ReadUInt32();
+  void Error [[noreturn]] () const;
+
+  std::string m_path;
+  std::string m_contents;
+  const char* m_data;
+  size_t m_size;
+  size_t m_offset;
+  std::vector<absl::string_view> m_strings;
+};
+
+class BinarySceneWriter {
+ public:
+  BinarySceneWriter() = default;
+  BinarySceneWriter(const BinarySceneWriter&) = delete;
+  BinarySceneWriter& operator=(const BinarySceneWriter&) = delete;
+
+  void AddToken(absl::string_view token);
+  void AddFloats(absl::Span<const float> values);
+  void AddInts(absl::Span<const int32_t> values);
+
+  bool Write(std::ostream& output) const;
+
+ private:
+  void AddUInt32(uint32_t value);
+
+  absl::flat_hash_map<absl::string_view, uint32_t> m_string_indices;
+  std::deque<std::string> m_strings;
+  std::string m_records;
+};
+
+}  // namespace iris
+
+#endif  // _SRC_COMMON_BINARY_SCENE_
\ No newline at end of file
@@ -0,0 +1,289 @@
+#include "src/common/denoiser.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <thread>
+
+namespace iris {
+namespace {
+
+// The standard deviations of the terms of the filter weights. The lighting
+// and depth terms are relative to the magnitude of the values compared, the
+// spatial term is relative to the radius of the filter, and the remaining
+// terms are absolute.
+constexpr float kSpatialSigma = 0.5f;
+constexpr float kLightingSigma = 0.4f;
+constexpr float kAlbedoSigma = 0.1f;
+constexpr float kNormalSigma = 0.25f;
+constexpr float kDepthSigma = 0.05f;
+
+// Keeps relative differences finite where both values are near zero.
+constexpr float kRelativeEpsilon = 1e-4f;
+
+// Albedos below this are too dark to divide the lighting by and are filtered
+// as if they were white.
+constexpr float kMinAlbedo = 0.01f;
+
+// One channel of an image in row major order.
+typedef std::vector<float> Plane;
+
+struct Image {
+  size_t num_columns;
+  size_t num_rows;
+  Plane lighting[3];
+  Plane guide[3];
+  Plane albedo[3];
+  Plane normal[3];
+  Plane depth;
+};
+
+const AovBuffer* FindFeature(const std::vector<AovBuffer>& features,
+                             Aov aov) {
+  for (const auto& feature : features) {
+    if (feature.aov == aov) {
+      return &feature;
+    }
+  }
+  return nullptr;
+}
+
+void Deinterleave(const AovBuffer& buffer, Plane* planes) {
+  size_t num_channels = buffer.channels.size();
+  size_t num_pixels = buffer.num_columns * buffer.num_rows;
+  assert(buffer.values.size() == num_channels * num_pixels);
+
+  for (size_t channel = 0; channel < num_channels; channel++) {
+    planes[channel].resize(num_pixels);
+    for (size_t i = 0; i < num_pixels; i++) {
+      planes[channel][i] = buffer.values[i * num_channels + channel];
+    }
+  }
+}
+
+// Averages the lighting over 3x3 blocks so that the lighting term of the
+// weights is less sensitive to the noise being removed.
+void Prefilter(Image& image) {
+  size_t num_columns = image.num_columns;
+  size_t num_rows = image.num_rows;
+  for (size_t channel = 0; channel < 3; channel++) {
+    const Plane& lighting = image.lighting[channel];
+    Plane& guide = image.guide[channel];
+    guide.resize(lighting.size());
+    for (size_t row = 0; row < num_rows; row++) {
+      size_t min_row = (row == 0) ? 0 : row - 1;
+      size_t max_row = std::min(row + 2, num_rows);
+      for (size_t column = 0; column < num_columns; column++) {
+        size_t min_column = (column == 0) ? 0 : column - 1;
+        size_t max_column = std::min(column + 2, num_columns);
+
+        float sum = 0.0f;
+        for (size_t y = min_row; y < max_row; y++) {
+          for (size_t x = min_column; x < max_column; x++) {
+            sum += lighting[y * num_columns + x];
+          }
+        }
+
+        guide[row * num_columns + column] =
+            sum / static_cast<float>((max_row - min_row) *
+                                     (max_column - min_column));
+      }
+    }
+  }
+}
+
+float RelativeDistance(float a, float b) {
+  float difference = a - b;
+  return difference * difference / (kRelativeEpsilon + a * a + b * b);
+}
+
+// Filters one row of the lighting into sums. The window is visited one
+// offset at a time across the whole row so that each inner loop runs over
+// contiguous arrays without branches and can be vectorized.
+void FilterRow(const Image& image, size_t row, size_t radius,
+               std::vector<float>& distances, std::vector<float>& weights,
+               std::vector<float>* sums) {
+  size_t num_columns = image.num_columns;
+  std::fill(weights.begin(), weights.end(), 0.0f);
+  for (size_t channel = 0; channel < 3; channel++) {
+    std::fill(sums[channel].begin(), sums[channel].end(), 0.0f);
+  }
+
+  float spatial_sigma = kSpatialSigma * static_cast<float>(radius);
+  float spatial_scale = 0.5f / (spatial_sigma * spatial_sigma);
+  float lighting_scale = 0.5f / (kLightingSigma * kLightingSigma);
+  float albedo_scale = 0.5f / (kAlbedoSigma * kAlbedoSigma);
+  float normal_scale = 0.5f / (kNormalSigma * kNormalSigma);
+  float depth_scale = 0.5f / (kDepthSigma * kDepthSigma);
+
+  size_t min_row = (row < radius) ? 0 : row - radius;
+  size_t max_row = std::min(row + radius + 1, image.num_rows);
+  for (size_t other_row = min_row; other_row < max_row; other_row++) {
+    ptrdiff_t dy = static_cast<ptrdiff_t>(other_row) -
+                   static_cast<ptrdiff_t>(row);
+    for (ptrdiff_t dx = -static_cast<ptrdiff_t>(radius);
+         dx <= static_cast<ptrdiff_t>(radius); dx++) {
+      size_t begin = (dx < 0) ? static_cast<size_t>(-dx) : 0;
+      size_t end = (dx > 0) ? num_columns - std::min(num_columns,
+                                                     static_cast<size_t>(dx))
+                            : num_columns;
+      if (end <= begin) {
+        continue;
+      }
+
+      // The offsets of the first pixel of the row and of its neighbor at
+      // this offset that are both within the image.
+      size_t center = row * num_columns + begin;
+      size_t other = other_row * num_columns + begin + dx;
+      size_t count = end - begin;
+
+      float spatial = static_cast<float>(dx * dx + dy * dy) * spatial_scale;
+      float* distance = distances.data() + begin;
+      for (size_t x = 0; x < count; x++) {
+        distance[x] = spatial;
+      }
+
+      for (size_t c = 0; c < 3; c++) {
+        const float* center_guide = image.guide[c].data() + center;
+        const float* other_guide = image.guide[c].data() + other;
+        const float* center_albedo = image.albedo[c].data() + center;
+        const float* other_albedo = image.albedo[c].data() + other;
+        const float* center_normal = image.normal[c].data() + center;
+        const float* other_normal = image.normal[c].data() + other;
+        for (size_t x = 0; x < count; x++) {
+          float albedo = center_albedo[x] - other_albedo[x];
+          float normal = center_normal[x] - other_normal[x];
+          distance[x] +=
+              RelativeDistance(center_guide[x], other_guide[x]) *
+                  lighting_scale +
+              albedo * albedo * albedo_scale + normal * normal * normal_scale;
+        }
+      }
+
+      if (!image.depth.empty()) {
+        const float* center_depth = image.depth.data() + center;
+        const float* other_depth = image.depth.data() + other;
+        for (size_t x = 0; x < count; x++) {
+          distance[x] +=
+              RelativeDistance(center_depth[x], other_depth[x]) * depth_scale;
+        }
+      }
+
+      float* weight = weights.data() + begin;
+      for (size_t x = 0; x < count; x++) {
+        distance[x] = std::exp(-distance[x]);
+        weight[x] += distance[x];
+      }
+
+      for (size_t c = 0; c < 3; c++) {
+        const float* other_lighting = image.lighting[c].data() + other;
+        float* sum = sums[c].data() + begin;
+        for (size_t x = 0; x < count; x++) {
+          sum[x] += distance[x] * other_lighting[x];
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+void Denoise(const std::vector<AovBuffer>& features, size_t radius,
+             size_t num_threads, Framebuffer& framebuffer) {
+  assert(num_threads != 0);
+
+  Image image;
+  FramebufferGetSize(framebuffer.get(), &image.num_columns, &image.num_rows);
+  size_t num_pixels = image.num_columns * image.num_rows;
+
+  const AovBuffer* albedo = FindFeature(features, Aov::ALBEDO);
+  const AovBuffer* normal = FindFeature(features, Aov::NORMAL);
+  const AovBuffer* depth = FindFeature(features, Aov::DEPTH);
+  assert(albedo && albedo->num_columns == image.num_columns &&
+         albedo->num_rows == image.num_rows);
+  assert(normal && normal->num_columns == image.num_columns &&
+         normal->num_rows == image.num_rows);
+
+  Deinterleave(*albedo, image.albedo);
+  Deinterleave(*normal, image.normal);
+  if (depth) {
+    assert(depth->num_columns == image.num_columns &&
+           depth->num_rows == image.num_rows);
+    Deinterleave(*depth, &image.depth);
+  }
+
+  // Non-finite pixels would spread to every pixel that they are averaged
+  // into, so they are filtered as if they were black.
+  for (size_t c = 0; c < 3; c++) {
+    image.lighting[c].resize(num_pixels);
+  }
+
+  for (size_t row = 0; row < image.num_rows; row++) {
+    for (size_t column = 0; column < image.num_columns; column++) {
+      COLOR3 color;
+      ISTATUS status =
+          FramebufferGetPixel(framebuffer.get(), column, row, &color);
+      assert(status == ISTATUS_SUCCESS);
+      color = ColorConvert(color, COLOR_SPACE_LINEAR_SRGB);
+
+      size_t index = row * image.num_columns + column;
+      for (size_t c = 0; c < 3; c++) {
+        float value = static_cast<float>(color.values[c]);
+        if (!std::isfinite(value)) {
+          value = 0.0f;
+        }
+
+        if (image.albedo[c][index] < kMinAlbedo) {
+          image.albedo[c][index] = 1.0f;
+        }
+
+        image.lighting[c][index] = value / image.albedo[c][index];
+      }
+    }
+  }
+
+  Prefilter(image);
+
+  std::atomic<size_t> next_row(0);
+  auto filter_rows = [&]() {
+    std::vector<float> distances(image.num_columns);
+    std::vector<float> weights(image.num_columns);
+    std::vector<float> sums[3] = {std::vector<float>(image.num_columns),
+                                  std::vector<float>(image.num_columns),
+                                  std::vector<float>(image.num_columns)};
+    for (size_t row = next_row++; row < image.num_rows; row = next_row++) {
+      FilterRow(image, row, radius, distances, weights, sums);
+
+      for (size_t column = 0; column < image.num_columns; column++) {
+        size_t index = row * image.num_columns + column;
+        COLOR3 color;
+        for (size_t c = 0; c < 3; c++) {
+          color.values[c] = static_cast<float_t>(
+              image.albedo[c][index] * sums[c][column] / weights[column]);
+        }
+        color.color_space = COLOR_SPACE_LINEAR_SRGB;
+
+        // Each pixel is written by exactly one thread and the features read
+        // by the other threads are kept separately.
+        ISTATUS status =
+            FramebufferSetPixel(framebuffer.get(), column, row, color);
+        assert(status == ISTATUS_SUCCESS);
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; i++) {
+    threads.emplace_back(filter_rows);
+  }
+
+  filter_rows();
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace iris
\ No newline at end of file
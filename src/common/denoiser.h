@@ -0,0 +1,29 @@
+#ifndef _SRC_COMMON_DENOISER_
+#define _SRC_COMMON_DENOISER_
+
+#include <cstddef>
+#include <vector>
+
+#include "src/common/aov.h"
+#include "src/common/pointer_types.h"
+
+namespace iris {
+
+// Removes noise from a rendered image with a joint cross bilateral filter.
+//
+// The lighting is separated from the surface colors by dividing the image by
+// the albedo AOV and each pixel is replaced by a weighted average of the
+// lighting of the pixels within radius of it, which is then multiplied by the
+// albedo again so that texture detail is kept sharp. The weights fall off
+// with distance in the image and with differences in a prefiltered copy of
+// the lighting and in the albedo, normal, and, if present, depth AOVs, so
+// that edges between surfaces are not blurred.
+//
+// The features must include the albedo and normal AOVs with the same size as
+// the framebuffer. Rows are filtered on num_threads threads.
+void Denoise(const std::vector<AovBuffer>& features, size_t radius,
+             size_t num_threads, Framebuffer& framebuffer);
+
+}  // namespace iris
+
+#endif  // _SRC_COMMON_DENOISER_
\ No newline at end of file
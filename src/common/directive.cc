@@ -80,9 +80,16 @@ bool ParseFiniteFloat(absl::string_view token, float_t* value) {
 }  // namespace
 
 Directive::Directive(absl::string_view base_type_name, Tokenizer& tokenizer)
-    : m_base_type_name(base_type_name), m_tokenizer(&tokenizer) {}
+    : m_base_type_name(base_type_name),
+      m_tokenizer(&tokenizer),
+      m_arena_position(ThreadArena().Mark()) {}
 
-Directive::~Directive() { assert(!m_tokenizer); }
+// Parameters parsed for this directive are released all at once here rather
+// than being freed one allocation at a time.
+Directive::~Directive() {
+  assert(!m_tokenizer);
+  ThreadArena().Rewind(m_arena_position);
+}
 
 size_t Directive::MatchType(absl::Span<const absl::string_view> type_names) {
   return ParseAndMatch(type_names, m_base_type_name, *m_tokenizer, "type");
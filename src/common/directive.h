@@ -7,6 +7,7 @@
 
 #include "absl/container/inlined_vector.h"
 #include "absl/types/span.h"
+#include "src/common/arena.h"
 #include "src/common/parameters.h"
 namespace iris {
 
@@ -118,6 +119,7 @@ class Directive {
   static constexpr size_t kMaxVariantsPerDirective = 20;
   absl::string_view m_base_type_name;
   Tokenizer* m_tokenizer;
+  Arena::Position m_arena_position;
 };
 
 }  // namespace iris
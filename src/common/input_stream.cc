@@ -0,0 +1,474 @@
+#include "src/common/input_stream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "zlib.h"
+#include "zstd.h"
+
+ABSL_FLAG(bool, report_input_throughput, false,
+          "If true, the number of bytes read and the throughput achieved for "
+          "each input file is reported once the file has been consumed, along "
+          "with how long the parser waited on I/O and how long I/O waited on "
+          "the parser.");
+
+namespace iris {
+namespace {
+
+static const size_t kChunkSize = 1u << 20;
+static const size_t kNumChunks = 4;
+static const size_t kReadSize = 1u << 16;
+
+static const unsigned char kGzipMagic[] = {0x1F, 0x8B};
+static const unsigned char kZstdMagic[] = {0x28, 0xB5, 0x2F, 0xFD};
+
+typedef std::chrono::steady_clock Clock;
+
+class RingBuffer {
+ public:
+  RingBuffer() : m_chunks(kNumChunks), m_sizes(kNumChunks) {
+    for (auto& chunk : m_chunks) {
+      chunk.resize(kChunkSize);
+    }
+  }
+
+  char* BeginWrite() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto start = Clock::now();
+    m_not_full.wait(lock,
+                    [this]() { return m_count < kNumChunks || m_cancelled; });
+    m_writer_waited += Clock::now() - start;
+    if (m_cancelled) {
+      return nullptr;
+    }
+    return m_chunks[(m_head + m_count) % kNumChunks].data();
+  }
+
+  void EndWrite(size_t size) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_sizes[(m_head + m_count) % kNumChunks] = size;
+    m_count += 1;
+    m_not_empty.notify_one();
+  }
+
+  void CloseWrite() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_closed = true;
+    m_not_empty.notify_one();
+  }
+
+  bool BeginRead(char** data, size_t* size) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto start = Clock::now();
+    m_not_empty.wait(lock, [this]() { return m_count != 0 || m_closed; });
+    m_reader_waited += Clock::now() - start;
+    if (m_count == 0) {
+      return false;
+    }
+    *data = m_chunks[m_head].data();
+    *size = m_sizes[m_head];
+    return true;
+  }
+
+  void EndRead() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_head = (m_head + 1) % kNumChunks;
+    m_count -= 1;
+    m_not_full.notify_one();
+  }
+
+  void Cancel() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cancelled = true;
+    m_not_full.notify_one();
+  }
+
+  Clock::duration ReaderWaited() const { return m_reader_waited; }
+  Clock::duration WriterWaited() const { return m_writer_waited; }
+
+ private:
+  std::vector<std::vector<char>> m_chunks;
+  std::vector<size_t> m_sizes;
+  size_t m_head = 0;
+  size_t m_count = 0;
+  bool m_closed = false;
+  bool m_cancelled = false;
+  Clock::duration m_reader_waited = Clock::duration::zero();
+  Clock::duration m_writer_waited = Clock::duration::zero();
+  std::mutex m_mutex;
+  std::condition_variable m_not_empty;
+  std::condition_variable m_not_full;
+};
+
+class Decoder {
+ public:
+  virtual ~Decoder() {}
+
+  // Consumes input and produces output, returning false on corrupt data.
+  // Either the input is exhausted or the output is full when this returns.
+  // Called with empty input to flush any output buffered by the decoder.
+  virtual bool Decode(const char** input, size_t* input_size, char** output,
+                      size_t* output_size) = 0;
+  virtual bool Finished() const = 0;
+};
+
+class CopyDecoder final : public Decoder {
+ public:
+  bool Decode(const char** input, size_t* input_size, char** output,
+              size_t* output_size) override {
+    size_t to_copy = std::min(*input_size, *output_size);
+    memcpy(*output, *input, to_copy);
+    *input += to_copy;
+    *input_size -= to_copy;
+    *output += to_copy;
+    *output_size -= to_copy;
+    return true;
+  }
+
+  bool Finished() const override { return true; }
+};
+
+class GzipDecoder final : public Decoder {
+ public:
+  GzipDecoder() : m_finished(false) {
+    memset(&m_stream, 0, sizeof(m_stream));
+    if (inflateInit2(&m_stream, 15 + 32) != Z_OK) {
+      std::cerr << "ERROR: Allocation failed" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  ~GzipDecoder() { inflateEnd(&m_stream); }
+
+  bool Decode(const char** input, size_t* input_size, char** output,
+              size_t* output_size) override {
+    while (*output_size != 0) {
+      if (m_finished) {
+        if (*input_size == 0) {
+          break;
+        }
+
+        // Concatenated gzip members are decoded as a single stream
+        if (inflateReset(&m_stream) != Z_OK) {
+          return false;
+        }
+        m_finished = false;
+      }
+
+      m_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(*input));
+      m_stream.avail_in =
+          static_cast<uInt>(std::min<size_t>(*input_size, UINT_MAX));
+      m_stream.next_out = reinterpret_cast<Bytef*>(*output);
+      m_stream.avail_out =
+          static_cast<uInt>(std::min<size_t>(*output_size, UINT_MAX));
+
+      // Without input, inflate may still flush output it has buffered.
+      // Z_BUF_ERROR means that no progress was possible.
+      uInt avail_in = m_stream.avail_in;
+      uInt avail_out = m_stream.avail_out;
+      int status = inflate(&m_stream, Z_NO_FLUSH);
+      if (status == Z_BUF_ERROR) {
+        break;
+      }
+      if (status != Z_OK && status != Z_STREAM_END) {
+        return false;
+      }
+
+      *input += avail_in - m_stream.avail_in;
+      *input_size -= avail_in - m_stream.avail_in;
+      *output += avail_out - m_stream.avail_out;
+      *output_size -= avail_out - m_stream.avail_out;
+      m_finished = (status == Z_STREAM_END);
+    }
+
+    return true;
+  }
+
+  bool Finished() const override { return m_finished; }
+
+ private:
+  z_stream m_stream;
+  bool m_finished;
+};
+
+class ZstdDecoder final : public Decoder {
+ public:
+  ZstdDecoder() : m_stream(ZSTD_createDStream()), m_finished(false) {
+    if (!m_stream || ZSTD_isError(ZSTD_initDStream(m_stream))) {
+      std::cerr << "ERROR: Allocation failed" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  ~ZstdDecoder() { ZSTD_freeDStream(m_stream); }
+
+  bool Decode(const char** input, size_t* input_size, char** output,
+              size_t* output_size) override {
+    ZSTD_inBuffer in = {*input, *input_size, 0};
+    ZSTD_outBuffer out = {*output, *output_size, 0};
+    do {
+      size_t in_pos = in.pos;
+      size_t out_pos = out.pos;
+      size_t status = ZSTD_decompressStream(m_stream, &out, &in);
+      if (ZSTD_isError(status)) {
+        return false;
+      }
+
+      // Once a frame is complete, a call without input reports the size of
+      // the next frame's header rather than zero
+      if (in.pos == in_pos && out.pos == out_pos) {
+        break;
+      }
+      m_finished = (status == 0);
+    } while (in.pos != in.size && out.pos != out.size);
+
+    *input += in.pos;
+    *input_size -= in.pos;
+    *output += out.pos;
+    *output_size -= out.pos;
+
+    return true;
+  }
+
+  bool Finished() const override { return m_finished; }
+
+ private:
+  ZSTD_DStream* m_stream;
+  bool m_finished;
+};
+
+std::unique_ptr<Decoder> CreateDecoder(const char* header, size_t size) {
+  if (sizeof(kGzipMagic) <= size &&
+      memcmp(header, kGzipMagic, sizeof(kGzipMagic)) == 0) {
+    return std::unique_ptr<Decoder>(new GzipDecoder());
+  }
+
+  if (sizeof(kZstdMagic) <= size &&
+      memcmp(header, kZstdMagic, sizeof(kZstdMagic)) == 0) {
+    return std::unique_ptr<Decoder>(new ZstdDecoder());
+  }
+
+  return std::unique_ptr<Decoder>(new CopyDecoder());
+}
+
+class BackgroundInputBuffer final : public std::streambuf {
+ public:
+  BackgroundInputBuffer(std::string path, FILE* file)
+      : m_path(std::move(path)),
+        m_file(file),
+        m_start(Clock::now()),
+        m_bytes_read(0),
+        m_bytes_decoded(0),
+        m_reading(false),
+        m_thread(&BackgroundInputBuffer::Run, this) {}
+
+  ~BackgroundInputBuffer() {
+    m_ring.Cancel();
+    m_thread.join();
+    fclose(m_file);
+
+    if (absl::GetFlag(FLAGS_report_input_throughput)) {
+      Report();
+    }
+  }
+
+ protected:
+  int_type underflow() override {
+    for (;;) {
+      if (m_reading) {
+        m_ring.EndRead();
+        m_reading = false;
+      }
+
+      char* data;
+      size_t size;
+      if (!m_ring.BeginRead(&data, &size)) {
+        return traits_type::eof();
+      }
+
+      m_reading = true;
+      if (size != 0) {
+        setg(data, data, data + size);
+        return traits_type::to_int_type(*data);
+      }
+    }
+  }
+
+ private:
+  void Run() {
+    std::vector<char> input(kReadSize);
+    const char* next_input = input.data();
+    size_t input_size = 0;
+    bool end_of_file = false;
+    std::unique_ptr<Decoder> decoder;
+
+    // Each chunk is filled until it is full or the input is exhausted. A read
+    // may decode to nothing, for instance a compressed block larger than the
+    // read or a trailer, so chunks are only published once they hold output.
+    for (;;) {
+      char* output = m_ring.BeginWrite();
+      if (!output) {
+        return;
+      }
+
+      char* next_output = output;
+      size_t output_size = kChunkSize;
+      while (output_size != 0) {
+        if (input_size == 0 && !end_of_file) {
+          input_size = fread(input.data(), 1, input.size(), m_file);
+          next_input = input.data();
+          m_bytes_read += input_size;
+          end_of_file = (input_size == 0);
+
+          if (!decoder && !end_of_file) {
+            decoder = CreateDecoder(input.data(), input_size);
+          }
+        }
+
+        if (!decoder) {
+          break;
+        }
+
+        // Once the input is exhausted this drains any output still buffered
+        // inside of the decoder
+        char* previous_output = next_output;
+        if (!decoder->Decode(&next_input, &input_size, &next_output,
+                             &output_size)) {
+          std::cerr << "ERROR: Failed to decompress file: " << m_path
+                    << std::endl;
+          exit(EXIT_FAILURE);
+        }
+
+        if (end_of_file && next_output == previous_output) {
+          break;
+        }
+      }
+
+      if (next_output == output) {
+        break;
+      }
+
+      m_bytes_decoded += next_output - output;
+      m_ring.EndWrite(next_output - output);
+    }
+
+    if (ferror(m_file)) {
+      std::cerr << "ERROR: Failed to read file: " << m_path << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+    if (decoder && !decoder->Finished()) {
+      std::cerr << "ERROR: Truncated compressed file: " << m_path
+                << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+    m_ring.CloseWrite();
+  }
+
+  void Report() const {
+    double elapsed =
+        std::chrono::duration<double>(Clock::now() - m_start).count();
+    double parser_waited =
+        std::chrono::duration<double>(m_ring.ReaderWaited()).count();
+    double reader_waited =
+        std::chrono::duration<double>(m_ring.WriterWaited()).count();
+    double megabytes_read = (double)m_bytes_read / (1024.0 * 1024.0);
+    double megabytes_decoded = (double)m_bytes_decoded / (1024.0 * 1024.0);
+
+    std::cerr << "Input " << m_path << ": " << megabytes_read << " MiB read ("
+              << megabytes_decoded << " MiB decoded) in " << elapsed
+              << "s, " << megabytes_read / elapsed << " MiB/s; parser waited "
+              << parser_waited << "s for input, reader waited "
+              << reader_waited << "s for parser" << std::endl;
+  }
+
+  std::string m_path;
+  FILE* m_file;
+  Clock::time_point m_start;
+  size_t m_bytes_read;
+  size_t m_bytes_decoded;
+  RingBuffer m_ring;
+  bool m_reading;
+  std::thread m_thread;
+};
+
+class BackgroundInputStream final : public std::istream {
+ public:
+  BackgroundInputStream(std::string path, FILE* file)
+      : std::istream(nullptr), m_buffer(std::move(path), file) {
+    rdbuf(&m_buffer);
+  }
+
+ private:
+  BackgroundInputBuffer m_buffer;
+};
+
+struct InputCookie {
+  std::unique_ptr<std::istream> stream;
+  off64_t position;
+};
+
+ssize_t ReadCookie(void* cookie, char* buffer, size_t size) {
+  auto* input = static_cast<InputCookie*>(cookie);
+  input->stream->read(buffer, size);
+  input->position += input->stream->gcount();
+  return input->stream->gcount();
+}
+
+// The stream cannot seek, but reporting its position lets ftell return the
+// number of bytes consumed.
+int SeekCookie(void* cookie, off64_t* offset, int whence) {
+  auto* input = static_cast<InputCookie*>(cookie);
+  if (whence != SEEK_CUR || *offset != 0) {
+    return -1;
+  }
+
+  *offset = input->position;
+  return 0;
+}
+
+int CloseCookie(void* cookie) {
+  delete static_cast<InputCookie*>(cookie);
+  return 0;
+}
+
+}  // namespace
+
+std::unique_ptr<std::istream> OpenInputStream(const std::string& path) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file) {
+    return nullptr;
+  }
+
+  return std::unique_ptr<std::istream>(new BackgroundInputStream(path, file));
+}
+
+FILE* OpenInputFile(const std::string& path) {
+  auto stream = OpenInputStream(path);
+  if (!stream) {
+    return nullptr;
+  }
+
+  std::unique_ptr<InputCookie> cookie(new InputCookie{std::move(stream), 0});
+  cookie_io_functions_t functions = {ReadCookie, nullptr, SeekCookie,
+                                     CloseCookie};
+  FILE* result = fopencookie(cookie.get(), "rb", functions);
+  if (!result) {
+    return nullptr;
+  }
+
+  cookie.release();
+
+  return result;
+}
+
+}  // namespace iris
\ No newline at end of file
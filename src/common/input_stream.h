@@ -0,0 +1,24 @@
+#ifndef _SRC_COMMON_INPUT_STREAM_
+#define _SRC_COMMON_INPUT_STREAM_
+
+#include <cstdio>
+#include <istream>
+#include <memory>
+#include <string>
+
+namespace iris {
+
+// Opens a file for reading. The file is read, and decompressed if it is gzip
+// or zstd compressed, on a background thread so that parsing overlaps I/O.
+// Returns nullptr if the file cannot be opened.
+std::unique_ptr<std::istream> OpenInputStream(const std::string& path);
+
+// Same as OpenInputStream, but returns a FILE* for use with C libraries. The
+// result must be closed with fclose. Returns nullptr if the file cannot be
+// opened. The result cannot seek, but ftell reports the number of bytes
+// read from it.
+FILE* OpenInputFile(const std::string& path);
+
+}  // namespace iris
+
+#endif  // _SRC_COMMON_INPUT_STREAM_
\ No newline at end of file
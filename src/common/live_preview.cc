@@ -0,0 +1,161 @@
+#include "src/common/live_preview.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+namespace iris {
+namespace {
+
+static const char kMagic[8] = "IRISPRV";
+static const uint32_t kVersion = 1;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t complete;
+  uint64_t num_columns;
+  uint64_t num_rows;
+  uint64_t float_offset;
+  uint64_t rgba8_offset;
+  std::atomic<uint64_t> sequence;
+};
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t) &&
+                  std::atomic<uint64_t>::is_always_lock_free,
+              "The sequence must be readable by other processes");
+
+uint8_t ToSrgb8(float value) {
+  if (!(0.0f < value)) {
+    return 0;
+  }
+
+  if (1.0f <= value) {
+    return 255;
+  }
+
+  float encoded = (value <= 0.0031308f)
+                      ? 12.92f * value
+                      : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+  return static_cast<uint8_t>(encoded * 255.0f + 0.5f);
+}
+
+}  // namespace
+
+LivePreview::LivePreview(const std::string& path, size_t num_columns,
+                         size_t num_rows,
+                         std::chrono::steady_clock::duration interval)
+    : m_num_columns(num_columns),
+      m_num_rows(num_rows),
+      m_interval(interval),
+      m_last_update() {
+  size_t num_pixels = num_columns * num_rows;
+  size_t float_offset = sizeof(Header);
+  size_t rgba8_offset = float_offset + num_pixels * 3 * sizeof(float);
+  m_mapping_size = rgba8_offset + num_pixels * 4;
+
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    std::cerr << "ERROR: Failed to open preview file: " << path << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  if (ftruncate(fd, static_cast<off_t>(m_mapping_size)) != 0) {
+    std::cerr << "ERROR: Failed to resize preview file: " << path
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  m_mapping = mmap(nullptr, m_mapping_size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (m_mapping == MAP_FAILED) {
+    std::cerr << "ERROR: Failed to map preview file: " << path << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // The file was truncated, so the pixels are already zero.
+  Header* header = new (m_mapping) Header;
+  std::memcpy(header->magic, kMagic, sizeof(kMagic));
+  header->version = kVersion;
+  header->complete = 0;
+  header->num_columns = num_columns;
+  header->num_rows = num_rows;
+  header->float_offset = float_offset;
+  header->rgba8_offset = rgba8_offset;
+  header->sequence.store(0, std::memory_order_release);
+}
+
+LivePreview::~LivePreview() { munmap(m_mapping, m_mapping_size); }
+
+std::atomic<uint64_t>& LivePreview::Sequence() {
+  return static_cast<Header*>(m_mapping)->sequence;
+}
+
+void LivePreview::BeginUpdate() {
+  auto& sequence = Sequence();
+  sequence.store(sequence.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+void LivePreview::EndUpdate() {
+  auto& sequence = Sequence();
+  sequence.store(sequence.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_release);
+  m_last_update = std::chrono::steady_clock::now();
+}
+
+bool LivePreview::Due() const {
+  return m_last_update + m_interval <= std::chrono::steady_clock::now();
+}
+
+void LivePreview::Publish(const PixelBounds& bounds,
+                          const GetColor& get_color, bool force) {
+  assert(bounds.max_column <= m_num_columns && bounds.max_row <= m_num_rows);
+
+  if (!force && !Due()) {
+    return;
+  }
+
+  Header* header = static_cast<Header*>(m_mapping);
+  float* floats = reinterpret_cast<float*>(static_cast<char*>(m_mapping) +
+                                           header->float_offset);
+  uint8_t* rgba8 = static_cast<uint8_t*>(m_mapping) + header->rgba8_offset;
+
+  BeginUpdate();
+
+  for (size_t row = bounds.min_row; row < bounds.max_row; row++) {
+    for (size_t column = bounds.min_column; column < bounds.max_column;
+         column++) {
+      COLOR3 color =
+          ColorConvert(get_color(column, row), COLOR_SPACE_LINEAR_SRGB);
+
+      size_t pixel = row * m_num_columns + column;
+      for (size_t c = 0; c < 3; c++) {
+        float value = static_cast<float>(color.values[c]);
+        floats[3 * pixel + c] = value;
+        rgba8[4 * pixel + c] = ToSrgb8(value);
+      }
+      rgba8[4 * pixel + 3] = 255;
+    }
+  }
+
+  EndUpdate();
+}
+
+void LivePreview::Finish() {
+  BeginUpdate();
+  static_cast<Header*>(m_mapping)->complete = 1;
+  EndUpdate();
+}
+
+}  // namespace iris
\ No newline at end of file
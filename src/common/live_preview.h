@@ -0,0 +1,78 @@
+#ifndef _SRC_COMMON_LIVE_PREVIEW_
+#define _SRC_COMMON_LIVE_PREVIEW_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "iris_camera/iris_camera.h"
+#include "src/common/pixel_bounds.h"
+
+namespace iris {
+
+// Publishes the image of a render in progress to a memory mapped file that
+// viewers can map and display without copying it. Placing the file on a
+// tmpfs such as /dev/shm makes it a shared memory segment.
+//
+// The file is in native byte order and begins with this header, where the
+// offsets are from the start of the file:
+//
+//   char magic[8];          // "IRISPRV" followed by a zero byte
+//   uint32_t version;       // 1
+//   uint32_t complete;      // Non-zero once the render has finished
+//   uint64_t num_columns;
+//   uint64_t num_rows;
+//   uint64_t float_offset;  // Linear sRGB as 3 floats per pixel
+//   uint64_t rgba8_offset;  // sRGB clamped to 8 bits, 4 bytes per pixel
+//   uint64_t sequence;      // Incremented before and after each update
+//
+// Pixels are in row major order with the top row first. The sequence is a
+// sequence lock: it is odd while pixels are being written and even otherwise,
+// and zero before the first update. A reader that loads the same even value
+// before and after copying the pixels has a consistent image.
+//
+// Updates are made by a single thread. Pixels that have not been published
+// are zero, including their 8 bit alpha, which is opaque once they are.
+class LivePreview {
+ public:
+  typedef std::function<COLOR3(size_t column, size_t row)> GetColor;
+
+  // Creates or replaces the file at path. Updates requested less than
+  // interval after the previous one are skipped unless they are forced.
+  LivePreview(const std::string& path, size_t num_columns, size_t num_rows,
+              std::chrono::steady_clock::duration interval);
+  ~LivePreview();
+
+  LivePreview(const LivePreview&) = delete;
+  LivePreview& operator=(const LivePreview&) = delete;
+
+  // Returns true if an update would not be skipped.
+  bool Due() const;
+
+  // Replaces the pixels within bounds with the colors returned by get_color,
+  // which is called with the column and row of each pixel in the image.
+  void Publish(const PixelBounds& bounds, const GetColor& get_color,
+               bool force = false);
+
+  // Marks the image as complete.
+  void Finish();
+
+ private:
+  std::atomic<uint64_t>& Sequence();
+  void BeginUpdate();
+  void EndUpdate();
+
+  size_t m_num_columns;
+  size_t m_num_rows;
+  std::chrono::steady_clock::duration m_interval;
+  std::chrono::steady_clock::time_point m_last_update;
+  void* m_mapping;
+  size_t m_mapping_size;
+};
+
+}  // namespace iris
+
+#endif  // _SRC_COMMON_LIVE_PREVIEW_
\ No newline at end of file
@@ -10,6 +10,8 @@ namespace iris {
 
 const Material& MaterialManager::AllocateAlphaMaterial(
     const Material& material, const FloatTexture& alpha) {
+  std::lock_guard<std::mutex> lock(*m_mutex);
+
   Material& result = m_alpha_materials[std::make_pair(material, alpha)];
   if (!result.get()) {
     ISTATUS status = AlphaMaterialAllocate(material.get(), alpha.get(),
@@ -22,6 +24,8 @@ const Material& MaterialManager::AllocateAlphaMaterial(
 
 const Material& MaterialManager::AllocateMatteMaterial(
     const ReflectorTexture& kd, const FloatTexture& sigma) {
+  std::lock_guard<std::mutex> lock(*m_mutex);
+
   Material& result = m_matte_materials[std::make_pair(kd, sigma)];
   if (!result.get()) {
     ISTATUS status = MatteMaterialAllocate(kd.get(), sigma.get(),
@@ -34,6 +38,8 @@ const Material& MaterialManager::AllocateMatteMaterial(
 
 const Material& MaterialManager::AllocateMirrorMaterial(
     const ReflectorTexture& kr) {
+  std::lock_guard<std::mutex> lock(*m_mutex);
+
   Material& result = m_mirror_materials[kr];
   if (!result.get()) {
     ISTATUS status =
@@ -47,6 +53,8 @@ const Material& MaterialManager::AllocateMirrorMaterial(
 const Material& MaterialManager::AllocatePlasticMaterial(
     const ReflectorTexture& kd, const ReflectorTexture& ks,
     const FloatTexture& roughness, bool remap_roughness) {
+  std::lock_guard<std::mutex> lock(*m_mutex);
+
   Material& result =
       m_plastic_materials[std::make_tuple(kd, ks, roughness, remap_roughness)];
   if (!result.get()) {
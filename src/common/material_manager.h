@@ -2,14 +2,19 @@
 #define _SRC_COMMON_MATERIAL_MANAGER_
 
 #include <map>
+#include <memory>
+#include <mutex>
 #include <tuple>
 
 #include "src/common/pointer_types.h"
 
 namespace iris {
 
+// Synchronized so that parallel includes can share a single cache
 class MaterialManager {
  public:
+  MaterialManager() : m_mutex(new std::mutex) {}
+
   const Material& AllocateAlphaMaterial(const Material& material,
                                         const FloatTexture& alpha);
   const Material& AllocateMatteMaterial(const ReflectorTexture& kd,
@@ -21,6 +26,8 @@ class MaterialManager {
                                           bool remap_roughness);
 
  private:
+  std::unique_ptr<std::mutex> m_mutex;
+
   std::map<std::pair<Material, FloatTexture>, Material> m_alpha_materials;
   std::map<std::pair<ReflectorTexture, FloatTexture>, Material>
       m_matte_materials;
@@ -12,6 +12,8 @@ static const NormalMap kEmptyNormalMap;
 
 const NormalMap& NormalMapManager::AllocateBumpMap(
     const FloatTexture& texture) {
+  std::lock_guard<std::mutex> lock(*m_mutex);
+
   if (!texture.get()) {
     return kEmptyNormalMap;
   }
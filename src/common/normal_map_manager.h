@@ -2,16 +2,23 @@
 #define _SRC_COMMON_NORMAL_MAP_MANAGER_
 
 #include <map>
+#include <memory>
+#include <mutex>
 
 #include "src/common/pointer_types.h"
 
 namespace iris {
 
+// Synchronized so that parallel includes can share a single cache
 class NormalMapManager {
  public:
+  NormalMapManager() : m_mutex(new std::mutex) {}
+
   const NormalMap& AllocateBumpMap(const FloatTexture& texture);
 
  private:
+  std::unique_ptr<std::mutex> m_mutex;
+
   std::map<FloatTexture, NormalMap> m_bump_maps;
 };
 
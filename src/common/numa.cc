@@ -0,0 +1,99 @@
+#include "src/common/numa.h"
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace iris {
+namespace {
+
+thread_local size_t current_numa_node = 0;
+
+// Parses a sysfs CPU list such as "0-15,32-47".
+std::vector<int> ParseCpuList(const std::string& cpu_list) {
+  std::vector<int> result;
+
+  std::stringstream stream(cpu_list);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    size_t dash = range.find('-');
+    int first = std::stoi(range.substr(0, dash));
+    int last = (dash == std::string::npos) ? first
+                                           : std::stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last; cpu++) {
+      result.push_back(cpu);
+    }
+  }
+
+  return result;
+}
+
+// Nodes without CPUs, such as those holding only memory, are skipped.
+std::vector<std::vector<int>> ReadNumaNodes() {
+  std::vector<std::vector<int>> result;
+
+  for (size_t node = 0;; node++) {
+    std::ifstream file("/sys/devices/system/node/node" +
+                       std::to_string(node) + "/cpulist");
+    if (!file) {
+      break;
+    }
+
+    std::string cpu_list;
+    std::getline(file, cpu_list);
+    if (cpu_list.empty()) {
+      continue;
+    }
+
+    result.push_back(ParseCpuList(cpu_list));
+  }
+
+  return result;
+}
+
+const std::vector<std::vector<int>>& NumaNodes() {
+  static const std::vector<std::vector<int>> nodes = ReadNumaNodes();
+  return nodes;
+}
+
+}  // namespace
+
+size_t NumNumaNodes() { return std::max(NumaNodes().size(), size_t(1)); }
+
+void PinThreadToNumaNode(size_t node) {
+  assert(node < NumNumaNodes());
+  current_numa_node = node;
+
+#if defined(__linux__)
+  if (NumaNodes().empty()) {
+    return;
+  }
+
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  for (int cpu : NumaNodes()[node]) {
+    CPU_SET(cpu, &cpus);
+  }
+
+  if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+    static std::once_flag warned;
+    std::call_once(warned, []() {
+      std::cerr << "WARNING: Could not pin threads to NUMA nodes"
+                << std::endl;
+    });
+  }
+#endif
+}
+
+size_t CurrentNumaNode() { return current_numa_node; }
+
+}  // namespace iris
\ No newline at end of file
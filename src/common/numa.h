@@ -0,0 +1,23 @@
+#ifndef _SRC_COMMON_NUMA_
+#define _SRC_COMMON_NUMA_
+
+#include <cstddef>
+
+namespace iris {
+
+// Returns the number of NUMA nodes with CPUs on the machine. Returns one if
+// the topology cannot be determined.
+size_t NumNumaNodes();
+
+// Restricts the calling thread to the CPUs of a NUMA node, so that memory it
+// first touches afterwards is allocated on that node, and records the node
+// for CurrentNumaNode.
+void PinThreadToNumaNode(size_t node);
+
+// Returns the node the calling thread was last pinned to, or zero if it has
+// not been pinned.
+size_t CurrentNumaNode();
+
+}  // namespace iris
+
+#endif  // _SRC_COMMON_NUMA_
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "src/common/parameter.h"
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+
+#include "absl/container/flat_hash_map.h"
+
+namespace iris {
+namespace {
+
+class ParameterNameTable {
+ public:
+  ParameterNameId Intern(absl::string_view name) {
+    {
+      std::shared_lock<std::shared_mutex> lock(m_mutex);
+
+      auto iter = m_ids.find(name);
+      if (iter != m_ids.end()) {
+        return iter->second;
+      }
+    }
+
+    std::lock_guard<std::shared_mutex> lock(m_mutex);
+
+    auto iter = m_ids.find(name);
+    if (iter != m_ids.end()) {
+      return iter->second;
+    }
+
+    ParameterNameId id = static_cast<ParameterNameId>(m_names.size());
+    m_names.emplace_back(name);
+    m_ids.emplace(m_names.back(), id);
+
+    return id;
+  }
+
+  absl::string_view Name(ParameterNameId id) {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+
+    return m_names[id];
+  }
+
+ private:
+  std::shared_mutex m_mutex;
+  std::deque<std::string> m_names;
+  absl::flat_hash_map<absl::string_view, ParameterNameId> m_ids;
+};
+
+ParameterNameTable& GetParameterNameTable() {
+  static ParameterNameTable* table = new ParameterNameTable();
+  return *table;
+}
+
+static const size_t kCachedNameBits = 8;
+
+struct CachedName {
+  absl::string_view interned;
+  ParameterNameId id;
+};
+
+}  // namespace
+
+// Matchers are constructed for every directive, nearly always from the same
+// string literals, so each thread remembers the names it interned most
+// recently by their address and only takes the table's lock on a miss. A hit
+// compares the contents against the interned copy, so a name that is not a
+// literal can never return a stale id.
+ParameterNameId InternParameterName(absl::string_view name) {
+  thread_local CachedName cache[1u << kCachedNameBits];
+
+  uint64_t address = reinterpret_cast<uintptr_t>(name.data());
+  size_t slot = (address * 0x9E3779B97F4A7C15u) >> (64 - kCachedNameBits);
+  CachedName& entry = cache[slot];
+  if (entry.interned.data() != nullptr && entry.interned == name) {
+    return entry.id;
+  }
+
+  ParameterNameTable& table = GetParameterNameTable();
+  ParameterNameId id = table.Intern(name);
+  entry.interned = table.Name(id);
+  entry.id = id;
+
+  return id;
+}
+
+absl::string_view ParameterName(ParameterNameId id) {
+  return GetParameterNameTable().Name(id);
+}
+
+}  // namespace iris
\ No newline at end of file
@@ -1,26 +1,33 @@
 #ifndef _SRC_COMMON_PARAMETER_
 #define _SRC_COMMON_PARAMETER_
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 #include "absl/types/variant.h"
 #include "iris_camera/iris_camera.h"
+#include "src/common/arena.h"
 
 namespace iris {
 
+// Parameter values are allocated from the parsing thread's arena and are only
+// valid until the directive that parsed them has been consumed. Matchers that
+// keep an array for longer than that must Steal it.
 struct BoolParameter {
-  std::vector<bool> data;
+  ArenaVector<bool> data;
 };
 
 struct IntParameter {
-  std::vector<int> data;
+  ArenaVector<int> data;
 };
 
 struct FloatParameter {
-  std::vector<float_t> data;
+  ArenaVector<float_t> data;
 };
 
 struct SpectrumParameter {
@@ -30,32 +37,32 @@ struct SpectrumParameter {
 };
 
 struct Point3Parameter {
-  std::vector<POINT3> data;
+  ArenaVector<POINT3> data;
 };
 
 struct Vector3Parameter {
-  std::vector<VECTOR3> data;
+  ArenaVector<VECTOR3> data;
 };
 
 struct NormalParameter {
-  std::vector<VECTOR3> data;
+  ArenaVector<VECTOR3> data;
 };
 
 struct ColorParameter {
-  std::vector<COLOR3> data;
+  ArenaVector<COLOR3> data;
 };
 
 struct StringParameter {
-  std::vector<std::string> data;
-  std::vector<std::string> resolved;
+  ArenaVector<std::string> data;
+  ArenaVector<std::string> resolved;
 };
 
 struct TextureParameter {
-  std::vector<std::string> data;
+  ArenaVector<std::string> data;
 };
 
 struct UnspacedColorParameter {
-  std::vector<std::array<float_t, 3>> data;
+  ArenaVector<std::array<float_t, 3>> data;
 };
 
 typedef absl::variant<BoolParameter, IntParameter, FloatParameter,
@@ -64,7 +71,24 @@ typedef absl::variant<BoolParameter, IntParameter, FloatParameter,
                       TextureParameter, UnspacedColorParameter>
     ParameterData;
 
-typedef std::pair<std::string, ParameterData> Parameter;
+// Parameter names are interned into a dense table when a parameter is parsed
+// or a matcher is constructed, so that finding the matcher for a parameter
+// compares integers rather than strings. Two names have the same id if and
+// only if they are equal, and ids are never reused. Every distinct name that
+// is parsed is interned, including names that no matcher recognizes, and
+// names are never removed from the table.
+typedef uint32_t ParameterNameId;
+
+ParameterNameId InternParameterName(absl::string_view name);
+
+// The returned view is valid for the lifetime of the process.
+absl::string_view ParameterName(ParameterNameId id);
+
+struct Parameter {
+  absl::string_view name;
+  ParameterNameId name_id;
+  ParameterData data;
+};
 
 }  // namespace iris
 
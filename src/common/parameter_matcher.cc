@@ -21,6 +21,7 @@ ParameterMatcher::ParameterMatcher(absl::string_view parameter_name,
                                    bool required,
                                    absl::Span<const size_t> variant_indices)
     : m_parameter_name(parameter_name),
+      m_parameter_name_id(InternParameterName(parameter_name)),
       m_variant_indices(variant_indices),
       m_required(required),
       m_found(false) {}
@@ -28,7 +29,7 @@ ParameterMatcher::ParameterMatcher(absl::string_view parameter_name,
 bool ParameterMatcher::Match(absl::string_view base_type_name,
                              absl::optional<absl::string_view> type_name,
                              Parameter& parameter) {
-  if (parameter.first != m_parameter_name) {
+  if (parameter.name_id != m_parameter_name_id) {
     return false;
   }
 
@@ -36,7 +37,7 @@ bool ParameterMatcher::Match(absl::string_view base_type_name,
   m_type_name = type_name;
 
   for (size_t i = 0; i < m_variant_indices.size(); i++) {
-    if (parameter.second.index() != m_variant_indices[i]) {
+    if (parameter.data.index() != m_variant_indices[i]) {
       continue;
     }
 
@@ -47,7 +48,7 @@ bool ParameterMatcher::Match(absl::string_view base_type_name,
       exit(EXIT_FAILURE);
     }
 
-    Match(parameter.second);
+    Match(parameter.data);
     m_found = true;
 
     return true;
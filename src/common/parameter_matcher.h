@@ -27,6 +27,7 @@ class ParameterMatcher {
 
  private:
   absl::string_view m_parameter_name;
+  ParameterNameId m_parameter_name_id;
   absl::string_view m_base_type_name;
   absl::optional<absl::string_view> m_type_name;
   absl::Span<const size_t> m_variant_indices;
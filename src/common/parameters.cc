@@ -4,6 +4,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
@@ -32,9 +33,14 @@ static bool ParseQuotedTokenToBool(absl::string_view token, bool* result) {
   return false;
 }
 
+template <typename Type>
+ArenaVector<Type> MakeArenaVector() {
+  return ArenaVector<Type>(ArenaAllocator<Type>(ThreadArena()));
+}
+
 template <typename Type, bool (*ParseFunc)(absl::string_view, Type*)>
 void ParseSingle(absl::string_view token, absl::string_view lower_type_name,
-                 std::vector<Type>* result) {
+                 ArenaVector<Type>* result) {
   Type value;
   bool success = ParseFunc(token, &value);
 
@@ -49,7 +55,7 @@ void ParseSingle(absl::string_view token, absl::string_view lower_type_name,
 
 template <typename Type, bool (*ParseFunc)(absl::string_view, Type*)>
 void ParseLoop(Tokenizer& tokenizer, absl::string_view type_name,
-               absl::string_view lower_type_name, std::vector<Type>* result) {
+               absl::string_view lower_type_name, ArenaVector<Type>* result) {
   for (;;) {
     auto token = tokenizer.Next();
 
@@ -68,11 +74,11 @@ void ParseLoop(Tokenizer& tokenizer, absl::string_view type_name,
 }
 
 template <typename Type, bool (*ParseFunc)(absl::string_view, Type*)>
-std::vector<Type> ParseData(Tokenizer& tokenizer, absl::string_view type_name,
+ArenaVector<Type> ParseData(Tokenizer& tokenizer, absl::string_view type_name,
                             absl::string_view lower_type_name) {
   auto token = *tokenizer.Next();
 
-  std::vector<Type> result;
+  auto result = MakeArenaVector<Type>();
   if (token != "[") {
     ParseSingle<Type, ParseFunc>(token, lower_type_name, &result);
   } else {
@@ -82,12 +88,33 @@ std::vector<Type> ParseData(Tokenizer& tokenizer, absl::string_view type_name,
   return result;
 }
 
+static ArenaVector<float_t> ParseFloatData(Tokenizer& tokenizer,
+                                           absl::string_view type_name,
+                                           absl::string_view lower_type_name) {
+  auto values = tokenizer.NextFloats();
+  if (values) {
+    auto result = MakeArenaVector<float_t>();
+    result.assign(values->begin(), values->end());
+    return result;
+  }
+
+  return ParseData<float_t, absl::SimpleAtof>(tokenizer, type_name,
+                                              lower_type_name);
+}
+
 static FloatParameter ParseFloat(Tokenizer& tokenizer) {
-  auto data = ParseData<float_t, absl::SimpleAtof>(tokenizer, "Float", "float");
+  auto data = ParseFloatData(tokenizer, "Float", "float");
   return FloatParameter{std::move(data)};
 }
 
 static IntParameter ParseInt(Tokenizer& tokenizer) {
+  auto values = tokenizer.NextInts();
+  if (values) {
+    auto data = MakeArenaVector<int>();
+    data.assign(values->begin(), values->end());
+    return IntParameter{std::move(data)};
+  }
+
   auto data = ParseData<int, absl::SimpleAtoi>(tokenizer, "Int", "int");
   return IntParameter{std::move(data)};
 }
@@ -100,18 +127,18 @@ static BoolParameter ParseBool(Tokenizer& tokenizer) {
 
 template <typename Type, Type (*Create)(float_t x, float_t y, float_t z),
           bool (*Validate)(Type)>
-static std::vector<Type> ParseFloatTuple(Tokenizer& tokenizer,
+static ArenaVector<Type> ParseFloatTuple(Tokenizer& tokenizer,
                                          absl::string_view type_name,
                                          absl::string_view lower_type_name) {
-  auto data = ParseData<float_t, absl::SimpleAtof>(tokenizer, type_name,
-                                                   lower_type_name);
+  auto data = ParseFloatData(tokenizer, type_name, lower_type_name);
   if (data.size() % 3 != 0) {
     std::cerr << "ERROR: The number of parameters for " << lower_type_name
               << " must be divisible by 3" << std::endl;
     exit(EXIT_FAILURE);
   }
 
-  std::vector<Type> result;
+  auto result = MakeArenaVector<Type>();
+  result.reserve(data.size() / 3);
   for (size_t i = 0; i < data.size(); i += 3) {
     auto value = Create(data[i], data[i + 1], data[i + 2]);
     if (!Validate(value)) {
@@ -182,7 +209,8 @@ static UnspacedColorParameter ParseRgb(Tokenizer& tokenizer) {
 static StringParameter ParseString(Tokenizer& tokenizer) {
   auto data = ParseData<std::string, ParseQuotedTokenToString>(
       tokenizer, "String", "string");
-  std::vector<std::string> resolved;
+  auto resolved = MakeArenaVector<std::string>();
+  resolved.reserve(data.size());
   for (const auto& entry : data) {
     resolved.push_back(tokenizer.ResolvePath(entry));
   }
@@ -207,9 +235,9 @@ static ColorParameter ParseXyz(Tokenizer& tokenizer) {
 }
 
 static std::vector<std::pair<std::string, std::string>> ParseSpectrumFilenames(
-    const std::vector<std::string>& quoted_filenames,
+    const ArenaVector<std::string>& quoted_filenames,
     const Tokenizer& tokenizer) {
-  std::vector<std::string> parsed_filenames;
+  auto parsed_filenames = MakeArenaVector<std::string>();
   for (const auto& filename : quoted_filenames) {
     ParseSingle<std::string, ParseQuotedTokenToString>(filename, "spectrum",
                                                        &parsed_filenames);
@@ -222,16 +250,18 @@ static std::vector<std::pair<std::string, std::string>> ParseSpectrumFilenames(
 }
 
 static std::pair<std::vector<std::string>, std::vector<float_t>>
-ParseSpectrumSamples(const std::vector<std::string>& samples) {
-  std::vector<float_t> result;
+ParseSpectrumSamples(const ArenaVector<std::string>& samples) {
+  auto result = MakeArenaVector<float_t>();
   for (const auto& sample : samples) {
     ParseSingle<float_t, absl::SimpleAtof>(sample, "spectrum", &result);
   }
-  return std::make_pair(samples, std::move(result));
+  return std::make_pair(
+      std::vector<std::string>(samples.begin(), samples.end()),
+      std::vector<float_t>(result.begin(), result.end()));
 }
 
 static SpectrumParameter ParseSpectrum(Tokenizer& tokenizer) {
-  std::vector<std::string> unknown_data =
+  ArenaVector<std::string> unknown_data =
       ParseData<std::string, ParseStringWithoutValidation>(
           tokenizer, "Spectrum", "spectrum");
   if (unknown_data.empty() || unknown_data[0][0] == '"') {
@@ -268,13 +298,28 @@ static const std::map<absl::string_view, ParserCallback> kParsers = {
     {"xyz", ToCallback<ColorParameter>(ParseXyz)},
 };
 
-absl::optional<Parameter> ParseNextParam(Tokenizer& tokenizer) {
-  auto quoted_token = tokenizer.Peek();
-  if (!quoted_token) {
-    return absl::nullopt;
+struct ParameterDeclaration {
+  const ParserCallback* parser;
+  absl::string_view name;
+  ParameterNameId name_id;
+};
+
+// Scenes only use a handful of distinct declarations, so the cache is simply
+// emptied if a pathological input fills it.
+static const size_t kMaxCachedDeclarations = 1024;
+
+// Returns nullopt if the token is not quoted. Declarations are cached per
+// thread so that each distinct declaration is only split and validated once.
+absl::optional<ParameterDeclaration> LookupDeclaration(
+    absl::string_view quoted_token) {
+  thread_local absl::flat_hash_map<std::string, ParameterDeclaration> cache;
+
+  auto iter = cache.find(quoted_token);
+  if (iter != cache.end()) {
+    return iter->second;
   }
 
-  auto unquoted_token = UnquoteToken(*quoted_token);
+  auto unquoted_token = UnquoteToken(quoted_token);
   if (!unquoted_token) {
     return absl::nullopt;
   }
@@ -284,7 +329,7 @@ absl::optional<Parameter> ParseNextParam(Tokenizer& tokenizer) {
 
   if (type_and_name.size() != 2) {
     std::cerr << "ERROR: Failed to parse parameter type and name: "
-              << *quoted_token << std::endl;
+              << quoted_token << std::endl;
     exit(EXIT_FAILURE);
   }
 
@@ -295,7 +340,29 @@ absl::optional<Parameter> ParseNextParam(Tokenizer& tokenizer) {
     exit(EXIT_FAILURE);
   }
 
-  std::string name(type_and_name[1].data(), type_and_name[1].size());
+  ParameterNameId name_id = InternParameterName(type_and_name[1]);
+  ParameterDeclaration declaration = {&parser->second,
+                                      ParameterName(name_id), name_id};
+
+  if (cache.size() == kMaxCachedDeclarations) {
+    cache.clear();
+  }
+
+  cache.emplace(quoted_token, declaration);
+
+  return declaration;
+}
+
+absl::optional<Parameter> ParseNextParam(Tokenizer& tokenizer) {
+  auto quoted_token = tokenizer.Peek();
+  if (!quoted_token) {
+    return absl::nullopt;
+  }
+
+  auto declaration = LookupDeclaration(*quoted_token);
+  if (!declaration) {
+    return absl::nullopt;
+  }
 
   quoted_token = tokenizer.Next();
   if (!tokenizer.Peek()) {
@@ -304,7 +371,8 @@ absl::optional<Parameter> ParseNextParam(Tokenizer& tokenizer) {
     exit(EXIT_FAILURE);
   }
 
-  return Parameter(std::move(name), parser->second(tokenizer));
+  return Parameter{declaration->name, declaration->name_id,
+                   (*declaration->parser)(tokenizer)};
 }
 
 std::string ErrorTypeName(absl::string_view base_type_name,
@@ -319,7 +387,7 @@ void MatchParameter(absl::string_view base_type_name,
                     absl::optional<absl::string_view> type_name,
                     absl::Span<ParameterMatcher* const> param_matchers,
                     Parameter& parameter,
-                    std::vector<Parameter>* unhandled_parameters) {
+                    ArenaVector<Parameter>* unhandled_parameters) {
   bool found = false;
   for (auto& current : param_matchers) {
     if (current->Match(base_type_name, type_name, parameter)) {
@@ -331,11 +399,11 @@ void MatchParameter(absl::string_view base_type_name,
     if (!unhandled_parameters) {
       std::cerr << "ERROR: Unrecognized or misconfigured parameter to "
                 << ErrorTypeName(base_type_name, type_name) << ": "
-                << parameter.first << std::endl;
+                << parameter.name << std::endl;
       exit(EXIT_FAILURE);
     }
 
-    unhandled_parameters->push_back(parameter);
+    unhandled_parameters->push_back(std::move(parameter));
   }
 }
 
@@ -343,7 +411,7 @@ void MatchParameters(absl::string_view base_type_name,
                      absl::optional<absl::string_view> type_name,
                      Tokenizer& tokenizer,
                      absl::Span<ParameterMatcher* const> param_matchers,
-                     std::vector<Parameter>* unhandled_parameters) {
+                     ArenaVector<Parameter>* unhandled_parameters) {
   for (auto parameter = ParseNextParam(tokenizer); parameter.has_value();
        parameter = ParseNextParam(tokenizer)) {
     MatchParameter(base_type_name, type_name, param_matchers, *parameter,
@@ -356,9 +424,9 @@ void MatchParameters(absl::string_view base_type_name,
 
 void MatchParameters(absl::string_view base_type_name,
                      absl::optional<absl::string_view> type_name,
-                     std::vector<Parameter>& parameters,
+                     ArenaVector<Parameter>& parameters,
                      absl::Span<ParameterMatcher* const> param_matchers,
-                     std::vector<Parameter>* unhandled_parameters) {
+                     ArenaVector<Parameter>* unhandled_parameters) {
   for (auto& parameter : parameters) {
     MatchParameter(base_type_name, type_name, param_matchers, parameter,
                    unhandled_parameters);
@@ -375,7 +443,7 @@ absl::string_view kInvalidTypeName = "[INVALID_TYPE_NAME]";
 Parameters::Parameters()
     : m_base_type_name(kInvalidTypeName),
       m_type_name(kInvalidTypeName),
-      m_unused_parameters(std::vector<Parameter>()),
+      m_unused_parameters(ArenaVector<Parameter>()),
       m_tokenizer(nullptr) {}
 
 Parameters::Parameters(absl::string_view base_type_name, Tokenizer& tokenizer)
@@ -389,7 +457,7 @@ Parameters::Parameters(absl::string_view base_type_name,
 
 Parameters::Parameters(absl::string_view base_type_name,
                        absl::optional<absl::string_view> type_name,
-                       std::vector<Parameter> unused_parameters)
+                       ArenaVector<Parameter> unused_parameters)
     : m_base_type_name(base_type_name),
       m_type_name(type_name),
       m_unused_parameters(std::move(unused_parameters)),
@@ -419,7 +487,7 @@ Parameters::~Parameters() { assert(!m_unused_parameters && !m_tokenizer); }
 Parameters Parameters::MatchAllowUnusedImpl(
     absl::Span<ParameterMatcher* const> param_matchers) {
   assert(m_tokenizer || m_unused_parameters);
-  std::vector<Parameter> unused_parameters;
+  auto unused_parameters = MakeArenaVector<Parameter>();
   if (m_tokenizer) {
     MatchParameters(m_base_type_name, m_type_name, *m_tokenizer, param_matchers,
                     &unused_parameters);
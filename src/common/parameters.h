@@ -44,7 +44,7 @@ class Parameters {
              Tokenizer& tokenizer);
   Parameters(absl::string_view base_type_name,
              absl::optional<absl::string_view> type_name,
-             std::vector<Parameter> unused_parameters);
+             ArenaVector<Parameter> unused_parameters);
 
   Parameters MatchAllowUnusedImpl(
       absl::Span<ParameterMatcher* const> param_matchers);
@@ -52,7 +52,7 @@ class Parameters {
 
   absl::string_view m_base_type_name;
   absl::optional<absl::string_view> m_type_name;
-  absl::optional<std::vector<Parameter>> m_unused_parameters;
+  absl::optional<ArenaVector<Parameter>> m_unused_parameters;
   Tokenizer* m_tokenizer;
 
   friend class Directive;
@@ -0,0 +1,105 @@
+#include "src/common/perf_counters.h"
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+
+namespace iris {
+namespace {
+
+struct EventConfig {
+  uint32_t type;
+  uint64_t config;
+};
+
+constexpr uint64_t CacheConfig(uint64_t cache, uint64_t result) {
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (result << 16);
+}
+
+// In the order of the fields of PerfCounts.
+const EventConfig kEvents[] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE,
+     CacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {PERF_TYPE_HW_CACHE,
+     CacheConfig(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}};
+
+constexpr size_t kNumEvents = sizeof(kEvents) / sizeof(kEvents[0]);
+static_assert(sizeof(PerfCounts) == kNumEvents * sizeof(uint64_t),
+              "PerfCounts must have one field per event");
+
+int g_fds[kNumEvents];
+std::atomic<bool> g_enabled(false);
+
+int OpenEvent(const EventConfig& event) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = event.type;
+  attr.config = event.config;
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1,
+                                  PERF_FLAG_FD_CLOEXEC));
+}
+
+uint64_t ReadEvent(int fd) {
+  uint64_t values[3];
+  if (read(fd, values, sizeof(values)) != sizeof(values) || values[2] == 0) {
+    return 0;
+  }
+
+  if (values[1] == values[2]) {
+    return values[0];
+  }
+
+  return static_cast<uint64_t>(static_cast<double>(values[0]) *
+                               static_cast<double>(values[1]) /
+                               static_cast<double>(values[2]));
+}
+
+}  // namespace
+
+bool EnablePerfCounters() {
+  for (size_t i = 0; i < kNumEvents; i++) {
+    g_fds[i] = OpenEvent(kEvents[i]);
+    if (g_fds[i] < 0) {
+      for (size_t j = 0; j < i; j++) {
+        close(g_fds[j]);
+      }
+      return false;
+    }
+  }
+
+  g_enabled.store(true, std::memory_order_release);
+  return true;
+}
+
+bool PerfCountersEnabled() {
+  return g_enabled.load(std::memory_order_acquire);
+}
+
+PerfCounts ReadPerfCounters() {
+  uint64_t values[kNumEvents] = {};
+  if (PerfCountersEnabled()) {
+    for (size_t i = 0; i < kNumEvents; i++) {
+      values[i] = ReadEvent(g_fds[i]);
+    }
+  }
+
+  PerfCounts result;
+  memcpy(&result, values, sizeof(result));
+  return result;
+}
+
+}  // namespace iris
\ No newline at end of file
@@ -0,0 +1,34 @@
+#ifndef _SRC_COMMON_PERF_COUNTERS_
+#define _SRC_COMMON_PERF_COUNTERS_
+
+#include <cstdint>
+
+namespace iris {
+
+// Hardware performance counters of the process, counted in user space only.
+// When a counter is multiplexed with others its count is scaled up by the
+// fraction of the time it was enabled that it was running.
+struct PerfCounts {
+  uint64_t cycles;
+  uint64_t instructions;
+  uint64_t l1d_misses;
+  uint64_t llc_misses;
+  uint64_t branches;
+  uint64_t branch_misses;
+};
+
+// Opens the counters on the calling thread, which are inherited by every
+// thread and process it creates afterwards. The counts of a thread are only
+// added to the totals once it exits, so the counters must be enabled before
+// any other threads are created. Returns false if the counters could not be
+// opened, in which case they remain disabled.
+bool EnablePerfCounters();
+
+bool PerfCountersEnabled();
+
+// Returns the totals as of the call, or zeros if the counters are disabled.
+PerfCounts ReadPerfCounters();
+
+}  // namespace iris
+
+#endif  // _SRC_COMMON_PERF_COUNTERS_
\ No newline at end of file
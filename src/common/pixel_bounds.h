@@ -0,0 +1,24 @@
+#ifndef _SRC_COMMON_PIXEL_BOUNDS_
+#define _SRC_COMMON_PIXEL_BOUNDS_
+
+#include <cstddef>
+
+namespace iris {
+
+// A rectangle of pixels in an image, from the minimum column and row up to
+// but not including the maximum column and row.
+struct PixelBounds {
+  size_t NumColumns() const { return max_column - min_column; }
+  size_t NumRows() const { return max_row - min_row; }
+
+  bool Empty() const { return max_column <= min_column || max_row <= min_row; }
+
+  size_t min_column;
+  size_t max_column;
+  size_t min_row;
+  size_t max_row;
+};
+
+}  // namespace iris
+
+#endif  // _SRC_COMMON_PIXEL_BOUNDS_
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "src/common/pointer_counters.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <vector>
+
+namespace iris {
+namespace {
+
+struct PointerCounts {
+  const char* type_name;
+  uint64_t num_handles;
+  uint64_t num_objects;
+};
+
+MemoryCheckpointHook g_checkpoint_hook = nullptr;
+
+std::mutex g_registries_mutex;
+
+std::vector<internal::PointerRegistry*>& Registries() {
+  static std::vector<internal::PointerRegistry*>* registries =
+      new std::vector<internal::PointerRegistry*>();
+  return *registries;
+}
+
+std::vector<PointerCounts> CountPointers() {
+  std::vector<internal::PointerRegistry*> registries;
+  {
+    std::lock_guard<std::mutex> lock(g_registries_mutex);
+    registries = Registries();
+  }
+
+  std::vector<PointerCounts> result;
+  for (internal::PointerRegistry* registry : registries) {
+    PointerCounts counts = {registry->TypeName(), 0, 0};
+    absl::flat_hash_set<const void*> objects;
+    registry->ForEach([&](const void* object) {
+      if (object == nullptr) {
+        return;
+      }
+
+      counts.num_handles += 1;
+      if (objects.insert(object).second) {
+        counts.num_objects += 1;
+      }
+    });
+    result.push_back(counts);
+  }
+
+  std::sort(result.begin(), result.end(),
+            [](const PointerCounts& left, const PointerCounts& right) {
+              return left.num_objects > right.num_objects;
+            });
+
+  return result;
+}
+
+}  // namespace
+
+namespace internal {
+
+std::atomic<bool> g_pointer_counters_enabled(false);
+
+PointerRegistry::PointerRegistry(const char* type_name)
+    : m_type_name(type_name) {
+  std::lock_guard<std::mutex> lock(g_registries_mutex);
+  Registries().push_back(this);
+}
+
+void PointerRegistry::Add(void* const* handle) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_handles.insert(handle);
+}
+
+void PointerRegistry::Remove(void* const* handle) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_handles.erase(handle);
+}
+
+}  // namespace internal
+
+void EnablePointerCounters() {
+  internal::g_pointer_counters_enabled.store(true, std::memory_order_release);
+}
+
+void SetMemoryCheckpointHook(MemoryCheckpointHook hook) {
+  g_checkpoint_hook = hook;
+}
+
+void MemoryCheckpoint(const char* name, size_t render_index,
+                      std::ostream& output) {
+  std::string checkpoint =
+      std::string(name) + "." + std::to_string(render_index);
+
+  if (internal::g_pointer_counters_enabled.load(std::memory_order_acquire)) {
+    std::ios_base::fmtflags flags = output.flags();
+    std::streamsize precision = output.precision();
+
+    output << "Live pointers at " << checkpoint << std::endl
+           << std::left << std::setw(24) << "Type" << std::right
+           << std::setw(12) << "Handles" << std::setw(12) << "Objects"
+           << std::endl;
+    for (const auto& counts : CountPointers()) {
+      if (counts.num_handles == 0) {
+        continue;
+      }
+
+      output << std::left << std::setw(24) << counts.type_name
+             << std::right << std::setw(12) << counts.num_handles
+             << std::setw(12) << counts.num_objects << std::endl;
+    }
+
+    output.flags(flags);
+    output.precision(precision);
+  }
+
+  if (g_checkpoint_hook) {
+    g_checkpoint_hook(checkpoint);
+  }
+}
+
+}  // namespace iris
\ No newline at end of file
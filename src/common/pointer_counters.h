@@ -0,0 +1,99 @@
+#ifndef _SRC_COMMON_POINTER_COUNTERS_
+#define _SRC_COMMON_POINTER_COUNTERS_
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+#include "absl/container/flat_hash_set.h"
+
+namespace iris {
+
+// Counts of the live objects held by the SharedPtr and UniquePtr wrappers of
+// each pointer type. Counting is off unless enabled by the instrumented
+// build, in which case each wrapper registers itself while it exists and the
+// objects the wrappers point to are only tallied when a checkpoint is
+// reached.
+//
+// Only the number of objects is reported. The objects are opaque iris types
+// whose storage, such as the nodes of a BVH or the vertices of a mesh, is
+// allocated separately from the object itself, so the heap profile is the
+// place to look for their sizes.
+
+// Called with the name of each checkpoint, after the counts are written.
+typedef void (*MemoryCheckpointHook)(const std::string& name);
+
+// Must be called before any wrappers are created.
+void EnablePointerCounters();
+
+void SetMemoryCheckpointHook(MemoryCheckpointHook hook);
+
+// If counting is enabled, writes the number of wrappers and distinct objects
+// for each pointer type to output. Must not be called while wrappers are
+// being created or destroyed on other threads.
+void MemoryCheckpoint(const char* name, size_t render_index,
+                      std::ostream& output);
+
+// The name under which the wrappers of a type are reported. Specialized for
+// each type in pointer_types.h.
+template <typename Type>
+const char* PointerTypeName();
+
+namespace internal {
+
+extern std::atomic<bool> g_pointer_counters_enabled;
+
+class PointerRegistry {
+ public:
+  explicit PointerRegistry(const char* type_name);
+
+  void Add(void* const* handle);
+  void Remove(void* const* handle);
+
+  const char* TypeName() const { return m_type_name; }
+
+  template <typename Function>
+  void ForEach(Function function) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (void* const* handle : m_handles) {
+      function(*handle);
+    }
+  }
+
+ private:
+  const char* m_type_name;
+  std::mutex m_mutex;
+  absl::flat_hash_set<void* const*> m_handles;
+};
+
+// Registries are never destroyed so that wrappers with static storage
+// duration may outlive them.
+template <typename Type>
+PointerRegistry& RegistryFor() {
+  static PointerRegistry* registry =
+      new PointerRegistry(PointerTypeName<Type>());
+  return *registry;
+}
+
+}  // namespace internal
+
+template <typename Type>
+void RegisterPointer(Type* const* handle) {
+  if (internal::g_pointer_counters_enabled.load(std::memory_order_relaxed)) {
+    internal::RegistryFor<Type>().Add(reinterpret_cast<void* const*>(handle));
+  }
+}
+
+template <typename Type>
+void UnregisterPointer(Type* const* handle) {
+  if (internal::g_pointer_counters_enabled.load(std::memory_order_relaxed)) {
+    internal::RegistryFor<Type>().Remove(
+        reinterpret_cast<void* const*>(handle));
+  }
+}
+
+}  // namespace iris
+
+#endif  // _SRC_COMMON_POINTER_COUNTERS_
\ No newline at end of file
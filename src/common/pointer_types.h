@@ -8,6 +8,7 @@
 #include "iris_physx_toolkit/float_texture.h"
 #include "iris_physx_toolkit/mipmap.h"
 #include "iris_physx_toolkit/reflector_texture.h"
+#include "src/common/pointer_counters.h"
 #include "src/common/shared_ptr.h"
 #include "src/common/unique_ptr.h"
 
@@ -55,6 +56,111 @@ typedef SharedPtr<TEXTURE_COORDINATE_MAP, TextureCoordinateMapRetain,
                   TextureCoordinateMapRelease>
     TextureCoordinateMaps;
 
+// The names under which each pointer type is counted.
+template <>
+inline const char* PointerTypeName<BSDF>() { return "Bsdf"; }
+
+template <>
+inline const char* PointerTypeName<CAMERA>() { return "Camera"; }
+
+template <>
+inline const char* PointerTypeName<COLOR_EXTRAPOLATOR>() {
+  return "ColorExtrapolator";
+}
+
+template <>
+inline const char* PointerTypeName<COLOR_INTEGRATOR>() {
+  return "ColorIntegrator";
+}
+
+template <>
+inline const char* PointerTypeName<EMISSIVE_MATERIAL>() {
+  return "EmissiveMaterial";
+}
+
+template <>
+inline const char* PointerTypeName<ENVIRONMENTAL_LIGHT>() {
+  return "EnvironmentalLight";
+}
+
+template <>
+inline const char* PointerTypeName<FLOAT_MIPMAP>() { return "FloatMipmap"; }
+
+template <>
+inline const char* PointerTypeName<FLOAT_TEXTURE>() { return "FloatTexture"; }
+
+template <>
+inline const char* PointerTypeName<FRAMEBUFFER>() { return "Framebuffer"; }
+
+template <>
+inline const char* PointerTypeName<INTEGRATOR>() { return "Integrator"; }
+
+template <>
+inline const char* PointerTypeName<MATERIAL>() { return "Material"; }
+
+template <>
+inline const char* PointerTypeName<MATRIX>() { return "Matrix"; }
+
+template <>
+inline const char* PointerTypeName<NORMAL_MAP>() { return "NormalMap"; }
+
+template <>
+inline const char* PointerTypeName<LIGHT>() { return "Light"; }
+
+template <>
+inline const char* PointerTypeName<LIGHT_SAMPLER>() { return "LightSampler"; }
+
+template <>
+inline const char* PointerTypeName<LOW_DISCREPANCY_SEQUENCE>() {
+  return "LowDiscrepancySequence";
+}
+
+template <>
+inline const char* PointerTypeName<PROGRESS_REPORTER>() {
+  return "ProgressReporter";
+}
+
+template <>
+inline const char* PointerTypeName<RANDOM>() { return "Random"; }
+
+template <>
+inline const char* PointerTypeName<REFLECTOR>() { return "Reflector"; }
+
+template <>
+inline const char* PointerTypeName<REFLECTOR_MIPMAP>() {
+  return "ReflectorMipmap";
+}
+
+template <>
+inline const char* PointerTypeName<REFLECTOR_TEXTURE>() {
+  return "ReflectorTexture";
+}
+
+template <>
+inline const char* PointerTypeName<IMAGE_SAMPLER>() { return "Sampler"; }
+
+template <>
+inline const char* PointerTypeName<SAMPLE_TRACER>() { return "SampleTracer"; }
+
+template <>
+inline const char* PointerTypeName<SCENE>() { return "Scene"; }
+
+template <>
+inline const char* PointerTypeName<SHAPE>() { return "Shape"; }
+
+template <>
+inline const char* PointerTypeName<SPECTRUM>() { return "Spectrum"; }
+
+template <>
+inline const char* PointerTypeName<SPECTRUM_MIPMAP>() {
+  return "SpectrumMipmap";
+}
+
+template <>
+inline const char* PointerTypeName<TEXTURE_COORDINATE_MAP>() {
+  return "TextureCoordinateMaps";
+}
+
 }  // namespace iris
 
 #endif  // _SRC_COMMON_POINTER_TYPES_
\ No newline at end of file
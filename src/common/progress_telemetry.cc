@@ -0,0 +1,218 @@
+#include "src/common/progress_telemetry.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "absl/time/clock.h"
+
+namespace iris {
+namespace {
+
+uint64_t ResidentSetBytes() {
+  std::ifstream statm("/proc/self/statm");
+  uint64_t total_pages, resident_pages;
+  if (!(statm >> total_pages >> resident_pages)) {
+    return 0;
+  }
+
+  return resident_pages * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+// The scaled counts of multiplexed counters can decrease between reads.
+uint64_t Delta(uint64_t start, uint64_t end) {
+  return (start < end) ? end - start : 0;
+}
+
+void WriteOptional(std::ostream& output, bool has_value, double value) {
+  if (has_value) {
+    output << value;
+  } else {
+    output << "null";
+  }
+}
+
+}  // namespace
+
+ProgressTelemetry::ProgressTelemetry(const std::string& path,
+                                     size_t render_index,
+                                     absl::Duration interval)
+    : m_fd(open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644)),
+      m_render_index(render_index),
+      m_interval(interval),
+      m_stop(false),
+      m_time_limit(absl::InfiniteDuration()),
+      m_total_samples(0),
+      m_initial_samples(0),
+      m_samples(0),
+      m_perf_start(ReadPerfCounters()) {
+  if (m_fd < 0) {
+    std::cerr << "ERROR: Failed to open progress file: " << path
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  Resume();
+}
+
+ProgressTelemetry::~ProgressTelemetry() {
+  EndPhase();
+  Suspend();
+  close(m_fd);
+}
+
+void ProgressTelemetry::Suspend() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+
+  m_wake.notify_one();
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+void ProgressTelemetry::Resume() {
+  assert(!m_thread.joinable());
+  m_stop = false;
+  m_thread = std::thread(&ProgressTelemetry::Run, this);
+}
+
+void ProgressTelemetry::Poll() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (RecordDue()) {
+    WriteRecord(/*phase_done=*/false);
+  }
+}
+
+void ProgressTelemetry::BeginPhase(const std::string& phase,
+                                   absl::Duration time_limit) {
+  EndPhase();
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_phase = phase;
+  m_phase_start = absl::Now();
+  m_last_record = m_phase_start;
+  m_time_limit = time_limit;
+  m_total_samples = 0;
+  m_initial_samples = 0;
+  m_samples.store(0, std::memory_order_relaxed);
+  m_perf_start = ReadPerfCounters();
+}
+
+void ProgressTelemetry::EndPhase() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_phase.empty()) {
+    WriteRecord(/*phase_done=*/true);
+    m_phase.clear();
+  }
+}
+
+void ProgressTelemetry::SetTotalSamples(uint64_t total_samples) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_total_samples = total_samples;
+  m_initial_samples = m_samples.load(std::memory_order_relaxed);
+}
+
+// Called with the mutex held.
+bool ProgressTelemetry::RecordDue() const {
+  return !m_phase.empty() && m_interval <= absl::Now() - m_last_record;
+}
+
+// Called with the mutex held. Each record is written with a single call so
+// that records are not interleaved with those of other processes appending
+// to the same file.
+void ProgressTelemetry::WriteRecord(bool phase_done) {
+  m_last_record = absl::Now();
+  absl::Duration elapsed = m_last_record - m_phase_start;
+  double elapsed_seconds = absl::ToDoubleSeconds(elapsed);
+  uint64_t samples = m_samples.load(std::memory_order_relaxed);
+
+  // Samples that were traced before the phase began, such as those restored
+  // from a checkpoint, count towards its progress but not its rate.
+  double samples_per_second =
+      (elapsed_seconds != 0.0)
+          ? static_cast<double>(samples - m_initial_samples) /
+                elapsed_seconds
+          : 0.0;
+
+  bool has_fraction = phase_done || m_total_samples != 0 ||
+                      m_time_limit != absl::InfiniteDuration();
+  double fraction = 1.0;
+  if (!phase_done) {
+    fraction = 0.0;
+    if (m_total_samples != 0) {
+      fraction = static_cast<double>(samples) / m_total_samples;
+    }
+    if (m_time_limit != absl::InfiniteDuration()) {
+      fraction = std::max(fraction, absl::FDivDuration(elapsed, m_time_limit));
+    }
+    fraction = std::min(fraction, 1.0);
+  }
+
+  bool has_eta = phase_done;
+  double eta_seconds = 0.0;
+  if (!phase_done && m_total_samples != 0 && samples_per_second != 0.0) {
+    has_eta = true;
+    eta_seconds = std::max(0.0, static_cast<double>(m_total_samples) -
+                                    static_cast<double>(samples)) /
+                  samples_per_second;
+  }
+  if (!phase_done && m_time_limit != absl::InfiniteDuration()) {
+    double remaining_seconds =
+        std::max(0.0, absl::ToDoubleSeconds(m_time_limit - elapsed));
+    eta_seconds = has_eta ? std::min(eta_seconds, remaining_seconds)
+                          : remaining_seconds;
+    has_eta = true;
+  }
+
+  std::ostringstream record;
+  record << "{\"render\":" << m_render_index << ",\"phase\":\"" << m_phase
+         << "\",\"fraction\":";
+  WriteOptional(record, has_fraction, fraction);
+  record << ",\"elapsed_seconds\":" << elapsed_seconds << ",\"eta_seconds\":";
+  WriteOptional(record, has_eta, eta_seconds);
+  record << ",\"samples\":" << samples
+         << ",\"samples_per_second\":" << samples_per_second
+         << ",\"rss_bytes\":" << ResidentSetBytes();
+  if (phase_done && PerfCountersEnabled()) {
+    PerfCounts perf = ReadPerfCounters();
+    record << ",\"perf\":{\"cycles\":"
+           << Delta(m_perf_start.cycles, perf.cycles) << ",\"instructions\":"
+           << Delta(m_perf_start.instructions, perf.instructions)
+           << ",\"l1d_misses\":"
+           << Delta(m_perf_start.l1d_misses, perf.l1d_misses)
+           << ",\"llc_misses\":"
+           << Delta(m_perf_start.llc_misses, perf.llc_misses)
+           << ",\"branches\":" << Delta(m_perf_start.branches, perf.branches)
+           << ",\"branch_misses\":"
+           << Delta(m_perf_start.branch_misses, perf.branch_misses) << "}";
+  }
+  record << "}\n";
+
+  std::string line = record.str();
+  if (write(m_fd, line.data(), line.size()) !=
+      static_cast<ssize_t>(line.size())) {
+    std::cerr << "ERROR: Failed to write progress record" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+void ProgressTelemetry::Run() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_stop) {
+    m_wake.wait_for(lock, absl::ToChronoNanoseconds(m_interval));
+    if (!m_stop && RecordDue()) {
+      WriteRecord(/*phase_done=*/false);
+    }
+  }
+}
+
+}  // namespace iris
\ No newline at end of file
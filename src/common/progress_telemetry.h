@@ -0,0 +1,101 @@
+#ifndef _SRC_COMMON_PROGRESS_TELEMETRY_
+#define _SRC_COMMON_PROGRESS_TELEMETRY_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "absl/time/time.h"
+#include "src/common/perf_counters.h"
+
+namespace iris {
+
+// Periodically appends the progress of a render to a file as JSON records,
+// one per line, for tools that schedule and monitor renders. Each record has
+// the fields:
+//
+//   render              The index of the render in the input
+//   phase               The phase in progress, such as "parse" or "render"
+//   fraction            The fraction of the phase completed, or null
+//   elapsed_seconds     The time spent in the phase so far
+//   eta_seconds         The estimated time left in the phase, or null
+//   samples             The number of camera samples traced in the phase
+//   samples_per_second  The rate at which samples have been traced
+//   rss_bytes           The resident set size of the process
+//   perf                The hardware performance counters of the phase, as
+//                       cycles, instructions, l1d_misses, llc_misses,
+//                       branches, and branch_misses
+//
+// A record is written every interval while a phase is in progress and once
+// more when each phase ends, at which point its fraction is 1. Only phases
+// that trace samples have a fraction before they end. The perf field is only
+// present if the counters are enabled, and only in the record written when a
+// phase ends, since the counts of a thread are not added to the totals until
+// it exits.
+//
+// Periodic records are written by a background thread, which must be
+// suspended while the process forks.
+class ProgressTelemetry {
+ public:
+  // Records are appended to path, which may name an inherited file
+  // descriptor as /dev/fd/N.
+  ProgressTelemetry(const std::string& path, size_t render_index,
+                    absl::Duration interval);
+  ~ProgressTelemetry();
+
+  ProgressTelemetry(const ProgressTelemetry&) = delete;
+  ProgressTelemetry& operator=(const ProgressTelemetry&) = delete;
+
+  // Ends the phase in progress, if any, and begins a new one. If time_limit
+  // is finite, the phase is expected to end once it has elapsed.
+  void BeginPhase(const std::string& phase,
+                  absl::Duration time_limit = absl::InfiniteDuration());
+  void EndPhase();
+
+  // The total number of samples the phase traces, including any traced by
+  // an earlier process whose state it continues from. Zero if unknown.
+  void SetTotalSamples(uint64_t total_samples);
+
+  // May be called concurrently from any thread.
+  void AddSamples(uint64_t samples) {
+    m_samples.fetch_add(samples, std::memory_order_relaxed);
+  }
+
+  // Joins the background thread so that no other threads are running, as
+  // WorkerPool::Run requires, and restarts it. While suspended, records are
+  // only written by Poll.
+  void Suspend();
+  void Resume();
+
+  // Writes a record if the interval has elapsed since the last one.
+  void Poll();
+
+ private:
+  void WriteRecord(bool phase_done);
+  bool RecordDue() const;
+  void Run();
+
+  int m_fd;
+  size_t m_render_index;
+  absl::Duration m_interval;
+
+  std::mutex m_mutex;
+  std::condition_variable m_wake;
+  bool m_stop;
+  std::string m_phase;
+  absl::Time m_phase_start;
+  absl::Time m_last_record;
+  absl::Duration m_time_limit;
+  uint64_t m_total_samples;
+  uint64_t m_initial_samples;
+  std::atomic<uint64_t> m_samples;
+  PerfCounts m_perf_start;
+  std::thread m_thread;
+};
+
+}  // namespace iris
+
+#endif  // _SRC_COMMON_PROGRESS_TELEMETRY_
\ No newline at end of file
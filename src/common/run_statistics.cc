@@ -0,0 +1,215 @@
+#include "src/common/run_statistics.h"
+
+#include <sys/resource.h>
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace iris {
+namespace {
+
+struct PhaseStatistics {
+  const char* name;
+  size_t depth;
+  uint64_t count;
+  double wall_seconds;
+  double cpu_seconds;
+  uint64_t peak_rss_bytes;
+  uint64_t samples;
+  PerfCounts perf;
+};
+
+// Indexed by Counter.
+const char* const kCounterNames[] = {"ply_bytes_read", "textures_decoded",
+                                     "shapes_created", "lights_created"};
+
+constexpr size_t kNumCounters =
+    sizeof(kCounterNames) / sizeof(kCounterNames[0]);
+
+std::atomic<uint64_t> g_counters[kNumCounters];
+
+std::mutex g_phases_mutex;
+std::vector<PhaseStatistics> g_phases;
+
+thread_local size_t g_phase_depth = 0;
+
+double ProcessCpuSeconds() {
+  timespec time;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+  return static_cast<double>(time.tv_sec) + time.tv_nsec * 1e-9;
+}
+
+uint64_t PeakResidentSetBytes() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+}
+
+// Phases are added when they first begin, so each phase is listed ahead of
+// the phases nested within it.
+size_t FindOrAddPhase(const char* name, size_t depth) {
+  std::lock_guard<std::mutex> lock(g_phases_mutex);
+  for (size_t i = 0; i < g_phases.size(); i++) {
+    if (std::strcmp(g_phases[i].name, name) == 0) {
+      return i;
+    }
+  }
+
+  g_phases.push_back({name, depth, 0, 0.0, 0.0, 0, 0, {0, 0, 0, 0, 0, 0}});
+  return g_phases.size() - 1;
+}
+
+// Scaled counts of multiplexed counters may decrease slightly.
+uint64_t Delta(uint64_t start, uint64_t end) {
+  return (start < end) ? end - start : 0;
+}
+
+void AddPerfDelta(const PerfCounts& start, const PerfCounts& end,
+                  PerfCounts* total) {
+  total->cycles += Delta(start.cycles, end.cycles);
+  total->instructions += Delta(start.instructions, end.instructions);
+  total->l1d_misses += Delta(start.l1d_misses, end.l1d_misses);
+  total->llc_misses += Delta(start.llc_misses, end.llc_misses);
+  total->branches += Delta(start.branches, end.branches);
+  total->branch_misses += Delta(start.branch_misses, end.branch_misses);
+}
+
+double Ratio(uint64_t numerator, uint64_t denominator) {
+  return (denominator != 0) ? static_cast<double>(numerator) / denominator
+                            : 0.0;
+}
+
+std::vector<PhaseStatistics> CopyPhases() {
+  std::lock_guard<std::mutex> lock(g_phases_mutex);
+  return g_phases;
+}
+
+}  // namespace
+
+void IncrementCounter(Counter counter, uint64_t amount) {
+  g_counters[static_cast<size_t>(counter)].fetch_add(
+      amount, std::memory_order_relaxed);
+}
+
+uint64_t GetCounter(Counter counter) {
+  return g_counters[static_cast<size_t>(counter)].load(
+      std::memory_order_relaxed);
+}
+
+ScopedPhase::ScopedPhase(const char* name)
+    : m_trace("phase", name),
+      m_index(FindOrAddPhase(name, g_phase_depth++)),
+      m_wall_start(std::chrono::steady_clock::now()),
+      m_cpu_start(ProcessCpuSeconds()),
+      m_perf_start(ReadPerfCounters()) {}
+
+ScopedPhase::~ScopedPhase() {
+  double wall_seconds = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - m_wall_start)
+                            .count();
+  double cpu_seconds = ProcessCpuSeconds() - m_cpu_start;
+  PerfCounts perf_end = ReadPerfCounters();
+  uint64_t peak_rss_bytes = PeakResidentSetBytes();
+  g_phase_depth -= 1;
+
+  std::lock_guard<std::mutex> lock(g_phases_mutex);
+  PhaseStatistics* phase = &g_phases[m_index];
+  phase->count += 1;
+  phase->wall_seconds += wall_seconds;
+  phase->cpu_seconds += cpu_seconds;
+  phase->peak_rss_bytes = std::max(phase->peak_rss_bytes, peak_rss_bytes);
+  AddPerfDelta(m_perf_start, perf_end, &phase->perf);
+}
+
+void ScopedPhase::AddSamples(uint64_t num_samples) {
+  std::lock_guard<std::mutex> lock(g_phases_mutex);
+  g_phases[m_index].samples += num_samples;
+}
+
+void WriteRunStatistics(std::ostream& output) {
+  std::ios_base::fmtflags flags = output.flags();
+  std::streamsize precision = output.precision();
+
+  output << std::left << std::setw(24) << "Phase" << std::right
+         << std::setw(8) << "Count" << std::setw(12) << "Wall"
+         << std::setw(12) << "CPU" << std::setw(14) << "Peak RSS"
+         << std::endl;
+  for (const auto& phase : CopyPhases()) {
+    output << std::left << std::setw(24)
+           << std::string(2 * phase.depth, ' ') + phase.name << std::right
+           << std::setw(8) << phase.count << std::fixed
+           << std::setprecision(3) << std::setw(11) << phase.wall_seconds
+           << "s" << std::setw(11) << phase.cpu_seconds << "s"
+           << std::setprecision(1) << std::setw(11)
+           << phase.peak_rss_bytes / (1024.0 * 1024.0) << " MB" << std::endl;
+  }
+
+  for (size_t i = 0; i < kNumCounters; i++) {
+    output << kCounterNames[i] << ": "
+           << g_counters[i].load(std::memory_order_relaxed) << std::endl;
+  }
+
+  if (PerfCountersEnabled()) {
+    output << std::left << std::setw(24) << "Phase" << std::right
+           << std::setw(8) << "IPC" << std::setw(16) << "L1D miss/smp"
+           << std::setw(16) << "LLC miss/smp" << std::setw(14)
+           << "Branch miss" << std::endl;
+    for (const auto& phase : CopyPhases()) {
+      output << std::left << std::setw(24)
+             << std::string(2 * phase.depth, ' ') + phase.name << std::right
+             << std::fixed << std::setprecision(2) << std::setw(8)
+             << Ratio(phase.perf.instructions, phase.perf.cycles);
+      if (phase.samples != 0) {
+        output << std::setprecision(1) << std::setw(16)
+               << Ratio(phase.perf.l1d_misses, phase.samples)
+               << std::setw(16) << Ratio(phase.perf.llc_misses, phase.samples);
+      } else {
+        output << std::setw(16) << "-" << std::setw(16) << "-";
+      }
+      output << std::setprecision(2) << std::setw(13)
+             << 100.0 * Ratio(phase.perf.branch_misses, phase.perf.branches)
+             << "%" << std::endl;
+    }
+  }
+
+  output.flags(flags);
+  output.precision(precision);
+}
+
+void WriteRunStatisticsJson(std::ostream& output) {
+  output << "{\"phases\":[";
+  bool first = true;
+  for (const auto& phase : CopyPhases()) {
+    output << (first ? "" : ",") << "{\"name\":\"" << phase.name
+           << "\",\"depth\":" << phase.depth << ",\"count\":" << phase.count
+           << ",\"wall_seconds\":" << phase.wall_seconds
+           << ",\"cpu_seconds\":" << phase.cpu_seconds
+           << ",\"peak_rss_bytes\":" << phase.peak_rss_bytes
+           << ",\"samples\":" << phase.samples;
+    if (PerfCountersEnabled()) {
+      output << ",\"perf\":{\"cycles\":" << phase.perf.cycles
+             << ",\"instructions\":" << phase.perf.instructions
+             << ",\"l1d_misses\":" << phase.perf.l1d_misses
+             << ",\"llc_misses\":" << phase.perf.llc_misses
+             << ",\"branches\":" << phase.perf.branches
+             << ",\"branch_misses\":" << phase.perf.branch_misses << "}";
+    }
+    output << "}";
+    first = false;
+  }
+
+  output << "],\"counters\":{";
+  for (size_t i = 0; i < kNumCounters; i++) {
+    output << (i == 0 ? "" : ",") << "\"" << kCounterNames[i]
+           << "\":" << g_counters[i].load(std::memory_order_relaxed);
+  }
+  output << "}}" << std::endl;
+}
+
+}  // namespace iris
\ No newline at end of file
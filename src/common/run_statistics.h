@@ -0,0 +1,64 @@
+#ifndef _SRC_COMMON_RUN_STATISTICS_
+#define _SRC_COMMON_RUN_STATISTICS_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "src/common/perf_counters.h"
+#include "src/common/trace.h"
+
+namespace iris {
+
+// Statistics gathered over the whole run of a process, across every render.
+// They are cheap enough to be recorded unconditionally.
+
+enum class Counter {
+  PLY_BYTES_READ,
+  TEXTURES_DECODED,
+  SHAPES_CREATED,
+  LIGHTS_CREATED
+};
+
+void IncrementCounter(Counter counter, uint64_t amount = 1);
+uint64_t GetCounter(Counter counter);
+
+// Adds the wall time and process CPU time spent in its scope to the totals of
+// the phase with the given name, which must outlive the run, and records the
+// peak resident set size of the process as of the end of the scope. Phases
+// that begin within another phase on the same thread are nested within it
+// and their times are also counted in the enclosing phase. Each phase is also
+// recorded as a trace event and, if enabled, the hardware performance
+// counters of the process over the scope are added to the phase.
+class ScopedPhase {
+ public:
+  explicit ScopedPhase(const char* name);
+  ~ScopedPhase();
+
+  // Adds to the number of samples traced in the phase, by which the
+  // performance counters of the phase are divided when reported.
+  void AddSamples(uint64_t num_samples);
+
+  ScopedPhase(const ScopedPhase&) = delete;
+  ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+ private:
+  TraceScope m_trace;
+  size_t m_index;
+  std::chrono::steady_clock::time_point m_wall_start;
+  double m_cpu_start;
+  PerfCounts m_perf_start;
+};
+
+// Writes a table of the phases, in the order in which they first began, and
+// the counters, followed by a table of the rates derived from the
+// performance counters of each phase if they are enabled.
+void WriteRunStatistics(std::ostream& output);
+
+// Writes the same statistics as a JSON object.
+void WriteRunStatisticsJson(std::ostream& output);
+
+}  // namespace iris
+
+#endif  // _SRC_COMMON_RUN_STATISTICS_
\ No newline at end of file
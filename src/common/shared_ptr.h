@@ -1,15 +1,26 @@
 #ifndef _SRC_COMMON_SHARED_PTR_
 #define _SRC_COMMON_SHARED_PTR_
 
+#include "src/common/pointer_counters.h"
+
 namespace iris {
 
 template <typename Type, void (*Retain)(Type*), void (*Release)(Type*)>
 class SharedPtr {
  public:
-  SharedPtr() : m_ptr(nullptr) {}
-  SharedPtr(SharedPtr&& other) : m_ptr(other.m_ptr) { other.m_ptr = nullptr; }
-  SharedPtr(const SharedPtr& other) : m_ptr(other.m_ptr) { Retain(m_ptr); }
-  ~SharedPtr() { Release(m_ptr); }
+  SharedPtr() : m_ptr(nullptr) { RegisterPointer(&m_ptr); }
+  SharedPtr(SharedPtr&& other) : m_ptr(other.m_ptr) {
+    other.m_ptr = nullptr;
+    RegisterPointer(&m_ptr);
+  }
+  SharedPtr(const SharedPtr& other) : m_ptr(other.m_ptr) {
+    Retain(m_ptr);
+    RegisterPointer(&m_ptr);
+  }
+  ~SharedPtr() {
+    UnregisterPointer(&m_ptr);
+    Release(m_ptr);
+  }
   SharedPtr& operator=(SharedPtr&& other) {
     if (this != &other) {
       Release(m_ptr);
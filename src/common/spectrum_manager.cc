@@ -27,8 +27,14 @@ ColorExtrapolator& SpectrumManager::GetColorExtrapolator() {
   return m_color_extrapolator;
 }
 
+std::unique_lock<std::recursive_mutex> SpectrumManager::Lock() {
+  return std::unique_lock<std::recursive_mutex>(*m_mutex);
+}
+
 absl::optional<Spectrum> SpectrumManager::AllocateInterpolatedSpectrum(
     const std::vector<float_t>& wavelengths_and_intensities) {
+  std::lock_guard<std::recursive_mutex> lock(*m_mutex);
+
   if (wavelengths_and_intensities.size() % 2 != 0) {
     return absl::nullopt;
   }
@@ -71,6 +77,8 @@ absl::optional<Spectrum> SpectrumManager::AllocateInterpolatedSpectrum(
 
 absl::optional<Spectrum> SpectrumManager::AllocateColorSpectrum(
     const COLOR3& color) {
+  std::lock_guard<std::recursive_mutex> lock(*m_mutex);
+
   Spectrum result;
   ISTATUS status = ColorExtrapolatorComputeSpectrum(
       m_color_extrapolator.get(), color, result.release_and_get_address());
@@ -92,6 +100,8 @@ absl::optional<Spectrum> SpectrumManager::AllocateColorSpectrum(
 
 absl::optional<Reflector> SpectrumManager::AllocateInterpolatedReflector(
     const std::vector<float_t>& wavelengths_and_reflectances) {
+  std::lock_guard<std::recursive_mutex> lock(*m_mutex);
+
   if (wavelengths_and_reflectances.size() % 2 != 0) {
     return absl::nullopt;
   }
@@ -134,6 +144,8 @@ absl::optional<Reflector> SpectrumManager::AllocateInterpolatedReflector(
 
 absl::optional<Reflector> SpectrumManager::AllocateColorReflector(
     const COLOR3& color) {
+  std::lock_guard<std::recursive_mutex> lock(*m_mutex);
+
   Reflector result;
   ISTATUS status = ColorExtrapolatorComputeReflector(
       m_color_extrapolator.get(), color, result.release_and_get_address());
@@ -155,6 +167,8 @@ absl::optional<Reflector> SpectrumManager::AllocateColorReflector(
 
 absl::optional<Reflector> SpectrumManager::AllocateUniformReflector(
     float_t reflectance) {
+  std::lock_guard<std::recursive_mutex> lock(*m_mutex);
+
   auto iter = m_uniform_reflector.find(reflectance);
   if (iter != m_uniform_reflector.end()) {
     return iter->second;
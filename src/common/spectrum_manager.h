@@ -2,6 +2,8 @@
 #define _SRC_COMMON_SPECTRUM_MANAGER_
 
 #include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include "absl/types/optional.h"
@@ -14,7 +16,8 @@ class SpectrumManager {
   SpectrumManager(ColorExtrapolator color_extrapolator,
                   COLOR_SPACE default_color_space)
       : m_color_extrapolator(std::move(color_extrapolator)),
-        m_default_color_space(default_color_space) {}
+        m_default_color_space(default_color_space),
+        m_mutex(new std::recursive_mutex) {}
 
   SpectrumManager(ColorExtrapolator color_extrapolator,
                   ColorIntegrator intermediate_color_integrator,
@@ -22,9 +25,13 @@ class SpectrumManager {
       : m_color_extrapolator(std::move(color_extrapolator)),
         m_intermediate_color_integrator(
             std::move(intermediate_color_integrator)),
-        m_default_color_space(default_color_space) {}
+        m_default_color_space(default_color_space),
+        m_mutex(new std::recursive_mutex) {}
 
+  // Not synchronized; callers that may run alongside parallel includes must
+  // hold the lock returned by Lock while using the extrapolator.
   ColorExtrapolator& GetColorExtrapolator();
+  std::unique_lock<std::recursive_mutex> Lock();
 
   absl::optional<Spectrum> AllocateInterpolatedSpectrum(
       const std::vector<float_t>& wavelengths_and_intensities);
@@ -43,6 +50,7 @@ class SpectrumManager {
   ColorExtrapolator m_color_extrapolator;
   ColorIntegrator m_intermediate_color_integrator;
   COLOR_SPACE m_default_color_space;
+  std::unique_ptr<std::recursive_mutex> m_mutex;
 
   std::map<std::vector<float_t>, Spectrum> m_interpolated_spectra;
   std::map<std::vector<float_t>, Reflector> m_interpolated_reflectors;
@@ -5,11 +5,15 @@
 #include "iris_physx_toolkit/perlin_textures.h"
 #include "iris_physx_toolkit/product_texture.h"
 #include "src/common/error.h"
+#include "src/common/run_statistics.h"
+#include "src/common/trace.h"
 
 namespace iris {
 
 const ReflectorTexture& TextureManager::AllocateConstantReflectorTexture(
     const Reflector& reflector) {
+  std::lock_guard<std::mutex> lock(*m_mutex);
+
   ReflectorTexture& result = m_constant_reflector_textures[reflector];
   if (!result.get()) {
     ISTATUS status = ConstantReflectorTextureAllocate(
@@ -22,6 +26,8 @@ const ReflectorTexture& TextureManager::AllocateConstantReflectorTexture(
 
 const FloatTexture& TextureManager::AllocateConstantFloatTexture(
     float_t value) {
+  std::lock_guard<std::mutex> lock(*m_mutex);
+
   FloatTexture& result = m_constant_float_textures[value];
   if (!result.get()) {
     ISTATUS status =
@@ -34,6 +40,8 @@ const FloatTexture& TextureManager::AllocateConstantFloatTexture(
 
 const ReflectorTexture& TextureManager::AllocateProductReflectorTexture(
     const ReflectorTexture& tex1, const ReflectorTexture& tex2) {
+  std::lock_guard<std::mutex> lock(*m_mutex);
+
   ReflectorTexture& result =
       m_product_reflector_textures[std::make_pair(tex1, tex2)];
   if (!result.get()) {
@@ -47,6 +55,8 @@ const ReflectorTexture& TextureManager::AllocateProductReflectorTexture(
 
 const FloatTexture& TextureManager::AllocateProductFloatTexture(
     const FloatTexture& tex1, const FloatTexture& tex2) {
+  std::lock_guard<std::mutex> lock(*m_mutex);
+
   FloatTexture& result = m_product_float_textures[std::make_pair(tex1, tex2)];
   if (!result.get()) {
     ISTATUS status = ProductFloatTextureAllocate(
@@ -57,34 +67,81 @@ const FloatTexture& TextureManager::AllocateProductFloatTexture(
   return result;
 }
 
-ReflectorTexture TextureManager::AllocateImageMapReflectorTexture(
-    ReflectorMipmap mipmap, float_t u_delta, float_t v_delta, float_t u_scale,
-    float_t v_scale) {
-  ReflectorTexture result;
+const ReflectorTexture* TextureManager::AllocatePngReflectorTexture(
+    const std::string& filename, TEXTURE_FILTERING_ALGORITHM algorithm,
+    float_t max_anisotropy, WRAP_MODE wrap_mode, float_t u_delta,
+    float_t v_delta, float_t u_scale, float_t v_scale,
+    SpectrumManager& spectrum_manager) {
+  std::lock_guard<std::mutex> lock(*m_mutex);
+
+  ReflectorTexture& result = m_image_reflector_textures[std::make_tuple(
+      filename, algorithm, max_anisotropy, wrap_mode, u_delta, v_delta,
+      u_scale, v_scale)];
+  if (result.get()) {
+    return &result;
+  }
+
+  TraceScope trace("load", "DecodeTexture", filename);
+  ReflectorMipmap mipmap;
+  {
+    auto extrapolator_lock = spectrum_manager.Lock();
+    ISTATUS status = PngReflectorMipmapAllocate(
+        filename.c_str(), algorithm, max_anisotropy, wrap_mode,
+        spectrum_manager.GetColorExtrapolator().get(),
+        mipmap.release_and_get_address());
+    if (status == ISTATUS_IO_ERROR) {
+      return nullptr;
+    }
+    SuccessOrOOM(status);
+  }
+
+  IncrementCounter(Counter::TEXTURES_DECODED);
+
   ISTATUS status =
       ImageReflectorTextureAllocate(mipmap.detach(), u_delta, -v_delta, u_scale,
                                     -v_scale, result.release_and_get_address());
   SuccessOrOOM(status);
 
-  return result;
+  return &result;
 }
 
-FloatTexture TextureManager::AllocateImageMapFloatTexture(FloatMipmap mipmap,
-                                                          float_t u_delta,
-                                                          float_t v_delta,
-                                                          float_t u_scale,
-                                                          float_t v_scale) {
-  FloatTexture result;
+const FloatTexture* TextureManager::AllocatePngFloatTexture(
+    const std::string& filename, TEXTURE_FILTERING_ALGORITHM algorithm,
+    float_t max_anisotropy, WRAP_MODE wrap_mode, float_t u_delta,
+    float_t v_delta, float_t u_scale, float_t v_scale) {
+  std::lock_guard<std::mutex> lock(*m_mutex);
+
+  FloatTexture& result = m_image_float_textures[std::make_tuple(
+      filename, algorithm, max_anisotropy, wrap_mode, u_delta, v_delta,
+      u_scale, v_scale)];
+  if (result.get()) {
+    return &result;
+  }
+
+  TraceScope trace("load", "DecodeTexture", filename);
+  FloatMipmap mipmap;
   ISTATUS status =
+      PngFloatMipmapAllocate(filename.c_str(), algorithm, max_anisotropy,
+                             wrap_mode, mipmap.release_and_get_address());
+  if (status == ISTATUS_IO_ERROR) {
+    return nullptr;
+  }
+  SuccessOrOOM(status);
+
+  IncrementCounter(Counter::TEXTURES_DECODED);
+
+  status =
       ImageFloatTextureAllocate(mipmap.detach(), u_delta, -v_delta, u_scale,
                                 -v_scale, result.release_and_get_address());
   SuccessOrOOM(status);
 
-  return result;
+  return &result;
 }
 
 const ReflectorTexture& TextureManager::AllocateWindyReflectorTexture(
     const Matrix& texture_to_world, const Reflector& reflector) {
+  std::lock_guard<std::mutex> lock(*m_mutex);
+
   ReflectorTexture& result =
       m_windy_reflector_textures[std::make_pair(texture_to_world, reflector)];
   if (!result.get()) {
@@ -99,6 +156,8 @@ const ReflectorTexture& TextureManager::AllocateWindyReflectorTexture(
 
 const FloatTexture& TextureManager::AllocateWindyFloatTexture(
     const Matrix& texture_to_world) {
+  std::lock_guard<std::mutex> lock(*m_mutex);
+
   FloatTexture& result = m_windy_float_textures[texture_to_world];
   if (!result.get()) {
     ISTATUS status = WindyFloatTextureAllocate(
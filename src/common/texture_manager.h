@@ -2,13 +2,22 @@
 #define _SRC_COMMON_TEXTURE_MANAGER_
 
 #include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
 
+#include "iris_physx_toolkit/png_mipmap.h"
 #include "src/common/pointer_types.h"
+#include "src/common/spectrum_manager.h"
 
 namespace iris {
 
+// Synchronized so that parallel includes can share a single set of textures
 class TextureManager {
  public:
+  TextureManager() : m_mutex(new std::mutex) {}
+
   const ReflectorTexture& AllocateConstantReflectorTexture(
       const Reflector& reflector);
   const FloatTexture& AllocateConstantFloatTexture(float_t value);
@@ -18,20 +27,30 @@ class TextureManager {
   const FloatTexture& AllocateProductFloatTexture(const FloatTexture& tex1,
                                                   const FloatTexture& tex2);
 
-  ReflectorTexture AllocateImageMapReflectorTexture(ReflectorMipmap mipmap,
-                                                    float_t u_delta,
-                                                    float_t v_delta,
-                                                    float_t u_scale,
-                                                    float_t v_scale);
-  FloatTexture AllocateImageMapFloatTexture(FloatMipmap mipmap, float_t u_delta,
-                                            float_t v_delta, float_t u_scale,
-                                            float_t v_scale);
+  // Image maps are cached by file and parameters so that an image referenced
+  // by several directives is decoded and mipmapped once. Returns nullptr if
+  // the file could not be read.
+  const ReflectorTexture* AllocatePngReflectorTexture(
+      const std::string& filename, TEXTURE_FILTERING_ALGORITHM algorithm,
+      float_t max_anisotropy, WRAP_MODE wrap_mode, float_t u_delta,
+      float_t v_delta, float_t u_scale, float_t v_scale,
+      SpectrumManager& spectrum_manager);
+  const FloatTexture* AllocatePngFloatTexture(
+      const std::string& filename, TEXTURE_FILTERING_ALGORITHM algorithm,
+      float_t max_anisotropy, WRAP_MODE wrap_mode, float_t u_delta,
+      float_t v_delta, float_t u_scale, float_t v_scale);
 
   const ReflectorTexture& AllocateWindyReflectorTexture(
       const Matrix& texture_to_world, const Reflector& reflector);
   const FloatTexture& AllocateWindyFloatTexture(const Matrix& texture_to_world);
 
  private:
+  typedef std::tuple<std::string, TEXTURE_FILTERING_ALGORITHM, float_t,
+                     WRAP_MODE, float_t, float_t, float_t, float_t>
+      ImageMapKey;
+
+  std::unique_ptr<std::mutex> m_mutex;
+
   std::map<Reflector, ReflectorTexture> m_constant_reflector_textures;
   std::map<float_t, FloatTexture> m_constant_float_textures;
 
@@ -40,6 +59,9 @@ class TextureManager {
   std::map<std::pair<FloatTexture, FloatTexture>, FloatTexture>
       m_product_float_textures;
 
+  std::map<ImageMapKey, ReflectorTexture> m_image_reflector_textures;
+  std::map<ImageMapKey, FloatTexture> m_image_float_textures;
+
   std::map<std::pair<Matrix, Reflector>, ReflectorTexture>
       m_windy_reflector_textures;
   std::map<Matrix, FloatTexture> m_windy_float_textures;
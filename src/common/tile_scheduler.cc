@@ -0,0 +1,256 @@
+#include "src/common/tile_scheduler.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "src/common/numa.h"
+
+namespace iris {
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+uint64_t MortonIndex(uint32_t x, uint32_t y) {
+  uint64_t result = 0;
+  for (uint32_t bit = 0; bit < 32; bit++) {
+    result |= (uint64_t)((x >> bit) & 1) << (2 * bit);
+    result |= (uint64_t)((y >> bit) & 1) << (2 * bit + 1);
+  }
+  return result;
+}
+
+// The distance along a Hilbert curve filling a size by size grid, where size
+// is a power of two.
+uint64_t HilbertIndex(uint32_t size, uint32_t x, uint32_t y) {
+  uint64_t result = 0;
+  for (uint32_t s = size / 2; s != 0; s /= 2) {
+    uint32_t rx = (x & s) ? 1 : 0;
+    uint32_t ry = (y & s) ? 1 : 0;
+    result += (uint64_t)s * s * ((3 * rx) ^ ry);
+
+    if (ry == 0) {
+      if (rx == 1) {
+        x = size - 1 - x;
+        y = size - 1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return result;
+}
+
+struct TileQueue {
+  std::mutex mutex;
+  std::deque<size_t> tiles;
+};
+
+bool PopFront(TileQueue& queue, size_t* tile) {
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tiles.empty()) {
+    return false;
+  }
+
+  *tile = queue.tiles.front();
+  queue.tiles.pop_front();
+  return true;
+}
+
+bool PopBack(TileQueue& queue, size_t* tile) {
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tiles.empty()) {
+    return false;
+  }
+
+  *tile = queue.tiles.back();
+  queue.tiles.pop_back();
+  return true;
+}
+
+// Tiles are never added once rendering starts, so a thread that finds every
+// queue empty is done.
+bool Steal(std::vector<std::unique_ptr<TileQueue>>& queues, size_t* tile) {
+  for (;;) {
+    TileQueue* victim = nullptr;
+    size_t victim_size = 0;
+    for (auto& queue : queues) {
+      std::lock_guard<std::mutex> lock(queue->mutex);
+      if (victim_size < queue->tiles.size()) {
+        victim = queue.get();
+        victim_size = queue->tiles.size();
+      }
+    }
+
+    if (!victim) {
+      return false;
+    }
+
+    if (PopBack(*victim, tile)) {
+      return true;
+    }
+  }
+}
+
+}  // namespace
+
+TileScheduler::TileScheduler(size_t num_threads, size_t tile_size,
+                             Order order, bool pin_threads)
+    : m_num_threads(num_threads),
+      m_tile_size(tile_size),
+      m_order(order),
+      m_num_numa_nodes(pin_threads ? NumNumaNodes() : 1),
+      m_statistics(num_threads, ThreadStatistics{Clock::duration::zero(), 0,
+                                                 0}),
+      m_run_time(Clock::duration::zero()) {
+  assert(num_threads != 0);
+  assert(tile_size != 0);
+}
+
+size_t TileScheduler::NumaNode(size_t thread_index) const {
+  return thread_index * m_num_numa_nodes / m_num_threads;
+}
+
+std::vector<TileScheduler::Tile> TileScheduler::Tiles(size_t num_columns,
+                                                      size_t num_rows) const {
+  size_t tile_columns = (num_columns + m_tile_size - 1) / m_tile_size;
+  size_t tile_rows = (num_rows + m_tile_size - 1) / m_tile_size;
+
+  uint32_t curve_size = 1;
+  while (curve_size < std::max(tile_columns, tile_rows)) {
+    curve_size *= 2;
+  }
+
+  std::vector<std::pair<uint64_t, Tile>> keyed_tiles;
+  for (size_t y = 0; y < tile_rows; y++) {
+    for (size_t x = 0; x < tile_columns; x++) {
+      Tile tile;
+      tile.column = x * m_tile_size;
+      tile.row = y * m_tile_size;
+      tile.num_columns = std::min(m_tile_size, num_columns - tile.column);
+      tile.num_rows = std::min(m_tile_size, num_rows - tile.row);
+      tile.index = y * tile_columns + x;
+
+      uint64_t key;
+      switch (m_order) {
+        case Order::SCANLINE:
+          key = tile.index;
+          break;
+        case Order::MORTON:
+          key = MortonIndex(static_cast<uint32_t>(x), static_cast<uint32_t>(y));
+          break;
+        case Order::HILBERT:
+          key = HilbertIndex(curve_size, static_cast<uint32_t>(x),
+                             static_cast<uint32_t>(y));
+          break;
+      }
+
+      keyed_tiles.emplace_back(key, tile);
+    }
+  }
+
+  std::sort(keyed_tiles.begin(), keyed_tiles.end(),
+            [](const std::pair<uint64_t, Tile>& left,
+               const std::pair<uint64_t, Tile>& right) {
+              return left.first < right.first;
+            });
+
+  std::vector<Tile> result;
+  result.reserve(keyed_tiles.size());
+  for (const auto& keyed_tile : keyed_tiles) {
+    result.push_back(keyed_tile.second);
+  }
+
+  return result;
+}
+
+void TileScheduler::Run(const std::vector<Tile>& tiles,
+                        const std::function<void(const Tile&)>& render_tile) {
+  auto start_time = Clock::now();
+
+  std::vector<std::unique_ptr<TileQueue>> queues;
+  for (size_t i = 0; i < m_num_threads; i++) {
+    size_t begin = tiles.size() * i / m_num_threads;
+    size_t end = tiles.size() * (i + 1) / m_num_threads;
+
+    queues.emplace_back(new TileQueue);
+    for (size_t tile = begin; tile < end; tile++) {
+      queues.back()->tiles.push_back(tile);
+    }
+  }
+
+  // Pinned workers all run on threads of their own so that the calling
+  // thread keeps its affinity.
+  bool pin_threads = m_num_numa_nodes != 1;
+
+  auto worker = [&](size_t thread_index) {
+    if (pin_threads) {
+      PinThreadToNumaNode(NumaNode(thread_index));
+    }
+
+    ThreadStatistics& statistics = m_statistics[thread_index];
+
+    size_t tile;
+    for (;;) {
+      bool stolen = false;
+      if (!PopFront(*queues[thread_index], &tile)) {
+        if (!Steal(queues, &tile)) {
+          break;
+        }
+        stolen = true;
+      }
+
+      auto tile_start_time = Clock::now();
+      render_tile(tiles[tile]);
+      statistics.busy_time += Clock::now() - tile_start_time;
+      statistics.tiles_rendered += 1;
+      statistics.tiles_stolen += stolen;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = pin_threads ? 0 : 1; i < m_num_threads; i++) {
+    threads.emplace_back(worker, i);
+  }
+
+  if (!pin_threads) {
+    worker(0);
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  m_run_time += Clock::now() - start_time;
+}
+
+void TileScheduler::WriteStatistics(std::ostream& output) const {
+  std::ios_base::fmtflags flags = output.flags();
+  std::streamsize precision = output.precision();
+
+  double run_seconds = std::chrono::duration<double>(m_run_time).count();
+  for (size_t i = 0; i < m_num_threads; i++) {
+    double busy_seconds =
+        std::chrono::duration<double>(m_statistics[i].busy_time).count();
+    double utilization =
+        (run_seconds != 0.0) ? busy_seconds / run_seconds : 0.0;
+    output << "Thread " << i;
+    if (m_num_numa_nodes != 1) {
+      output << " (node " << NumaNode(i) << ")";
+    }
+    output << ": " << std::fixed << std::setprecision(3)
+           << busy_seconds << "s busy (" << std::setprecision(1)
+           << 100.0 * utilization << "%), " << m_statistics[i].tiles_rendered
+           << " tiles, " << m_statistics[i].tiles_stolen << " stolen"
+           << std::endl;
+  }
+
+  output.flags(flags);
+  output.precision(precision);
+}
+
+}  // namespace iris
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef _SRC_COMMON_TILE_SCHEDULER_
+#define _SRC_COMMON_TILE_SCHEDULER_
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <vector>
+
+namespace iris {
+
+// Splits an image into square tiles and renders them on a pool of threads.
+//
+// The tiles are ordered along a space filling curve and the order is divided
+// into one contiguous run per thread so that each thread starts out working
+// on a compact region of the image. Threads take tiles from the front of
+// their own run and, once it is empty, steal from the back of the run with
+// the most tiles remaining, which is the part of it furthest from where its
+// owner is working.
+//
+// If pin_threads is set, the threads are divided into blocks of consecutive
+// indices that are each pinned to one NUMA node, so that the tiles of each
+// node also start out as a contiguous region of the image.
+class TileScheduler {
+ public:
+  enum class Order { SCANLINE, MORTON, HILBERT };
+
+  struct Tile {
+    size_t column;
+    size_t row;
+    size_t num_columns;
+    size_t num_rows;
+    // The position of the tile in row major order. Does not depend on the
+    // order in which tiles are scheduled.
+    size_t index;
+  };
+
+  struct ThreadStatistics {
+    std::chrono::steady_clock::duration busy_time;
+    size_t tiles_rendered;
+    size_t tiles_stolen;
+  };
+
+  TileScheduler(size_t num_threads, size_t tile_size, Order order,
+                bool pin_threads);
+
+  // Returns the NUMA node the thread with thread_index is pinned to, which is
+  // zero if threads are not pinned.
+  size_t NumaNode(size_t thread_index) const;
+
+  // Returns the tiles covering an image in the order they are scheduled.
+  std::vector<Tile> Tiles(size_t num_columns, size_t num_rows) const;
+
+  // Calls render_tile once for each tile, possibly concurrently. Returns once
+  // every tile has been rendered. The calling thread is never pinned.
+  void Run(const std::vector<Tile>& tiles,
+           const std::function<void(const Tile&)>& render_tile);
+
+  // Writes how long each thread spent rendering tiles, relative to the total
+  // time spent in Run, and how many of its tiles were stolen from other
+  // threads.
+  void WriteStatistics(std::ostream& output) const;
+
+ private:
+  size_t m_num_threads;
+  size_t m_tile_size;
+  Order m_order;
+  size_t m_num_numa_nodes;
+  std::vector<ThreadStatistics> m_statistics;
+  std::chrono::steady_clock::duration m_run_time;
+};
+
+}  // namespace iris
+
+#endif  // _SRC_COMMON_TILE_SCHEDULER_
\ No newline at end of file
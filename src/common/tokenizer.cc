@@ -1,6 +1,6 @@
 #include "src/common/tokenizer.h"
 
-#include <fstream>
+#include <cassert>
 #include <iostream>
 #include <vector>
 
@@ -9,6 +9,7 @@
 #include <unistd.h>
 
 #include "absl/strings/str_cat.h"
+#include "src/common/input_stream.h"
 
 namespace iris {
 namespace {
@@ -147,7 +148,7 @@ Tokenizer Tokenizer::CreateFromFile(absl::string_view file) {
 
 Tokenizer Tokenizer::CreateFromStream(std::istream& stream) {
   Tokenizer result;
-  result.m_streams.push(std::make_pair(std::ref(stream), nullptr));
+  result.m_streams.push(Input{&stream, nullptr, nullptr});
   return result;
 }
 
@@ -160,13 +161,29 @@ std::string Tokenizer::ResolvePath(absl::string_view file) const {
 }
 
 void Tokenizer::Include(absl::string_view file) {
-  auto buffer = absl::make_unique<std::ifstream>(ResolvePath(file));
-  if (buffer->fail()) {
+  std::string path = ResolvePath(file);
+
+  auto binary = BinarySceneReader::Open(path);
+  if (binary) {
+    m_streams.push(Input{nullptr, nullptr, std::move(binary)});
+    return;
+  }
+
+  auto buffer = OpenInputStream(path);
+  if (!buffer) {
     std::cerr << "ERROR: Error opening file: " << file << std::endl;
     exit(EXIT_FAILURE);
   }
 
-  m_streams.push(std::make_pair(std::ref(*buffer), std::move(buffer)));
+  std::istream* stream = buffer.get();
+  m_streams.push(Input{stream, std::move(buffer), nullptr});
+}
+
+Tokenizer Tokenizer::Fork(absl::string_view file) const {
+  Tokenizer result;
+  result.m_search_root = m_search_root;
+  result.Include(file);
+  return result;
 }
 
 absl::optional<absl::string_view> Tokenizer::Peek() {
@@ -183,7 +200,15 @@ absl::optional<absl::string_view> Tokenizer::Peek() {
       break;
     }
 
-    bool found = ParseNext(m_streams.top().first, m_peeked);
+    auto& top = m_streams.top();
+    if (top.binary && top.binary->NextIsArray()) {
+      m_peeked = "[";
+      m_peeked_valid = true;
+      m_peeked_array = true;
+      return m_peeked;
+    }
+
+    bool found = ReadToken(top, m_peeked);
     if (found) {
       m_peeked_valid = found;
       return m_peeked;
@@ -198,17 +223,22 @@ absl::optional<absl::string_view> Tokenizer::Peek() {
 absl::optional<absl::string_view> Tokenizer::Next() {
   for (;;) {
     bool next_valid;
-    if (m_peeked_valid.has_value()) {
+    if (m_peeked_valid.has_value() && !m_peeked_array) {
       std::swap(m_next, m_peeked);
       next_valid = *m_peeked_valid;
       m_peeked_valid = absl::nullopt;
     } else if (!m_streams.empty()) {
-      next_valid = ParseNext(m_streams.top().first, m_next);
+      m_peeked_valid = absl::nullopt;
+      m_peeked_array = false;
+      next_valid = ReadToken(m_streams.top(), m_next);
     } else {
       break;
     }
 
     if (next_valid) {
+      if (auto* recording = Recording()) {
+        recording->AddToken(m_next);
+      }
       return m_next;
     } else {
       m_streams.pop();
@@ -218,4 +248,80 @@ absl::optional<absl::string_view> Tokenizer::Next() {
   return absl::nullopt;
 }
 
+absl::optional<absl::Span<const float>> Tokenizer::NextFloats() {
+  if ((m_peeked_valid.has_value() && !m_peeked_array) || m_streams.empty() ||
+      !m_streams.top().binary) {
+    return absl::nullopt;
+  }
+
+  auto result = m_streams.top().binary->NextFloats();
+  if (result) {
+    m_peeked_valid = absl::nullopt;
+    m_peeked_array = false;
+    if (auto* recording = Recording()) {
+      recording->AddFloats(*result);
+    }
+  }
+
+  return result;
+}
+
+absl::optional<absl::Span<const int32_t>> Tokenizer::NextInts() {
+  if ((m_peeked_valid.has_value() && !m_peeked_array) || m_streams.empty() ||
+      !m_streams.top().binary) {
+    return absl::nullopt;
+  }
+
+  auto result = m_streams.top().binary->NextInts();
+  if (result) {
+    m_peeked_valid = absl::nullopt;
+    m_peeked_array = false;
+    if (auto* recording = Recording()) {
+      recording->AddInts(*result);
+    }
+  }
+
+  return result;
+}
+
+size_t Tokenizer::Checkpoint() {
+  m_recordings.emplace_back();
+  return m_recordings.size() - 1;
+}
+
+void Tokenizer::Rewind(size_t checkpoint) {
+  assert(checkpoint < m_recordings.size());
+  assert(!m_peeked_valid.has_value());
+
+  for (size_t i = m_recordings.size(); i-- > checkpoint;) {
+    m_streams.push(
+        Input{nullptr, nullptr, BinarySceneReader::Open(m_recordings[i])});
+  }
+
+  m_recordings.clear();
+}
+
+void Tokenizer::ReleaseCheckpoints() { m_recordings.clear(); }
+
+BinarySceneWriter* Tokenizer::Recording() {
+  if (m_recordings.empty()) {
+    return nullptr;
+  }
+  return &m_recordings.back();
+}
+
+bool Tokenizer::ReadToken(Input& input, std::string& output) {
+  if (!input.binary) {
+    return ParseNext(*input.stream, output);
+  }
+
+  absl::string_view token;
+  if (!input.binary->NextToken(&token)) {
+    return false;
+  }
+
+  output.assign(token.data(), token.size());
+  return true;
+}
+
 }  // namespace iris
\ No newline at end of file
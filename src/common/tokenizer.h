@@ -1,40 +1,70 @@
 #ifndef _SRC_COMMON_TOKENIZER_
 #define _SRC_COMMON_TOKENIZER_
 
+#include <deque>
 #include <istream>
 #include <memory>
 #include <stack>
 
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "src/common/binary_scene.h"
 
 namespace iris {
 
 class Tokenizer {
  public:
+  Tokenizer(Tokenizer&& other) = default;
+  Tokenizer& operator=(Tokenizer&& other) = default;
+
+  static Tokenizer CreateFromFile(absl::string_view file_path);
+
   std::string ResolvePath(absl::string_view file_path) const;
   void Include(absl::string_view file_path);
+  Tokenizer Fork(absl::string_view file_path) const;
 
   absl::optional<absl::string_view> Peek();
   absl::optional<absl::string_view> Next();
 
+  // Binary scenes store parameter values as arrays rather than as tokens.
+  // These return nullopt unless the next entry is an array of that type. While
+  // an array is next, Peek returns "[" and Next reports an error.
+  absl::optional<absl::Span<const float>> NextFloats();
+  absl::optional<absl::Span<const int32_t>> NextInts();
+
+  // Supports speculatively parsing ahead. While any checkpoint is held, the
+  // tokens and arrays returned are recorded. Rewind pushes everything returned
+  // since the checkpoint back onto the input and releases every checkpoint.
+  // Checkpoints must be taken between directives and Rewind must be called
+  // with nothing peeked.
+  size_t Checkpoint();
+  void Rewind(size_t checkpoint);
+  void ReleaseCheckpoints();
+
  private:
   Tokenizer() = default;
   Tokenizer(const Tokenizer&) = delete;
   Tokenizer& operator=(const Tokenizer&) = delete;
-  Tokenizer(Tokenizer&& other) = default;
-  Tokenizer& operator=(Tokenizer&& other) = default;
 
-  static Tokenizer CreateFromFile(absl::string_view file_path);
   static Tokenizer CreateFromStream(std::istream& stream);
 
-  std::stack<std::pair<std::reference_wrapper<std::istream>,
-                       std::unique_ptr<std::istream>>>
-      m_streams;
+  struct Input {
+    std::istream* stream;
+    std::unique_ptr<std::istream> owned_stream;
+    std::unique_ptr<BinarySceneReader> binary;
+  };
+
+  static bool ReadToken(Input& input, std::string& output);
+  BinarySceneWriter* Recording();
+
+  std::stack<Input> m_streams;
   std::string m_next;
   std::string m_peeked;
   absl::optional<bool> m_peeked_valid;
+  bool m_peeked_array = false;
   absl::optional<std::string> m_search_root;
+  std::deque<BinarySceneWriter> m_recordings;
 
   friend class Parser;
 };
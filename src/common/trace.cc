@@ -0,0 +1,168 @@
+#include "src/common/trace.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace iris {
+namespace {
+
+struct TraceEvent {
+  const char* category;
+  absl::string_view name;
+  std::string detail;
+  bool has_index;
+  uint64_t index;
+  int64_t start_ns;
+  int64_t duration_ns;
+};
+
+struct ThreadBuffer {
+  size_t tid;
+  std::deque<TraceEvent> events;
+};
+
+std::atomic<bool> g_enabled(false);
+std::chrono::steady_clock::time_point g_start;
+
+std::mutex g_buffers_mutex;
+std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+std::vector<ThreadBuffer*> g_free_buffers;
+
+// Returns the buffer of the thread to the free list when the thread exits.
+class ThreadSlot {
+ public:
+  ThreadSlot() {
+    std::lock_guard<std::mutex> lock(g_buffers_mutex);
+    if (g_free_buffers.empty()) {
+      g_buffers.emplace_back(new ThreadBuffer{g_buffers.size(), {}});
+      m_buffer = g_buffers.back().get();
+    } else {
+      m_buffer = g_free_buffers.back();
+      g_free_buffers.pop_back();
+    }
+  }
+
+  ~ThreadSlot() {
+    std::lock_guard<std::mutex> lock(g_buffers_mutex);
+    g_free_buffers.push_back(m_buffer);
+  }
+
+  ThreadBuffer& Buffer() { return *m_buffer; }
+
+ private:
+  ThreadBuffer* m_buffer;
+};
+
+// Claims a buffer for the calling thread the first time it opens a scope so
+// that threads still running keep distinct ids.
+ThreadBuffer& CurrentBuffer() {
+  static thread_local ThreadSlot slot;
+  return slot.Buffer();
+}
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - g_start)
+      .count();
+}
+
+void WriteEscaped(std::ostream& output, absl::string_view value) {
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      output << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[7];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      output << escaped;
+    } else {
+      output << c;
+    }
+  }
+}
+
+}  // namespace
+
+void EnableTracing() {
+  g_start = std::chrono::steady_clock::now();
+  g_enabled.store(true, std::memory_order_release);
+}
+
+bool TracingEnabled() { return g_enabled.load(std::memory_order_relaxed); }
+
+TraceScope::TraceScope(const char* category, absl::string_view name,
+                       absl::string_view detail)
+    : m_category(category),
+      m_name(name),
+      m_has_index(false),
+      m_index(0),
+      m_start_ns(-1) {
+  if (TracingEnabled()) {
+    CurrentBuffer();
+    m_detail = std::string(detail);
+    m_start_ns = NowNs();
+  }
+}
+
+TraceScope::TraceScope(const char* category, absl::string_view name,
+                       uint64_t index)
+    : m_category(category),
+      m_name(name),
+      m_has_index(true),
+      m_index(index),
+      m_start_ns(-1) {
+  if (TracingEnabled()) {
+    CurrentBuffer();
+    m_start_ns = NowNs();
+  }
+}
+
+TraceScope::~TraceScope() {
+  if (m_start_ns < 0) {
+    return;
+  }
+
+  CurrentBuffer().events.push_back({m_category, m_name, std::move(m_detail),
+                                  m_has_index, m_index, m_start_ns,
+                                  NowNs() - m_start_ns});
+}
+
+bool WriteTrace(const std::string& path) {
+  std::ofstream output(path);
+  output << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+
+  bool first = true;
+  std::lock_guard<std::mutex> lock(g_buffers_mutex);
+  for (const auto& buffer : g_buffers) {
+    for (const auto& event : buffer->events) {
+      output << (first ? "" : ",\n") << "{\"name\":\"";
+      WriteEscaped(output, event.name);
+      output << "\",\"cat\":\"" << event.category
+             << "\",\"ph\":\"X\",\"ts\":" << event.start_ns / 1000.0
+             << ",\"dur\":" << event.duration_ns / 1000.0
+             << ",\"pid\":" << getpid() << ",\"tid\":" << buffer->tid;
+      if (event.has_index) {
+        output << ",\"args\":{\"index\":" << event.index << "}";
+      } else if (!event.detail.empty()) {
+        output << ",\"args\":{\"detail\":\"";
+        WriteEscaped(output, event.detail);
+        output << "\"}";
+      }
+      output << "}";
+      first = false;
+    }
+  }
+
+  output << "],\"displayTimeUnit\":\"ms\"}" << std::endl;
+  return static_cast<bool>(output);
+}
+
+}  // namespace iris
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef _SRC_COMMON_TRACE_
+#define _SRC_COMMON_TRACE_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/strings/string_view.h"
+
+namespace iris {
+
+// Scoped events for a timeline of the run, written in the Chrome trace event
+// format that can be loaded into chrome://tracing or Perfetto.
+//
+// Each thread appends its events to a buffer of its own without locking.
+// Buffers outlive their threads and are handed on to threads started later,
+// so that threads started and joined repeatedly, such as those that render
+// the tiles of each pass, share a small number of rows of the timeline.
+//
+// Events are only recorded once tracing is enabled.
+void EnableTracing();
+bool TracingEnabled();
+
+// Writes the events recorded so far to path. Must not be called while
+// events are being recorded on other threads. Returns false if the file
+// could not be written.
+bool WriteTrace(const std::string& path);
+
+// Records an event spanning its lifetime. The category and name must outlive
+// the run. Either a string describing the event, such as the name of the
+// file it loads, or an index, such as that of the tile it renders, may be
+// attached to it.
+class TraceScope {
+ public:
+  TraceScope(const char* category, absl::string_view name,
+             absl::string_view detail = absl::string_view());
+  TraceScope(const char* category, absl::string_view name, uint64_t index);
+  ~TraceScope();
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+ private:
+  const char* m_category;
+  absl::string_view m_name;
+  std::string m_detail;
+  bool m_has_index;
+  uint64_t m_index;
+  int64_t m_start_ns;
+};
+
+}  // namespace iris
+
+#endif  // _SRC_COMMON_TRACE_
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef _SRC_COMMON_UNIQUE_PTR_
 #define _SRC_COMMON_UNIQUE_PTR_
 
+#include "src/common/pointer_counters.h"
+
 namespace iris {
 
 template <typename Type, void (*Release)(Type*)>
@@ -9,9 +11,15 @@ class UniquePtr {
   UniquePtr(const UniquePtr& other) = delete;
   UniquePtr& operator=(const UniquePtr& other) = delete;
 
-  UniquePtr() : m_ptr(nullptr) {}
-  UniquePtr(UniquePtr&& other) : m_ptr(other.m_ptr) { other.m_ptr = nullptr; }
-  ~UniquePtr() { Release(m_ptr); }
+  UniquePtr() : m_ptr(nullptr) { RegisterPointer(&m_ptr); }
+  UniquePtr(UniquePtr&& other) : m_ptr(other.m_ptr) {
+    other.m_ptr = nullptr;
+    RegisterPointer(&m_ptr);
+  }
+  ~UniquePtr() {
+    UnregisterPointer(&m_ptr);
+    Release(m_ptr);
+  }
   UniquePtr& operator=(UniquePtr&& other) {
     if (this != &other) {
       m_ptr = other.m_ptr;
@@ -0,0 +1,273 @@
+#include "src/common/worker_pool.h"
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+
+#include "absl/types/optional.h"
+
+namespace iris {
+namespace {
+
+struct Worker {
+  pid_t pid;
+  int socket;
+  absl::optional<size_t> region;
+};
+
+bool ReadAll(int socket, void* data, size_t size) {
+  char* bytes = static_cast<char*>(data);
+  while (size != 0) {
+    ssize_t result = recv(socket, bytes, size, 0);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+
+    if (result <= 0) {
+      return false;
+    }
+
+    bytes += result;
+    size -= result;
+  }
+
+  return true;
+}
+
+// MSG_NOSIGNAL keeps a write to a worker that has died from raising SIGPIPE
+// in the coordinator.
+bool WriteAll(int socket, const void* data, size_t size) {
+  const char* bytes = static_cast<const char*>(data);
+  while (size != 0) {
+    ssize_t result = send(socket, bytes, size, MSG_NOSIGNAL);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+
+    if (result <= 0) {
+      return false;
+    }
+
+    bytes += result;
+    size -= result;
+  }
+
+  return true;
+}
+
+bool SameBounds(const PixelBounds& left, const PixelBounds& right) {
+  return left.min_column == right.min_column &&
+         left.max_column == right.max_column &&
+         left.min_row == right.min_row && left.max_row == right.max_row;
+}
+
+// Workers exit with _exit so that they do not run the destructors of the
+// state they share with the coordinator or flush its buffered output.
+[[noreturn]] void WorkerMain(int socket,
+                             const WorkerPool::RenderRegion& render_region) {
+  std::vector<COLOR3> pixels;
+  PixelBounds region;
+  while (ReadAll(socket, &region, sizeof(region))) {
+    pixels.clear();
+    render_region(region, &pixels);
+    assert(pixels.size() == region.NumColumns() * region.NumRows());
+
+    if (!WriteAll(socket, &region, sizeof(region)) ||
+        !WriteAll(socket, pixels.data(), pixels.size() * sizeof(COLOR3))) {
+      break;
+    }
+  }
+
+  _exit(EXIT_SUCCESS);
+}
+
+Worker Spawn(const std::vector<Worker>& workers,
+             const WorkerPool::RenderRegion& render_region) {
+  int sockets[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) != 0) {
+    std::cerr << "ERROR: Could not create worker socket" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::cout.flush();
+  std::cerr.flush();
+  fflush(nullptr);
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    std::cerr << "ERROR: Could not start worker process" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  // The coordinator's ends of the sockets of the other workers are closed so
+  // that each worker sees end of file once the coordinator closes its socket.
+  if (pid == 0) {
+    close(sockets[0]);
+    for (const auto& worker : workers) {
+      if (worker.socket >= 0) {
+        close(worker.socket);
+      }
+    }
+
+    WorkerMain(sockets[1], render_region);
+  }
+
+  close(sockets[1]);
+  return Worker{pid, sockets[0], absl::nullopt};
+}
+
+void Stop(Worker& worker) {
+  close(worker.socket);
+  worker.socket = -1;
+
+  kill(worker.pid, SIGKILL);
+  waitpid(worker.pid, nullptr, 0);
+}
+
+}  // namespace
+
+WorkerPool::WorkerPool(size_t num_workers)
+    : m_num_workers(num_workers),
+      m_statistics(num_workers, WorkerStatistics{0, 0}) {
+  assert(num_workers != 0);
+}
+
+void WorkerPool::Run(const std::vector<PixelBounds>& regions,
+                     const RenderRegion& render_region,
+                     const ReceiveRegion& receive_region) {
+  std::vector<Worker> workers;
+  for (size_t i = 0; i < m_num_workers; i++) {
+    workers.push_back(Spawn(workers, render_region));
+  }
+
+  std::deque<size_t> pending;
+  for (size_t i = 0; i < regions.size(); i++) {
+    pending.push_back(i);
+  }
+
+  std::vector<size_t> attempts(regions.size(), 0);
+
+  auto restart = [&](size_t index) {
+    Worker& worker = workers[index];
+    Stop(worker);
+
+    if (worker.region) {
+      size_t region = *worker.region;
+      attempts[region] += 1;
+      if (attempts[region] == kMaxRegionAttempts) {
+        std::cerr << "ERROR: Rendering pixels [" << regions[region].min_column
+                  << ", " << regions[region].max_column << ") x ["
+                  << regions[region].min_row << ", "
+                  << regions[region].max_row << ") failed in "
+                  << kMaxRegionAttempts << " workers" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+
+      pending.push_front(region);
+    }
+
+    std::cerr << "WARNING: Worker " << index << " exited unexpectedly and "
+              << "was restarted" << std::endl;
+
+    worker = Spawn(workers, render_region);
+    m_statistics[index].restarts += 1;
+  };
+
+  auto dispatch = [&](size_t index) {
+    while (!pending.empty()) {
+      Worker& worker = workers[index];
+      worker.region = pending.front();
+      pending.pop_front();
+
+      if (WriteAll(worker.socket, &regions[*worker.region],
+                   sizeof(PixelBounds))) {
+        return;
+      }
+
+      restart(index);
+    }
+
+    workers[index].region = absl::nullopt;
+  };
+
+  for (size_t i = 0; i < m_num_workers; i++) {
+    dispatch(i);
+  }
+
+  std::vector<COLOR3> pixels;
+  for (size_t num_received = 0; num_received < regions.size();) {
+    std::vector<pollfd> fds;
+    std::vector<size_t> fd_workers;
+    for (size_t i = 0; i < m_num_workers; i++) {
+      if (workers[i].region) {
+        fds.push_back(pollfd{workers[i].socket, POLLIN, 0});
+        fd_workers.push_back(i);
+      }
+    }
+
+    assert(!fds.empty());
+    if (poll(fds.data(), fds.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+
+      std::cerr << "ERROR: Could not wait for workers" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < fds.size(); i++) {
+      if (fds[i].revents == 0) {
+        continue;
+      }
+
+      size_t index = fd_workers[i];
+      const PixelBounds& region = regions[*workers[index].region];
+
+      PixelBounds received;
+      pixels.resize(region.NumColumns() * region.NumRows());
+      if (!ReadAll(workers[index].socket, &received, sizeof(received)) ||
+          !SameBounds(received, region) ||
+          !ReadAll(workers[index].socket, pixels.data(),
+                   pixels.size() * sizeof(COLOR3))) {
+        restart(index);
+        dispatch(index);
+        continue;
+      }
+
+      receive_region(region, pixels);
+      m_statistics[index].regions_rendered += 1;
+      num_received += 1;
+
+      dispatch(index);
+    }
+  }
+
+  for (auto& worker : workers) {
+    close(worker.socket);
+    worker.socket = -1;
+  }
+
+  for (const auto& worker : workers) {
+    waitpid(worker.pid, nullptr, 0);
+  }
+}
+
+void WorkerPool::WriteStatistics(std::ostream& output) const {
+  for (size_t i = 0; i < m_num_workers; i++) {
+    output << "Worker " << i << ": " << m_statistics[i].regions_rendered
+           << " regions, " << m_statistics[i].restarts << " restarts"
+           << std::endl;
+  }
+}
+
+}  // namespace iris
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef _SRC_COMMON_WORKER_POOL_
+#define _SRC_COMMON_WORKER_POOL_
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <vector>
+
+#include "iris_camera/iris_camera.h"
+#include "src/common/pixel_bounds.h"
+
+namespace iris {
+
+// Renders the regions of an image in worker processes.
+//
+// The workers are forked from the calling process once the scene has been
+// parsed, so each one starts out with its own copy of the scene without
+// parsing it again. Regions are sent to the workers over local sockets one at
+// a time and the rendered pixels are sent back to the coordinator, which is
+// the calling process.
+//
+// A worker that exits or crashes is replaced by a new one forked from the
+// coordinator and the region it was rendering is sent out again. Rendering
+// fails if any one region takes down kMaxRegionAttempts workers.
+class WorkerPool {
+ public:
+  // Renders region into pixels, which are in row major order. Called in the
+  // worker processes.
+  typedef std::function<void(const PixelBounds& region,
+                             std::vector<COLOR3>* pixels)>
+      RenderRegion;
+
+  // Receives the pixels of a region once it has been rendered. Called in the
+  // coordinator.
+  typedef std::function<void(const PixelBounds& region,
+                             const std::vector<COLOR3>& pixels)>
+      ReceiveRegion;
+
+  static constexpr size_t kMaxRegionAttempts = 3;
+
+  explicit WorkerPool(size_t num_workers);
+
+  // Forks the workers, renders every region, and waits for the workers to
+  // exit. The calling process must not have any other threads running.
+  void Run(const std::vector<PixelBounds>& regions,
+           const RenderRegion& render_region,
+           const ReceiveRegion& receive_region);
+
+  // Writes how many regions each worker rendered and how many times it was
+  // replaced.
+  void WriteStatistics(std::ostream& output) const;
+
+ private:
+  struct WorkerStatistics {
+    size_t regions_rendered;
+    size_t restarts;
+  };
+
+  size_t m_num_workers;
+  std::vector<WorkerStatistics> m_statistics;
+};
+
+}  // namespace iris
+
+#endif  // _SRC_COMMON_WORKER_POOL_
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "src/directives/directive_id.h"
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+namespace iris {
+namespace {
+
+// Must be in the same order as DirectiveId
+constexpr absl::string_view kDirectiveNames[] = {
+    "Accelerator",
+    "ActiveTransform",
+    "AlwaysComputeReflectiveColor",
+    "AreaLightSource",
+    "AttributeBegin",
+    "AttributeEnd",
+    "Camera",
+    "ColorExtrapolator",
+    "ColorIntegrator",
+    "ConcatTransform",
+    "CoordinateSystem",
+    "CoordSysTransform",
+    "Film",
+    "Identity",
+    "Include",
+    "Integrator",
+    "LightSource",
+    "LookAt",
+    "MakeNamedMaterial",
+    "MakeNamedMedium",
+    "Material",
+    "MediumInterface",
+    "NamedMaterial",
+    "ObjectBegin",
+    "ObjectEnd",
+    "ObjectInstance",
+    "PixelFilter",
+    "Random",
+    "ReverseOrientation",
+    "RgbColorSpace",
+    "Rotate",
+    "Sampler",
+    "Scale",
+    "Shape",
+    "SpectralRepresentation",
+    "Texture",
+    "Transform",
+    "TransformBegin",
+    "TransformEnd",
+    "TransformTimes",
+    "Translate",
+    "WorldBegin",
+    "WorldEnd",
+};
+
+constexpr size_t kNumDirectives =
+    sizeof(kDirectiveNames) / sizeof(kDirectiveNames[0]);
+static_assert(kNumDirectives == static_cast<size_t>(DirectiveId::Unknown));
+
+// Multiplicative hash of the length and the first and last two characters
+// of a token with a multiplier chosen so that no two directive names share a
+// slot. If a directive is added and the static_assert below fails, search for
+// a new multiplier.
+constexpr uint32_t kMultiplier = UINT32_C(0x23B26AD1);
+constexpr size_t kTableBits = 7;
+constexpr uint8_t kEmptySlot = UINT8_MAX;
+
+constexpr size_t Slot(absl::string_view token) {
+  if (token.size() < 2) {
+    return 0;
+  }
+
+  uint32_t length = static_cast<uint8_t>(token.size());
+  uint32_t first = static_cast<uint8_t>(token[0]);
+  uint32_t last = static_cast<uint8_t>(token[token.size() - 1]);
+  uint32_t second_to_last = static_cast<uint8_t>(token[token.size() - 2]);
+  uint32_t key = length | first << 8 | last << 16 | second_to_last << 24;
+  return static_cast<uint32_t>(key * kMultiplier) >> (32 - kTableBits);
+}
+
+struct DirectiveTable {
+  std::array<uint8_t, 1 << kTableBits> slots;
+  bool perfect;
+};
+
+constexpr DirectiveTable BuildDirectiveTable() {
+  DirectiveTable result = {};
+  for (auto& slot : result.slots) {
+    slot = kEmptySlot;
+  }
+
+  result.perfect = true;
+  for (size_t i = 0; i < kNumDirectives; i++) {
+    size_t slot = Slot(kDirectiveNames[i]);
+    if (result.slots[slot] != kEmptySlot) {
+      result.perfect = false;
+    }
+    result.slots[slot] = static_cast<uint8_t>(i);
+  }
+
+  return result;
+}
+
+constexpr DirectiveTable kDirectiveTable = BuildDirectiveTable();
+static_assert(kDirectiveTable.perfect);
+
+}  // namespace
+
+DirectiveId LookupDirectiveId(absl::string_view token) {
+  uint8_t index = kDirectiveTable.slots[Slot(token)];
+  if (index == kEmptySlot || kDirectiveNames[index] != token) {
+    return DirectiveId::Unknown;
+  }
+
+  return static_cast<DirectiveId>(index);
+}
+
+absl::string_view DirectiveName(DirectiveId id) {
+  assert(id != DirectiveId::Unknown);
+  return kDirectiveNames[static_cast<size_t>(id)];
+}
+
+}  // namespace iris
\ No newline at end of file
@@ -0,0 +1,62 @@
+#ifndef _SRC_DIRECTIVES_DIRECTIVE_ID_
+#define _SRC_DIRECTIVES_DIRECTIVE_ID_
+
+#include "absl/strings/string_view.h"
+
+namespace iris {
+
+enum class DirectiveId {
+  Accelerator,
+  ActiveTransform,
+  AlwaysComputeReflectiveColor,
+  AreaLightSource,
+  AttributeBegin,
+  AttributeEnd,
+  Camera,
+  ColorExtrapolator,
+  ColorIntegrator,
+  ConcatTransform,
+  CoordinateSystem,
+  CoordSysTransform,
+  Film,
+  Identity,
+  Include,
+  Integrator,
+  LightSource,
+  LookAt,
+  MakeNamedMaterial,
+  MakeNamedMedium,
+  Material,
+  MediumInterface,
+  NamedMaterial,
+  ObjectBegin,
+  ObjectEnd,
+  ObjectInstance,
+  PixelFilter,
+  Random,
+  ReverseOrientation,
+  RgbColorSpace,
+  Rotate,
+  Sampler,
+  Scale,
+  Shape,
+  SpectralRepresentation,
+  Texture,
+  Transform,
+  TransformBegin,
+  TransformEnd,
+  TransformTimes,
+  Translate,
+  WorldBegin,
+  WorldEnd,
+  Unknown,
+};
+
+// Maps a token to its directive using a perfect hash table generated at
+// compile time, so each lookup costs one hash and one string comparison.
+DirectiveId LookupDirectiveId(absl::string_view token);
+absl::string_view DirectiveName(DirectiveId id);
+
+}  // namespace iris
+
+#endif  // _SRC_DIRECTIVES_DIRECTIVE_ID_
\ No newline at end of file
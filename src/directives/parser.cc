@@ -1,10 +1,17 @@
 #include "src/directives/parser.h"
 
+#include <bitset>
+#include <cctype>
+#include <deque>
+#include <future>
 #include <iostream>
 #include <set>
 #include <stack>
+#include <thread>
 #include <vector>
 
+#include "absl/flags/flag.h"
+#include "absl/memory/memory.h"
 #include "absl/strings/str_join.h"
 #include "iris_physx_toolkit/color_spectra.h"
 #include "iris_physx_toolkit/reflective_color_integrator.h"
@@ -17,8 +24,11 @@
 #include "src/common/named_texture_manager.h"
 #include "src/common/normal_map_manager.h"
 #include "src/common/quoted_string.h"
+#include "src/common/run_statistics.h"
 #include "src/common/spectrum_manager.h"
+#include "src/common/trace.h"
 #include "src/common/texture_manager.h"
+#include "src/directives/directive_id.h"
 #include "src/directives/named_material_manager.h"
 #include "src/directives/pbrt_workaround.h"
 #include "src/directives/rgb_color_space_parser.h"
@@ -33,14 +43,16 @@
 #include "src/shapes/parser.h"
 #include "src/textures/parser.h"
 
+ABSL_FLAG(bool, parallel_includes, false,
+          "If true, Include directives after WorldBegin whose file contains "
+          "only a single self-contained AttributeBegin/AttributeEnd block are "
+          "parsed on worker threads. Files that may modify state outside of "
+          "their attribute block are always parsed serially.");
+
 namespace iris {
 namespace {
 
-bool TryParseInclude(absl::string_view directive, Tokenizer& tokenizer) {
-  if (directive != "Include") {
-    return false;
-  }
-
+std::string ParseIncludePath(Tokenizer& tokenizer) {
   auto token = tokenizer.Next();
   if (!token) {
     std::cerr << "ERROR: Include requires 1 parameter" << std::endl;
@@ -54,10 +66,87 @@ bool TryParseInclude(absl::string_view directive, Tokenizer& tokenizer) {
     exit(EXIT_FAILURE);
   }
 
-  std::string as_string(unquoted->data(), unquoted->size());
-  tokenizer.Include(as_string);
+  return std::string(*unquoted);
+}
 
-  return true;
+// Skips over the value arrays stored in binary scenes
+absl::optional<absl::string_view> NextSkippingArrays(Tokenizer& tokenizer) {
+  while (tokenizer.NextFloats() || tokenizer.NextInts()) {
+    // Do Nothing
+  }
+  return tokenizer.Next();
+}
+
+// Returns true if the remaining contents of the tokenizer consist of a single
+// AttributeBegin/AttributeEnd block containing only directives whose effects do
+// not outlive the block. The check is conservative; any unrecognized keyword
+// causes the block to be rejected.
+bool IsSelfContainedAttributeBlock(Tokenizer& tokenizer) {
+  auto token = tokenizer.Next();
+  if (!token || *token != "AttributeBegin") {
+    return false;
+  }
+
+  size_t depth = 1;
+  for (token = NextSkippingArrays(tokenizer); token;
+       token = NextSkippingArrays(tokenizer)) {
+    if (depth == 0) {
+      return false;
+    }
+
+    if (!std::isalpha(static_cast<unsigned char>(token->front()))) {
+      continue;
+    }
+
+    switch (LookupDirectiveId(*token)) {
+      case DirectiveId::AttributeBegin:
+        depth += 1;
+        break;
+      case DirectiveId::AttributeEnd:
+        depth -= 1;
+        break;
+      case DirectiveId::ActiveTransform:
+        tokenizer.Next();
+        break;
+      case DirectiveId::AreaLightSource:
+      case DirectiveId::ConcatTransform:
+      case DirectiveId::CoordSysTransform:
+      case DirectiveId::Identity:
+      case DirectiveId::LookAt:
+      case DirectiveId::MakeNamedMaterial:
+      case DirectiveId::Material:
+      case DirectiveId::NamedMaterial:
+      case DirectiveId::ReverseOrientation:
+      case DirectiveId::Rotate:
+      case DirectiveId::Scale:
+      case DirectiveId::Shape:
+      case DirectiveId::Texture:
+      case DirectiveId::Transform:
+      case DirectiveId::TransformBegin:
+      case DirectiveId::TransformEnd:
+      case DirectiveId::Translate:
+        break;
+      default:
+        return false;
+    }
+  }
+
+  return depth == 0;
+}
+
+// Returns true if the directive adds to the scene and so must wait until the
+// in flight parallel includes have been appended.
+bool AddsToScene(DirectiveId id) {
+  switch (id) {
+    case DirectiveId::LightSource:
+    case DirectiveId::ObjectBegin:
+    case DirectiveId::ObjectEnd:
+    case DirectiveId::ObjectInstance:
+    case DirectiveId::Shape:
+      return true;
+    default:
+      return false;
+  }
 }
 
 class MatrixManager {
@@ -70,7 +159,7 @@ class MatrixManager {
     ALL_TRANSFORMS = 3,
   };
 
-  bool Parse(absl::string_view token, Tokenizer& tokenizer);
+  bool Parse(DirectiveId id, Tokenizer& tokenizer);
 
   void Reset();
   Active GetActive() const { return m_active; }
@@ -82,8 +171,7 @@ class MatrixManager {
   }
 
  private:
-  bool ParseDirective(absl::string_view name, absl::string_view token,
-                      Tokenizer& tokenizer,
+  void ParseDirective(DirectiveId id, Tokenizer& tokenizer,
                       void (MatrixManager::*implementation)(Directive&));
 
   void Identity(Directive& directive);
@@ -174,67 +262,48 @@ void MatrixManager::Reset() {
   Set(Matrix());
 }
 
-bool MatrixManager::Parse(absl::string_view token, Tokenizer& tokenizer) {
-  if (ParseDirective("Identity", token, tokenizer, &MatrixManager::Identity)) {
-    return true;
-  }
-
-  if (ParseDirective("Translate", token, tokenizer,
-                     &MatrixManager::Translate)) {
-    return true;
-  }
-
-  if (ParseDirective("Scale", token, tokenizer, &MatrixManager::Scale)) {
-    return true;
-  }
-
-  if (ParseDirective("Rotate", token, tokenizer, &MatrixManager::Rotate)) {
-    return true;
-  }
-
-  if (ParseDirective("LookAt", token, tokenizer, &MatrixManager::LookAt)) {
-    return true;
-  }
-
-  if (ParseDirective("CoordinateSystem", token, tokenizer,
-                     &MatrixManager::CoordinateSystem)) {
-    return true;
-  }
-
-  if (ParseDirective("CoordSysTransform", token, tokenizer,
-                     &MatrixManager::CoordSysTransform)) {
-    return true;
-  }
-
-  if (ParseDirective("Transform", token, tokenizer,
-                     &MatrixManager::Transform)) {
-    return true;
-  }
-
-  if (ParseDirective("ConcatTransform", token, tokenizer,
-                     &MatrixManager::ConcatTransform)) {
-    return true;
-  }
-
-  if (ParseDirective("ActiveTransform", token, tokenizer,
-                     &MatrixManager::ActiveTransform)) {
-    return true;
+bool MatrixManager::Parse(DirectiveId id, Tokenizer& tokenizer) {
+  switch (id) {
+    case DirectiveId::Identity:
+      ParseDirective(id, tokenizer, &MatrixManager::Identity);
+      return true;
+    case DirectiveId::Translate:
+      ParseDirective(id, tokenizer, &MatrixManager::Translate);
+      return true;
+    case DirectiveId::Scale:
+      ParseDirective(id, tokenizer, &MatrixManager::Scale);
+      return true;
+    case DirectiveId::Rotate:
+      ParseDirective(id, tokenizer, &MatrixManager::Rotate);
+      return true;
+    case DirectiveId::LookAt:
+      ParseDirective(id, tokenizer, &MatrixManager::LookAt);
+      return true;
+    case DirectiveId::CoordinateSystem:
+      ParseDirective(id, tokenizer, &MatrixManager::CoordinateSystem);
+      return true;
+    case DirectiveId::CoordSysTransform:
+      ParseDirective(id, tokenizer, &MatrixManager::CoordSysTransform);
+      return true;
+    case DirectiveId::Transform:
+      ParseDirective(id, tokenizer, &MatrixManager::Transform);
+      return true;
+    case DirectiveId::ConcatTransform:
+      ParseDirective(id, tokenizer, &MatrixManager::ConcatTransform);
+      return true;
+    case DirectiveId::ActiveTransform:
+      ParseDirective(id, tokenizer, &MatrixManager::ActiveTransform);
+      return true;
+    default:
+      return false;
   }
-
-  return false;
 }
 
-bool MatrixManager::ParseDirective(
-    absl::string_view name, absl::string_view token, Tokenizer& tokenizer,
+void MatrixManager::ParseDirective(
+    DirectiveId id, Tokenizer& tokenizer,
     void (MatrixManager::*implementation)(Directive&)) {
-  if (token != name) {
-    return false;
-  }
-
-  Directive directive(name, tokenizer);
+  Directive directive(DirectiveName(id), tokenizer);
   (this->*implementation)(directive);
-
-  return true;
 }
 
 void MatrixManager::Identity(Directive& directive) {
@@ -507,10 +576,11 @@ void MatrixManager::Set(Matrix m) {
   }
 }
 
-typedef std::tuple<Camera, Matrix, Sampler, Framebuffer, Integrator,
-                   LightSamplerFactory, ColorExtrapolator, ColorIntegrator,
-                   OutputWriter, Random, SpectralRepresentation, COLOR_SPACE,
-                   bool>
+typedef std::tuple<Camera, Matrix, SamplerResult, Framebuffer,
+                   IntegratorFactory, LightSamplerFactory, ColorExtrapolator,
+                   ColorIntegrator, OutputWriter, RandomResult,
+                   SpectralRepresentation, COLOR_SPACE, bool,
+                   absl::optional<PixelBounds>, std::vector<Aov>>
     GlobalConfig;
 
 class GlobalParser {
@@ -522,7 +592,7 @@ class GlobalParser {
   GlobalParser(Tokenizer& tokenizer, MatrixManager& matrix_manager)
       : m_tokenizer(tokenizer), m_matrix_manager(matrix_manager) {}
 
-  bool ParseDirectiveOnce(absl::string_view name, absl::string_view token,
+  void ParseDirectiveOnce(DirectiveId id,
                           void (GlobalParser::*implementation)(Directive&));
   void Accelerator(Directive& directive);
   void AlwaysComputeReflectiveColor(Directive& directive);
@@ -542,7 +612,7 @@ class GlobalParser {
   Tokenizer& m_tokenizer;
   MatrixManager& m_matrix_manager;
 
-  std::set<absl::string_view> m_called;
+  std::bitset<static_cast<size_t>(DirectiveId::Unknown)> m_called;
   absl::optional<bool> m_always_compute_reflective_color;
   absl::optional<CameraFactory> m_camera_factory;
   absl::optional<iris::ColorExtrapolator> m_color_extrapolator;
@@ -550,29 +620,26 @@ class GlobalParser {
   absl::optional<FilmResult> m_film_result;
   absl::optional<IntegratorResult> m_integrator_result;
   absl::optional<COLOR_SPACE> m_rgb_color_space;
-  absl::optional<iris::Random> m_random;
-  absl::optional<iris::Sampler> m_sampler;
+  absl::optional<RandomResult> m_random;
+  absl::optional<SamplerResult> m_sampler;
   absl::optional<iris::SpectralRepresentation> m_spectral_representation;
   Matrix m_camera_to_world;
 };
 
-bool GlobalParser::ParseDirectiveOnce(
-    absl::string_view name, absl::string_view token,
-    void (GlobalParser::*implementation)(Directive&)) {
-  if (token != name) {
-    return false;
-  }
-
-  if (!m_called.insert(name).second) {
-    std::cerr << "ERROR: Invalid " << name
+void GlobalParser::ParseDirectiveOnce(
+    DirectiveId id, void (GlobalParser::*implementation)(Directive&)) {
+  size_t index = static_cast<size_t>(id);
+  if (m_called.test(index)) {
+    std::cerr << "ERROR: Invalid " << DirectiveName(id)
               << " specified more than once before WorldBegin" << std::endl;
     exit(EXIT_FAILURE);
   }
 
-  Directive directive(name, m_tokenizer);
-  (this->*implementation)(directive);
+  m_called.set(index);
 
-  return true;
+  TraceScope trace("directive", DirectiveName(id));
+  Directive directive(DirectiveName(id), m_tokenizer);
+  (this->*implementation)(directive);
 }
 
 void GlobalParser::Accelerator(Directive& directive) { directive.Ignore(); }
@@ -625,95 +692,58 @@ void GlobalParser::SpectralRepresentation(Directive& directive) {
 void GlobalParser::Parse() {
   m_matrix_manager.Reset();
   for (auto token = m_tokenizer.Next(); token; token = m_tokenizer.Next()) {
-    if (token == "WorldBegin") {
-      return;
-    }
-
-    if (m_matrix_manager.Parse(*token, m_tokenizer)) {
+    DirectiveId id = LookupDirectiveId(*token);
+    if (m_matrix_manager.Parse(id, m_tokenizer)) {
       continue;
     }
 
-    if (TryParseInclude(*token, m_tokenizer)) {
-      continue;
-    }
-
-    if (ParseDirectiveOnce("Accelerator", *token, &GlobalParser::Accelerator)) {
-      continue;
-    }
-
-    if (ParseDirectiveOnce("AlwaysComputeReflectiveColor", *token,
-                           &GlobalParser::AlwaysComputeReflectiveColor)) {
-      continue;
-    }
-
-    if (ParseDirectiveOnce("Camera", *token, &GlobalParser::Camera)) {
-      continue;
-    }
-
-    if (ParseDirectiveOnce("ColorExtrapolator", *token,
-                           &GlobalParser::ColorExtrapolator)) {
-      continue;
-    }
-
-    if (ParseDirectiveOnce("ColorIntegrator", *token,
-                           &GlobalParser::ColorIntegrator)) {
-      continue;
-    }
-
-    if (ParseDirectiveOnce("Film", *token, &GlobalParser::Film)) {
-      continue;
-    }
-
-    if (ParseDirectiveOnce("Integrator", *token, &GlobalParser::Integrator)) {
-      continue;
-    }
-
-    if (ParseDirectiveOnce("PixelFilter", *token, &GlobalParser::PixelFilter)) {
-      continue;
-    }
-
-    if (ParseDirectiveOnce("Random", *token, &GlobalParser::Random)) {
-      continue;
-    }
-
-    if (ParseDirectiveOnce("RgbColorSpace", *token,
-                           &GlobalParser::RgbColorSpace)) {
-      continue;
-    }
-
-    if (ParseDirectiveOnce("Sampler", *token, &GlobalParser::Sampler)) {
-      continue;
-    }
-
-    if (ParseDirectiveOnce("SpectralRepresentation", *token,
-                           &GlobalParser::SpectralRepresentation)) {
-      continue;
-    }
-
-    if (token == "MakeNamedMedium") {
-      std::cerr << "ERROR: Invalid directive before WorldBegin: " << *token
-                << std::endl;
-      exit(EXIT_FAILURE);
-      continue;
-    }
-
-    if (token == "MediumInterface") {
-      std::cerr << "ERROR: Invalid directive before WorldBegin: " << *token
-                << std::endl;
-      exit(EXIT_FAILURE);
-      continue;
-    }
-
-    if (token == "TransformTimes") {
-      std::cerr << "ERROR: Invalid directive before WorldBegin: " << *token
-                << std::endl;
-      exit(EXIT_FAILURE);
-      continue;
+    switch (id) {
+      case DirectiveId::WorldBegin:
+        return;
+      case DirectiveId::Include:
+        m_tokenizer.Include(ParseIncludePath(m_tokenizer));
+        break;
+      case DirectiveId::Accelerator:
+        ParseDirectiveOnce(id, &GlobalParser::Accelerator);
+        break;
+      case DirectiveId::AlwaysComputeReflectiveColor:
+        ParseDirectiveOnce(id, &GlobalParser::AlwaysComputeReflectiveColor);
+        break;
+      case DirectiveId::Camera:
+        ParseDirectiveOnce(id, &GlobalParser::Camera);
+        break;
+      case DirectiveId::ColorExtrapolator:
+        ParseDirectiveOnce(id, &GlobalParser::ColorExtrapolator);
+        break;
+      case DirectiveId::ColorIntegrator:
+        ParseDirectiveOnce(id, &GlobalParser::ColorIntegrator);
+        break;
+      case DirectiveId::Film:
+        ParseDirectiveOnce(id, &GlobalParser::Film);
+        break;
+      case DirectiveId::Integrator:
+        ParseDirectiveOnce(id, &GlobalParser::Integrator);
+        break;
+      case DirectiveId::PixelFilter:
+        ParseDirectiveOnce(id, &GlobalParser::PixelFilter);
+        break;
+      case DirectiveId::Random:
+        ParseDirectiveOnce(id, &GlobalParser::Random);
+        break;
+      case DirectiveId::RgbColorSpace:
+        ParseDirectiveOnce(id, &GlobalParser::RgbColorSpace);
+        break;
+      case DirectiveId::Sampler:
+        ParseDirectiveOnce(id, &GlobalParser::Sampler);
+        break;
+      case DirectiveId::SpectralRepresentation:
+        ParseDirectiveOnce(id, &GlobalParser::SpectralRepresentation);
+        break;
+      default:
+        std::cerr << "ERROR: Invalid directive before WorldBegin: " << *token
+                  << std::endl;
+        exit(EXIT_FAILURE);
     }
-
-    std::cerr << "ERROR: Invalid directive before WorldBegin: " << *token
-              << std::endl;
-    exit(EXIT_FAILURE);
   }
 
   std::cerr << "ERROR: Missing WorldBegin directive" << std::endl;
@@ -766,33 +796,42 @@ GlobalConfig GlobalParser::Parse(Tokenizer& tokenizer,
         CreateDefaultAlwaysComputeReflectiveColor();
   }
 
-  auto camera = parser.m_camera_factory.value()(parser.m_film_result->first);
+  auto camera =
+      parser.m_camera_factory.value()(std::get<0>(*parser.m_film_result));
 
   return std::make_tuple(
       std::move(camera), std::move(parser.m_camera_to_world),
       std::move(parser.m_sampler.value()),
-      std::move(parser.m_film_result->first),
+      std::move(std::get<0>(*parser.m_film_result)),
       std::move(parser.m_integrator_result->first),
       std::move(parser.m_integrator_result->second),
       std::move(parser.m_color_extrapolator.value()),
       std::move(parser.m_color_integrator.value()),
-      std::move(parser.m_film_result->second),
+      std::move(std::get<1>(*parser.m_film_result)),
       std::move(parser.m_random.value()),
       std::move(parser.m_spectral_representation.value()),
       std::move(parser.m_rgb_color_space.value()),
-      std::move(parser.m_always_compute_reflective_color.value()));
+      std::move(parser.m_always_compute_reflective_color.value()),
+      std::move(std::get<2>(*parser.m_film_result)),
+      std::move(std::get<3>(*parser.m_film_result)));
 }
 
 class GraphicsStateManager {
  public:
   GraphicsStateManager();
 
+  GraphicsStateManager Fork() const;
+
   void TransformBegin(MatrixManager& matrix_manager);
   void TransformEnd(MatrixManager& matrix_manager);
 
   void AttributeBegin(MatrixManager& matrix_manager);
   void AttributeEnd(MatrixManager& matrix_manager);
 
+  // Returns true if the matching end directive would succeed
+  bool CanTransformEnd() const;
+  bool CanAttributeEnd() const;
+
   NamedTextureManager& GetNamedTextureManager();
   NamedMaterialManager& GetNamedMaterialManager();
 
@@ -844,14 +883,19 @@ GraphicsStateManager::GraphicsStateManager() {
   m_shader_state.push(shader_state);
 }
 
+GraphicsStateManager GraphicsStateManager::Fork() const {
+  GraphicsStateManager result;
+  result.m_shader_state.top() = m_shader_state.top();
+  return result;
+}
+
 void GraphicsStateManager::TransformBegin(MatrixManager& matrix_manager) {
   m_transform_state.push(
       {matrix_manager.GetCurrent(), matrix_manager.GetActive(), TRANSFORM});
 }
 
 void GraphicsStateManager::TransformEnd(MatrixManager& matrix_manager) {
-  if (m_transform_state.empty() ||
-      m_transform_state.top().push_reason != TRANSFORM) {
+  if (!CanTransformEnd()) {
     std::cerr << "ERROR: Mismatched TransformBegin and TransformEnd directives"
               << std::endl;
     exit(EXIT_FAILURE);
@@ -870,8 +914,7 @@ void GraphicsStateManager::AttributeBegin(MatrixManager& matrix_manager) {
 }
 
 void GraphicsStateManager::AttributeEnd(MatrixManager& matrix_manager) {
-  if (m_shader_state.size() == 1 || m_transform_state.empty() ||
-      m_transform_state.top().push_reason != ATTRIBUTE) {
+  if (!CanAttributeEnd()) {
     std::cerr << "ERROR: Mismatched AttributeBegin and AttributeEnd directives"
               << std::endl;
     exit(EXIT_FAILURE);
@@ -884,6 +927,16 @@ void GraphicsStateManager::AttributeEnd(MatrixManager& matrix_manager) {
   m_shader_state.pop();
 }
 
+bool GraphicsStateManager::CanTransformEnd() const {
+  return !m_transform_state.empty() &&
+         m_transform_state.top().push_reason == TRANSFORM;
+}
+
+bool GraphicsStateManager::CanAttributeEnd() const {
+  return m_shader_state.size() != 1 && !m_transform_state.empty() &&
+         m_transform_state.top().push_reason == ATTRIBUTE;
+}
+
 NamedTextureManager& GraphicsStateManager::GetNamedTextureManager() {
   return m_shader_state.top().named_texture_manager;
 }
@@ -923,7 +976,7 @@ void GraphicsStateManager::FlipReverseOrientation() {
 
 class GeometryParser {
  public:
-  static std::pair<Scene, std::vector<Light>> Parse(
+  static std::pair<SceneFactory, std::vector<Light>> Parse(
       Tokenizer& tokenizer, MatrixManager& matrix_manager,
       SpectrumManager& spectrum_manager,
       const ColorIntegrator& color_integrator);
@@ -931,14 +984,30 @@ class GeometryParser {
  private:
   GeometryParser(Tokenizer& tokenizer, MatrixManager& matrix_manager,
                  SpectrumManager& spectrum_manager,
-                 const ColorIntegrator& color_integrator)
+                 const ColorIntegrator& color_integrator,
+                 GraphicsStateManager graphics_state,
+                 MaterialManager& material_manager,
+                 NormalMapManager& normal_map_manager,
+                 TextureManager& texture_manager)
       : m_tokenizer(tokenizer),
         m_matrix_manager(matrix_manager),
         m_spectrum_manager(spectrum_manager),
-        m_color_integrator(color_integrator) {}
+        m_color_integrator(color_integrator),
+        m_graphics_state(std::move(graphics_state)),
+        m_material_manager(material_manager),
+        m_normal_map_manager(normal_map_manager),
+        m_texture_manager(texture_manager) {}
+  ~GeometryParser();
+
+  class ParallelInclude;
 
-  bool ParseDirective(absl::string_view name, absl::string_view token,
+  void ParseDirective(DirectiveId id,
                       void (GeometryParser::*implementation)(Directive&));
+  void ParseInclude();
+  bool CanSpeculate(DirectiveId id) const;
+  bool ConfirmParallelIncludes(size_t count);
+  bool JoinParallelIncludes(size_t count);
+  bool FlushParallelIncludes();
   void AreaLightSource(Directive& directive);
   void LightSource(Directive& directive);
   void MakeNamedMaterial(Directive& directive);
@@ -950,32 +1019,225 @@ class GeometryParser {
   void Shape(Directive& directive);
   void Texture(Directive& directive);
 
-  std::pair<Scene, std::vector<Light>> Parse();
+  void ParseToken(absl::string_view token);
+  std::pair<SceneFactory, std::vector<Light>> Parse();
+  void ParseIncludedFile();
 
   Tokenizer& m_tokenizer;
   MatrixManager& m_matrix_manager;
   SpectrumManager& m_spectrum_manager;
   const ColorIntegrator& m_color_integrator;
   GraphicsStateManager m_graphics_state;
-  MaterialManager m_material_manager;
-  NormalMapManager m_normal_map_manager;
+  MaterialManager& m_material_manager;
+  NormalMapManager& m_normal_map_manager;
   SceneBuilder m_scene_builder;
-  TextureManager m_texture_manager;
+  TextureManager& m_texture_manager;
+  std::deque<std::unique_ptr<ParallelInclude>> m_parallel_includes;
+  size_t m_num_confirmed = 0;
 };
 
-bool GeometryParser::ParseDirective(
-    absl::string_view name, absl::string_view token,
-    void (GeometryParser::*implementation)(Directive&)) {
-  if (token != name) {
+// Parses an included file on a worker thread. The worker first reads the whole
+// file, recording its tokens while checking that it is a self-contained block,
+// and publishes the result. It then parses the recorded tokens once every
+// include launched before it has also been found to be self-contained, since
+// until then the state it was forked from may be wrong.
+//
+// The parent keeps parsing while the check runs. Its state and a tokenizer
+// checkpoint are saved so that it can be rolled back if the check fails.
+class GeometryParser::ParallelInclude {
+ public:
+  ParallelInclude(std::string path, Tokenizer tokenizer, GeometryParser& parent,
+                  std::vector<std::shared_future<bool>> unconfirmed)
+      : m_path(std::move(path)),
+        m_checkpoint(parent.m_tokenizer.Checkpoint()),
+        m_saved_graphics_state(
+            absl::make_unique<GraphicsStateManager>(parent.m_graphics_state)),
+        m_saved_matrix_manager(
+            absl::make_unique<MatrixManager>(parent.m_matrix_manager)),
+        m_tokenizer(std::move(tokenizer)),
+        m_matrix_manager(parent.m_matrix_manager),
+        m_parser(m_tokenizer, m_matrix_manager, parent.m_spectrum_manager,
+                 parent.m_color_integrator, parent.m_graphics_state.Fork(),
+                 parent.m_material_manager, parent.m_normal_map_manager,
+                 parent.m_texture_manager),
+        m_self_contained(m_checked.get_future().share()),
+        m_done(std::async(
+            std::launch::async,
+            [this, unconfirmed = std::move(unconfirmed)]() {
+              TraceScope trace("parse", "ParallelInclude");
+              size_t checkpoint = m_tokenizer.Checkpoint();
+              bool self_contained = IsSelfContainedAttributeBlock(m_tokenizer);
+              m_checked.set_value(self_contained);
+              if (!self_contained) {
+                return;
+              }
+
+              for (const auto& include : unconfirmed) {
+                if (!include.get()) {
+                  return;
+                }
+              }
+
+              m_tokenizer.Rewind(checkpoint);
+              m_parser.ParseIncludedFile();
+            })) {}
+
+  // Blocks until the worker has checked the file
+  const std::shared_future<bool>& SelfContained() const {
+    return m_self_contained;
+  }
+
+  void Confirm() {
+    m_saved_graphics_state.reset();
+    m_saved_matrix_manager.reset();
+  }
+
+  // Restores the parent to where the Include directive was parsed and queues
+  // the file to be parsed serially, followed by every token the parent has
+  // consumed since.
+  void Rollback(GeometryParser& parent) {
+    parent.m_graphics_state = std::move(*m_saved_graphics_state);
+    parent.m_matrix_manager = std::move(*m_saved_matrix_manager);
+    parent.m_tokenizer.Rewind(m_checkpoint);
+    parent.m_tokenizer.Include(m_path);
+  }
+
+  SceneBuilder& Join() {
+    m_done.get();
+    return m_parser.m_scene_builder;
+  }
+
+ private:
+  std::string m_path;
+  size_t m_checkpoint;
+  std::unique_ptr<GraphicsStateManager> m_saved_graphics_state;
+  std::unique_ptr<MatrixManager> m_saved_matrix_manager;
+  Tokenizer m_tokenizer;
+  MatrixManager m_matrix_manager;
+  GeometryParser m_parser;
+  std::promise<bool> m_checked;
+  std::shared_future<bool> m_self_contained;
+  std::future<void> m_done;
+};
+
+GeometryParser::~GeometryParser() { assert(m_parallel_includes.empty()); }
+
+void GeometryParser::ParseInclude() {
+  std::string path = ParseIncludePath(m_tokenizer);
+
+  if (!absl::GetFlag(FLAGS_parallel_includes) ||
+      m_scene_builder.InObjectDefinition()) {
+    if (ConfirmParallelIncludes(m_parallel_includes.size())) {
+      m_tokenizer.Include(path);
+    }
+    return;
+  }
+
+  // Only the first token is checked here; the worker checks the rest of the
+  // file as it reads it.
+  auto tokenizer = m_tokenizer.Fork(path);
+  auto first_token = tokenizer.Peek();
+  if (!first_token || *first_token != "AttributeBegin") {
+    if (ConfirmParallelIncludes(m_parallel_includes.size())) {
+      m_tokenizer.Include(path);
+    }
+    return;
+  }
+
+  size_t max_in_flight = std::max(1u, std::thread::hardware_concurrency());
+  if (m_parallel_includes.size() == max_in_flight &&
+      !JoinParallelIncludes(1)) {
+    return;
+  }
+
+  std::vector<std::shared_future<bool>> unconfirmed;
+  for (size_t i = m_num_confirmed; i < m_parallel_includes.size(); i++) {
+    unconfirmed.push_back(m_parallel_includes[i]->SelfContained());
+  }
+
+  m_parallel_includes.push_back(absl::make_unique<ParallelInclude>(
+      std::move(path), std::move(tokenizer), *this, std::move(unconfirmed)));
+}
+
+// Returns true if the directive can be parsed before the in flight includes
+// have been checked. Its effects are undone if one of them is rolled back, and
+// any error it could report does not depend on what they contain.
+bool GeometryParser::CanSpeculate(DirectiveId id) const {
+  switch (id) {
+    case DirectiveId::ActiveTransform:
+    case DirectiveId::AttributeBegin:
+    case DirectiveId::ConcatTransform:
+    case DirectiveId::CoordinateSystem:
+    case DirectiveId::Identity:
+    case DirectiveId::Include:
+    case DirectiveId::LookAt:
+    case DirectiveId::ReverseOrientation:
+    case DirectiveId::Rotate:
+    case DirectiveId::Scale:
+    case DirectiveId::Transform:
+    case DirectiveId::TransformBegin:
+    case DirectiveId::Translate:
+      return true;
+    case DirectiveId::AttributeEnd:
+      return m_graphics_state.CanAttributeEnd();
+    case DirectiveId::TransformEnd:
+      return m_graphics_state.CanTransformEnd();
+    default:
+      return false;
+  }
+}
+
+// Waits until the oldest count in flight includes have been checked. If one of
+// them is not a self-contained block, it and every include after it are
+// discarded, the parser is rolled back to include that file serially, and
+// false is returned.
+bool GeometryParser::ConfirmParallelIncludes(size_t count) {
+  for (; m_num_confirmed < count; m_num_confirmed++) {
+    auto& include = m_parallel_includes[m_num_confirmed];
+    if (!include->SelfContained().get()) {
+      auto rolled_back = std::move(include);
+      m_parallel_includes.erase(m_parallel_includes.begin() + m_num_confirmed,
+                                m_parallel_includes.end());
+      rolled_back->Rollback(*this);
+      return false;
+    }
+
+    include->Confirm();
+  }
+
+  if (m_num_confirmed == m_parallel_includes.size()) {
+    m_tokenizer.ReleaseCheckpoints();
+  }
+
+  return true;
+}
+
+// Appends the oldest count in flight includes to the scene in order
+bool GeometryParser::JoinParallelIncludes(size_t count) {
+  if (!ConfirmParallelIncludes(count)) {
     return false;
   }
 
-  Directive directive(name, m_tokenizer);
-  (this->*implementation)(directive);
+  for (size_t i = 0; i < count; i++) {
+    m_scene_builder.Append(m_parallel_includes.front()->Join());
+    m_parallel_includes.pop_front();
+    m_num_confirmed -= 1;
+  }
 
   return true;
 }
 
+bool GeometryParser::FlushParallelIncludes() {
+  return JoinParallelIncludes(m_parallel_includes.size());
+}
+
+void GeometryParser::ParseDirective(
+    DirectiveId id, void (GeometryParser::*implementation)(Directive&)) {
+  TraceScope trace("directive", DirectiveName(id));
+  Directive directive(DirectiveName(id), m_tokenizer);
+  (this->*implementation)(directive);
+}
+
 void GeometryParser::AreaLightSource(Directive& directive) {
   auto light_state = ParseAreaLight(directive, m_spectrum_manager);
   if (m_graphics_state.GetReverseOrientation()) {
@@ -1056,126 +1318,118 @@ void GeometryParser::Texture(Directive& directive) {
                m_spectrum_manager);
 }
 
-std::pair<Scene, std::vector<Light>> GeometryParser::Parse() {
-  m_matrix_manager.Reset();
-  for (auto token = m_tokenizer.Next(); token; token = m_tokenizer.Next()) {
-    if (token == "WorldEnd") {
-      return m_scene_builder.Build();
-    }
-
-    if (TryParseInclude(*token, m_tokenizer)) {
-      continue;
-    }
-
-    if (m_matrix_manager.Parse(*token, m_tokenizer)) {
-      continue;
-    }
+void GeometryParser::ParseToken(absl::string_view token) {
+  DirectiveId id = LookupDirectiveId(token);
+  if (m_matrix_manager.Parse(id, m_tokenizer)) {
+    return;
+  }
 
-    if (token == "ReverseOrientation") {
+  switch (id) {
+    case DirectiveId::Include:
+      ParseInclude();
+      break;
+    case DirectiveId::ReverseOrientation:
       m_graphics_state.FlipReverseOrientation();
-      continue;
-    }
-
-    if (token == "AttributeBegin") {
+      break;
+    case DirectiveId::AttributeBegin:
       m_graphics_state.AttributeBegin(m_matrix_manager);
-      continue;
-    }
-
-    if (token == "AttributeEnd") {
+      break;
+    case DirectiveId::AttributeEnd:
       m_graphics_state.AttributeEnd(m_matrix_manager);
-      continue;
-    }
-
-    if (token == "TransformBegin") {
+      break;
+    case DirectiveId::TransformBegin:
       m_graphics_state.TransformBegin(m_matrix_manager);
-      continue;
-    }
-
-    if (token == "TransformEnd") {
+      break;
+    case DirectiveId::TransformEnd:
       m_graphics_state.TransformEnd(m_matrix_manager);
-      continue;
-    }
-
-    if (ParseDirective("ObjectBegin", *token, &GeometryParser::ObjectBegin)) {
-      continue;
-    }
-
-    if (ParseDirective("ObjectEnd", *token, &GeometryParser::ObjectEnd)) {
-      continue;
-    }
-
-    if (ParseDirective("ObjectInstance", *token,
-                       &GeometryParser::ObjectInstance)) {
-      continue;
-    }
-
-    if (ParseDirective("AreaLightSource", *token,
-                       &GeometryParser::AreaLightSource)) {
-      continue;
-    }
-
-    if (ParseDirective("LightSource", *token, &GeometryParser::LightSource)) {
-      continue;
-    }
-
-    if (ParseDirective("Material", *token, &GeometryParser::Material)) {
-      continue;
-    }
-
-    if (ParseDirective("MakeNamedMaterial", *token,
-                       &GeometryParser::MakeNamedMaterial)) {
-      continue;
-    }
-
-    if (ParseDirective("NamedMaterial", *token,
-                       &GeometryParser::NamedMaterial)) {
-      continue;
-    }
-
-    if (ParseDirective("Shape", *token, &GeometryParser::Shape)) {
-      continue;
-    }
-
-    if (token == "MakeNamedMedium") {
-      std::cerr << "ERROR: Invalid directive after WorldBegin: " << *token
+      break;
+    case DirectiveId::ObjectBegin:
+      ParseDirective(id, &GeometryParser::ObjectBegin);
+      break;
+    case DirectiveId::ObjectEnd:
+      ParseDirective(id, &GeometryParser::ObjectEnd);
+      break;
+    case DirectiveId::ObjectInstance:
+      ParseDirective(id, &GeometryParser::ObjectInstance);
+      break;
+    case DirectiveId::AreaLightSource:
+      ParseDirective(id, &GeometryParser::AreaLightSource);
+      break;
+    case DirectiveId::LightSource:
+      ParseDirective(id, &GeometryParser::LightSource);
+      break;
+    case DirectiveId::Material:
+      ParseDirective(id, &GeometryParser::Material);
+      break;
+    case DirectiveId::MakeNamedMaterial:
+      ParseDirective(id, &GeometryParser::MakeNamedMaterial);
+      break;
+    case DirectiveId::NamedMaterial:
+      ParseDirective(id, &GeometryParser::NamedMaterial);
+      break;
+    case DirectiveId::Shape:
+      ParseDirective(id, &GeometryParser::Shape);
+      break;
+    case DirectiveId::Texture:
+      ParseDirective(id, &GeometryParser::Texture);
+      break;
+    case DirectiveId::MakeNamedMedium:
+    case DirectiveId::MediumInterface:
+    case DirectiveId::TransformTimes:
+      std::cerr << "ERROR: Invalid directive after WorldBegin: " << token
                 << std::endl;
       exit(EXIT_FAILURE);
-      continue;
-    }
-
-    if (token == "MediumInterface") {
-      std::cerr << "ERROR: Invalid directive after WorldBegin: " << *token
+    default:
+      std::cerr << "ERROR: Invalid directive after WorldEnd: " << token
                 << std::endl;
       exit(EXIT_FAILURE);
-      continue;
-    }
+  }
+}
 
-    if (ParseDirective("Texture", *token, &GeometryParser::Texture)) {
-      continue;
+std::pair<SceneFactory, std::vector<Light>> GeometryParser::Parse() {
+  m_matrix_manager.Reset();
+  for (auto token = m_tokenizer.Next(); token; token = m_tokenizer.Next()) {
+    // If an include is rolled back, this token is read again afterwards
+    if (token == "WorldEnd") {
+      if (!FlushParallelIncludes()) {
+        continue;
+      }
+      return m_scene_builder.Build();
     }
 
-    if (token == "TransformTimes") {
-      std::cerr << "ERROR: Invalid directive after WorldBegin: " << *token
-                << std::endl;
-      exit(EXIT_FAILURE);
+    DirectiveId id = LookupDirectiveId(*token);
+    if (AddsToScene(id)) {
+      if (!FlushParallelIncludes()) {
+        continue;
+      }
+    } else if (!CanSpeculate(id) &&
+               !ConfirmParallelIncludes(m_parallel_includes.size())) {
       continue;
     }
 
-    std::cerr << "ERROR: Invalid directive after WorldEnd: " << *token
-              << std::endl;
-    exit(EXIT_FAILURE);
+    ParseToken(*token);
   }
 
   std::cerr << "ERROR: Missing WorldEnd directive" << std::endl;
   exit(EXIT_FAILURE);
 }
 
-std::pair<Scene, std::vector<Light>> GeometryParser::Parse(
+void GeometryParser::ParseIncludedFile() {
+  for (auto token = m_tokenizer.Next(); token; token = m_tokenizer.Next()) {
+    ParseToken(*token);
+  }
+}
+
+std::pair<SceneFactory, std::vector<Light>> GeometryParser::Parse(
     Tokenizer& tokenizer, MatrixManager& matrix_manager,
     SpectrumManager& spectrum_manager,
     const ColorIntegrator& color_integrator) {
+  MaterialManager material_manager;
+  NormalMapManager normal_map_manager;
+  TextureManager texture_manager;
   GeometryParser parser(tokenizer, matrix_manager, spectrum_manager,
-                        color_integrator);
+                        color_integrator, GraphicsStateManager(),
+                        material_manager, normal_map_manager, texture_manager);
   return parser.Parse();
 }
 
@@ -1229,7 +1483,10 @@ absl::optional<RendererConfiguration> Parser::Next(
   }
 
   MatrixManager matrix_manager;
+  absl::optional<ScopedPhase> phase;
+  phase.emplace("parse_globals");
   auto global_config = GlobalParser::Parse(m_tokenizer, matrix_manager);
+  phase.reset();
 
   if (always_compute_reflective_color_override.value_or(
           std::get<12>(global_config))) {
@@ -1245,9 +1502,11 @@ absl::optional<RendererConfiguration> Parser::Next(
       spectral_representation_override.value_or(std::get<10>(global_config)),
       rgb_color_space_override.value_or(std::get<11>(global_config)));
 
+  phase.emplace("parse_geometry");
   auto geometry_config = GeometryParser::Parse(m_tokenizer, matrix_manager,
                                                manager_and_interpolator.first,
                                                manager_and_interpolator.second);
+  phase.reset();
 
   return std::make_tuple(
       std::move(geometry_config.first),
@@ -1259,7 +1518,9 @@ absl::optional<RendererConfiguration> Parser::Next(
       std::move(manager_and_interpolator.second),
       std::move(std::get<9>(global_config)),
       std::move(std::get<3>(global_config)),
-      std::move(std::get<8>(global_config)));
+      std::move(std::get<8>(global_config)),
+      std::move(std::get<13>(global_config)),
+      std::move(std::get<14>(global_config)));
 }
 
 bool Parser::Done() { return !m_tokenizer.Peek().has_value(); }
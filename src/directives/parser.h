@@ -2,16 +2,26 @@
 #define _SRC_DIRECTIVES_PARSER_
 
 #include <tuple>
+#include <vector>
 
+#include "absl/types/optional.h"
+#include "src/common/aov.h"
+#include "src/common/pixel_bounds.h"
 #include "src/common/pointer_types.h"
 #include "src/common/tokenizer.h"
+#include "src/directives/scene_builder.h"
 #include "src/directives/spectral_representation.h"
 #include "src/films/output_writers/result.h"
+#include "src/integrators/result.h"
+#include "src/randoms/result.h"
+#include "src/samplers/result.h"
 
 namespace iris {
 
-typedef std::tuple<Scene, LightSampler, Camera, Matrix, Sampler, Integrator,
-                   ColorIntegrator, Random, Framebuffer, OutputWriter>
+typedef std::tuple<SceneFactory, LightSampler, Camera, Matrix, SamplerResult,
+                   IntegratorFactory, ColorIntegrator, RandomResult,
+                   Framebuffer, OutputWriter, absl::optional<PixelBounds>,
+                   std::vector<Aov>>
     RendererConfiguration;
 
 class Parser {
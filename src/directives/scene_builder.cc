@@ -1,22 +1,24 @@
 #include "src/directives/scene_builder.h"
 
 #include <iostream>
+#include <memory>
 
 #include "iris_physx_toolkit/aggregate_environmental_light.h"
 #include "iris_physx_toolkit/scenes/bvh.h"
 #include "src/common/error.h"
+#include "src/common/run_statistics.h"
+#include "src/common/trace.h"
 
 namespace iris {
+namespace {
 
-SceneBuilder::~SceneBuilder() {
-  for (PMATRIX matrix : m_scene_transforms) {
-    MatrixRelease(matrix);
-  }
+struct SceneGeometry {
+  std::vector<Shape> shapes;
+  std::vector<Matrix> transforms;
+  EnvironmentalLight environmental_light;
+};
 
-  for (PSHAPE shape : m_scene_shapes) {
-    ShapeRelease(shape);
-  }
-}
+}  // namespace
 
 void SceneBuilder::ObjectBegin(Directive& directive) {
   if (m_build_instanced_object) {
@@ -98,10 +100,8 @@ void SceneBuilder::AddShape(const Shape& shape, const Matrix& matrix) {
 
     m_instanced_object_shapes.push_back(shape);
   } else {
-    m_scene_shapes.push_back(shape.get());
-    ShapeRetain(m_scene_shapes.back());
-    m_scene_transforms.push_back(matrix.get());
-    MatrixRetain(m_scene_transforms.back());
+    m_scene_shapes.push_back(shape);
+    m_scene_transforms.push_back(matrix);
   }
 }
 
@@ -136,8 +136,31 @@ void SceneBuilder::AddLight(const Light& light,
   }
 }
 
-std::pair<Scene, std::vector<Light>> SceneBuilder::Build() {
+void SceneBuilder::Append(SceneBuilder& other) {
+  assert(!m_build_instanced_object && !other.m_build_instanced_object);
+
+  m_scene_shapes.insert(m_scene_shapes.end(), other.m_scene_shapes.begin(),
+                        other.m_scene_shapes.end());
+  other.m_scene_shapes.clear();
+
+  m_scene_transforms.insert(m_scene_transforms.end(),
+                            other.m_scene_transforms.begin(),
+                            other.m_scene_transforms.end());
+  other.m_scene_transforms.clear();
+
+  m_scene_lights.insert(m_scene_lights.end(), other.m_scene_lights.begin(),
+                        other.m_scene_lights.end());
+  other.m_scene_lights.clear();
+
+  m_environmental_lights.insert(m_environmental_lights.end(),
+                                other.m_environmental_lights.begin(),
+                                other.m_environmental_lights.end());
+  other.m_environmental_lights.clear();
+}
+
+std::pair<SceneFactory, std::vector<Light>> SceneBuilder::Build() {
   assert(m_scene_shapes.size() == m_scene_transforms.size());
+  ScopedPhase phase("build_scene");
 
   std::vector<Light> result_lights = m_scene_lights;
 
@@ -161,14 +184,38 @@ std::pair<Scene, std::vector<Light>> SceneBuilder::Build() {
     result_lights.push_back(environmental_light_as_light);
   }
 
-  Scene result;
-  ISTATUS status = BvhSceneAllocate(
-      m_scene_shapes.data(), m_scene_transforms.data(), nullptr,
-      m_scene_shapes.size(), environmental_light.get(),
-      result.release_and_get_address());
-  SuccessOrOOM(status);
+  IncrementCounter(Counter::SHAPES_CREATED, m_scene_shapes.size());
+  IncrementCounter(Counter::LIGHTS_CREATED, result_lights.size());
+
+  auto geometry = std::make_shared<SceneGeometry>();
+  geometry->shapes = std::move(m_scene_shapes);
+  geometry->transforms = std::move(m_scene_transforms);
+  geometry->environmental_light = std::move(environmental_light);
+  m_scene_shapes.clear();
+  m_scene_transforms.clear();
+
+  SceneFactory factory = [geometry]() {
+    TraceScope trace("build", "BuildBvh");
+    std::vector<PSHAPE> shapes;
+    for (const auto& shape : geometry->shapes) {
+      shapes.push_back(shape.get());
+    }
+
+    std::vector<PMATRIX> transforms;
+    for (const auto& matrix : geometry->transforms) {
+      transforms.push_back(matrix.get());
+    }
+
+    Scene result;
+    ISTATUS status = BvhSceneAllocate(
+        shapes.data(), transforms.data(), nullptr, shapes.size(),
+        geometry->environmental_light.get(), result.release_and_get_address());
+    SuccessOrOOM(status);
+
+    return result;
+  };
 
-  return std::make_pair(result, result_lights);
+  return std::make_pair(std::move(factory), std::move(result_lights));
 }
 
 }  // namespace iris
\ No newline at end of file
@@ -1,7 +1,9 @@
 #ifndef _SRC_DIRECTIVES_SCENE_BUILDER_
 #define _SRC_DIRECTIVES_SCENE_BUILDER_
 
+#include <functional>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
@@ -10,12 +12,17 @@
 
 namespace iris {
 
+// Allocates a copy of the scene that shares its shapes and lights with every
+// other copy but has an acceleration structure of its own, which is first
+// touched by, and so on Linux placed in memory local to, the calling thread.
+// No acceleration structure is built until the factory is called.
+typedef std::function<Scene()> SceneFactory;
+
 class SceneBuilder {
  public:
   SceneBuilder() : m_build_instanced_object(false) {}
   SceneBuilder(const SceneBuilder&) = delete;
   SceneBuilder& operator=(const SceneBuilder&) = delete;
-  ~SceneBuilder();
 
   void ObjectBegin(Directive& directive);
   void ObjectInstance(Directive& directive, const Matrix& matrix);
@@ -27,7 +34,10 @@ class SceneBuilder {
   void AddLight(const Light& light,
                 const EnvironmentalLight& environmental_light);
 
-  std::pair<Scene, std::vector<Light>> Build();
+  bool InObjectDefinition() const { return m_build_instanced_object; }
+  void Append(SceneBuilder& other);
+
+  std::pair<SceneFactory, std::vector<Light>> Build();
 
  private:
   std::vector<Shape> m_instanced_object_shapes;
@@ -44,8 +54,8 @@ class SceneBuilder {
 
   std::vector<Light> m_scene_lights;
   std::vector<std::tuple<Light, EnvironmentalLight>> m_environmental_lights;
-  std::vector<PMATRIX> m_scene_transforms;
-  std::vector<PSHAPE> m_scene_shapes;
+  std::vector<Matrix> m_scene_transforms;
+  std::vector<Shape> m_scene_shapes;
 };
 
 }  // namespace iris
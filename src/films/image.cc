@@ -1,15 +1,146 @@
 #include "src/films/image.h"
 
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
 #include "src/common/error.h"
 #include "src/films/output_writers/parser.h"
 #include "src/param_matchers/integral_single.h"
+#include "src/param_matchers/list.h"
 #include "src/param_matchers/single.h"
 
+ABSL_FLAG(std::string, crop_window, "",
+          "If set, overrides the cropwindow and pixelbounds parameters of "
+          "the film. Given as x0,x1,y0,y1 in the same form as cropwindow.");
+ABSL_FLAG(std::string, pixel_bounds, "",
+          "If set, overrides the cropwindow and pixelbounds parameters of "
+          "the film. Given as x0,x1,y0,y1 in the same form as pixelbounds.");
+
 namespace iris {
 namespace {
 
+typedef ListValueMatcher<FloatParameter, float_t, 4, 4, 4> CropWindowMatcher;
+typedef ListValueMatcher<IntParameter, int, 4, 4, 4> PixelBoundsMatcher;
+typedef ListValueMatcher<StringParameter, std::string, 1, 1> AovsMatcher;
+
 static const size_t kImageFilmDefaultXResolution = 640;
 static const size_t kImageFilmDefaultYResolution = 480;
+static const std::vector<float_t> kImageFilmDefaultCropWindow = {};
+static const std::vector<int> kImageFilmDefaultPixelBounds = {};
+static const std::vector<std::string> kImageFilmDefaultAovs = {};
+
+template <typename T, bool (*ParseFunc)(absl::string_view, T*)>
+std::vector<T> ParseFlagValues(const std::string& flag_name,
+                               const std::string& text,
+                               absl::string_view plural_type_name) {
+  std::vector<T> result;
+  for (absl::string_view value : absl::StrSplit(text, ',')) {
+    T parsed;
+    if (!ParseFunc(value, &parsed)) {
+      result.clear();
+      break;
+    }
+    result.push_back(parsed);
+  }
+
+  if (result.size() != 4) {
+    std::cerr << "ERROR: " << flag_name << " must be four comma separated "
+              << plural_type_name << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  return result;
+}
+
+// As in pbrt, the bounds begin at the first pixel whose center is within the
+// crop window.
+PixelBounds CropWindowBounds(const float_t* crop_window, size_t xresolution,
+                             size_t yresolution) {
+  for (size_t i = 0; i < 4; i++) {
+    if (!(crop_window[i] >= (float_t)0.0 && crop_window[i] <= (float_t)1.0)) {
+      std::cerr << "ERROR: cropwindow values must be between 0 and 1"
+                << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  PixelBounds result;
+  result.min_column = static_cast<size_t>(std::ceil(
+      static_cast<double>(xresolution) * std::min(crop_window[0],
+                                                  crop_window[1])));
+  result.max_column = static_cast<size_t>(std::ceil(
+      static_cast<double>(xresolution) * std::max(crop_window[0],
+                                                  crop_window[1])));
+  result.min_row = static_cast<size_t>(std::ceil(
+      static_cast<double>(yresolution) * std::min(crop_window[2],
+                                                  crop_window[3])));
+  result.max_row = static_cast<size_t>(std::ceil(
+      static_cast<double>(yresolution) * std::max(crop_window[2],
+                                                  crop_window[3])));
+
+  if (result.Empty()) {
+    std::cerr << "ERROR: cropwindow does not contain any pixels" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  return result;
+}
+
+PixelBounds PixelBoundsBounds(const int* pixel_bounds, size_t xresolution,
+                              size_t yresolution) {
+  if (pixel_bounds[0] < 0 || pixel_bounds[2] < 0 ||
+      xresolution < static_cast<size_t>(std::max(pixel_bounds[1], 0)) ||
+      yresolution < static_cast<size_t>(std::max(pixel_bounds[3], 0))) {
+    std::cerr << "ERROR: pixelbounds must be within the image" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  PixelBounds result;
+  result.min_column = static_cast<size_t>(pixel_bounds[0]);
+  result.max_column = static_cast<size_t>(std::max(pixel_bounds[1], 0));
+  result.min_row = static_cast<size_t>(pixel_bounds[2]);
+  result.max_row = static_cast<size_t>(std::max(pixel_bounds[3], 0));
+
+  if (result.Empty()) {
+    std::cerr << "ERROR: pixelbounds does not contain any pixels"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  return result;
+}
+
+std::vector<Aov> ParseAovs(const ArenaVector<std::string>& names) {
+  std::vector<Aov> result;
+  for (const auto& name : names) {
+    Aov aov;
+    if (name == "albedo") {
+      aov = Aov::ALBEDO;
+    } else if (name == "normal") {
+      aov = Aov::NORMAL;
+    } else if (name == "depth") {
+      aov = Aov::DEPTH;
+    } else {
+      std::cerr << "ERROR: Unsupported aov: " << name << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+    if (std::find(result.begin(), result.end(), aov) != result.end()) {
+      std::cerr << "ERROR: Duplicate aov: " << name << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+    result.push_back(aov);
+  }
+
+  return result;
+}
 
 }  // namespace
 
@@ -19,15 +150,59 @@ FilmResult ParseImage(Parameters& parameters) {
                                         kImageFilmDefaultXResolution);
   NonZeroSingleSizeTMatcher yresolution("yresolution", false,
                                         kImageFilmDefaultYResolution);
-  parameters.Match(filename, xresolution, yresolution);
+  CropWindowMatcher cropwindow("cropwindow", false,
+                               kImageFilmDefaultCropWindow);
+  PixelBoundsMatcher pixelbounds("pixelbounds", false,
+                                 kImageFilmDefaultPixelBounds);
+  AovsMatcher aovs("aovs", false, kImageFilmDefaultAovs);
+  parameters.Match(filename, xresolution, yresolution, cropwindow,
+                   pixelbounds, aovs);
+
+  std::vector<float_t> crop_window(cropwindow.Get().begin(),
+                                   cropwindow.Get().end());
+  std::vector<int> pixel_bounds(pixelbounds.Get().begin(),
+                                pixelbounds.Get().end());
+
+  std::string crop_window_flag = absl::GetFlag(FLAGS_crop_window);
+  std::string pixel_bounds_flag = absl::GetFlag(FLAGS_pixel_bounds);
+  if (!crop_window_flag.empty() && !pixel_bounds_flag.empty()) {
+    std::cerr << "ERROR: Only one of crop_window or pixel_bounds may be set"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  } else if (!crop_window_flag.empty()) {
+    crop_window = ParseFlagValues<float_t, absl::SimpleAtof>(
+        "crop_window", crop_window_flag, "numbers");
+    pixel_bounds.clear();
+  } else if (!pixel_bounds_flag.empty()) {
+    pixel_bounds = ParseFlagValues<int, absl::SimpleAtoi>(
+        "pixel_bounds", pixel_bounds_flag, "integers");
+    crop_window.clear();
+  }
+
+  if (!crop_window.empty() && !pixel_bounds.empty()) {
+    std::cerr << "ERROR: Only one of cropwindow or pixelbounds may be "
+                 "specified"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  absl::optional<PixelBounds> bounds;
+  if (!crop_window.empty()) {
+    bounds = CropWindowBounds(crop_window.data(), xresolution.Get(),
+                              yresolution.Get());
+  } else if (!pixel_bounds.empty()) {
+    bounds = PixelBoundsBounds(pixel_bounds.data(), xresolution.Get(),
+                               yresolution.Get());
+  }
 
   Framebuffer framebuffer;
   ISTATUS status = FramebufferAllocate(xresolution.Get(), yresolution.Get(),
                                        framebuffer.release_and_get_address());
   SuccessOrOOM(status);
 
-  return std::make_pair(std::move(framebuffer),
-                        ParseOutputWriter(filename.Get()));
+  return std::make_tuple(std::move(framebuffer),
+                         ParseOutputWriter(filename.Get()), bounds,
+                         ParseAovs(aovs.Get()));
 }
 
 }  // namespace iris
\ No newline at end of file
@@ -1,11 +1,20 @@
 #include "src/films/output_writers/exr.h"
 
+#include <algorithm>
+#include <cassert>
 #include <iostream>
 #include <memory>
+#include <thread>
 #include <vector>
 
+#include "absl/flags/flag.h"
+#include "src/films/output_writers/exr_file.h"
 #include "src/films/output_writers/lock_file.h"
-#include "tinyexr.h"
+
+ABSL_FLAG(std::string, exr_compression, "zip",
+          "The compression used for exr output. One of none, zips, or zip.");
+ABSL_FLAG(std::string, exr_pixel_type, "half",
+          "The type of the pixels of exr output. One of half or float.");
 
 namespace iris {
 namespace {
@@ -13,7 +22,8 @@ namespace {
 class ExrWriter final : public OutputWriterBase {
  public:
   static std::unique_ptr<OutputWriterBase> Create(absl::string_view file_name);
-  void Write(const Framebuffer& framebuffer);
+  void Write(const Framebuffer& framebuffer,
+             const std::vector<AovBuffer>& aovs);
 
  private:
   ExrWriter(std::string path);
@@ -31,34 +41,77 @@ std::unique_ptr<OutputWriterBase> ExrWriter::Create(
 ExrWriter::ExrWriter(std::string path)
     : m_lock_file(LockFile::Create(path)), m_path(std::move(path)) {}
 
-void ExrWriter::Write(const Framebuffer& framebuffer) {
+void ExrWriter::Write(const Framebuffer& framebuffer,
+                      const std::vector<AovBuffer>& aovs) {
   m_lock_file.reset();
 
+  std::string compression_name = absl::GetFlag(FLAGS_exr_compression);
+
+  ExrCompression compression;
+  if (compression_name == "none") {
+    compression = ExrCompression::NONE;
+  } else if (compression_name == "zips") {
+    compression = ExrCompression::ZIPS;
+  } else if (compression_name == "zip") {
+    compression = ExrCompression::ZIP;
+  } else {
+    std::cerr << "ERROR: Unsupported exr_compression: " << compression_name
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::string pixel_type_name = absl::GetFlag(FLAGS_exr_pixel_type);
+
+  ExrPixelType pixel_type;
+  if (pixel_type_name == "half") {
+    pixel_type = ExrPixelType::HALF;
+  } else if (pixel_type_name == "float") {
+    pixel_type = ExrPixelType::FLOAT;
+  } else {
+    std::cerr << "ERROR: Unsupported exr_pixel_type: " << pixel_type_name
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
   size_t columns, rows;
   FramebufferGetSize(framebuffer.get(), &columns, &rows);
 
-  std::vector<float> data;
-  for (size_t row = 0; row < rows; row++) {
+  // The AOVs are written as layers whose channels follow those of the image.
+  std::vector<std::string> channel_names = {"R", "G", "B"};
+  for (const auto& aov : aovs) {
+    assert(aov.num_columns == columns && aov.num_rows == rows);
+    for (const auto& channel : aov.channels) {
+      channel_names.push_back(aov.name + "." + channel);
+    }
+  }
+
+  auto read_row = [&](size_t row, const std::vector<float*>& channels) {
     for (size_t column = 0; column < columns; column++) {
       COLOR3 pixel;
       FramebufferGetPixel(framebuffer.get(), column, row, &pixel);
 
       pixel = ColorConvert(pixel, COLOR_SPACE_LINEAR_SRGB);
-      data.push_back(pixel.values[0]);
-      data.push_back(pixel.values[1]);
-      data.push_back(pixel.values[2]);
+      channels[0][column] = pixel.values[0];
+      channels[1][column] = pixel.values[1];
+      channels[2][column] = pixel.values[2];
     }
-  }
 
-  int status = TINYEXR_SUCCESS;
-  if (INT_MAX < columns || INT_MAX < rows) {
-    status = TINYEXR_ERROR_INVALID_DATA;
-  } else {
-    status = SaveEXR(data.data(), static_cast<int>(columns),
-                     static_cast<int>(rows), 3, 1, m_path.c_str(), nullptr);
-  }
+    size_t channel = 3;
+    for (const auto& aov : aovs) {
+      size_t num_channels = aov.channels.size();
+      const float* values = aov.values.data() + row * columns * num_channels;
+      for (size_t i = 0; i < num_channels; i++, channel++) {
+        for (size_t column = 0; column < columns; column++) {
+          channels[channel][column] = values[column * num_channels + i];
+        }
+      }
+    }
+  };
 
-  if (status != TINYEXR_SUCCESS) {
+  size_t num_threads =
+      std::max(std::thread::hardware_concurrency(), (unsigned int)1);
+  if (!WriteExr(m_path, columns, rows, channel_names, pixel_type,
+                compression, num_threads, read_row)) {
     std::cerr << "ERROR: Failed to write to output file: " << m_path
               << std::endl;
     exit(EXIT_FAILURE);
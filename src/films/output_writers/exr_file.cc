@@ -0,0 +1,415 @@
+#include "src/films/output_writers/exr_file.h"
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "zlib.h"
+
+namespace iris {
+namespace {
+
+// Each block is compressed on its own, so the number of blocks in flight
+// bounds the memory used by the writer.
+static const size_t kBlocksInFlightPerThread = 4;
+
+static const uint8_t kHalf = 1;
+static const uint8_t kFloat = 2;
+
+size_t RowsPerBlock(ExrCompression compression) {
+  switch (compression) {
+    case ExrCompression::NONE:
+    case ExrCompression::ZIPS:
+      return 1;
+    case ExrCompression::ZIP:
+      return 16;
+  }
+
+  assert(false);
+  return 1;
+}
+
+uint8_t CompressionCode(ExrCompression compression) {
+  switch (compression) {
+    case ExrCompression::NONE:
+      return 0;
+    case ExrCompression::ZIPS:
+      return 2;
+    case ExrCompression::ZIP:
+      return 3;
+  }
+
+  assert(false);
+  return 0;
+}
+
+// Rounds to the nearest half, with ties to even, and to infinity on overflow.
+uint16_t FloatToHalf(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+
+  uint32_t sign = bits & 0x80000000u;
+  bits ^= sign;
+
+  uint32_t result;
+  if (bits >= 0x47800000u) {
+    result = (bits > 0x7F800000u) ? 0x7E00u : 0x7C00u;
+  } else if (bits < 0x38800000u) {
+    // Adding 0.5 aligns the mantissa of a subnormal half with the low bits of
+    // the float and rounds it in the floating point unit.
+    static const uint32_t kSubnormalMagic = 126u << 23;
+    float magic;
+    memcpy(&magic, &kSubnormalMagic, sizeof(magic));
+
+    float sum;
+    memcpy(&sum, &bits, sizeof(sum));
+    sum += magic;
+
+    memcpy(&result, &sum, sizeof(result));
+    result -= kSubnormalMagic;
+  } else {
+    uint32_t odd = (bits >> 13) & 1u;
+    bits += 0xC8000FFFu + odd;
+    result = bits >> 13;
+  }
+
+  return static_cast<uint16_t>((sign >> 16) | result);
+}
+
+void AppendUint32(uint32_t value, std::vector<unsigned char>* output) {
+  for (size_t i = 0; i < 4; i++) {
+    output->push_back(static_cast<unsigned char>(value >> (8 * i)));
+  }
+}
+
+void AppendUint64(uint64_t value, std::vector<unsigned char>* output) {
+  for (size_t i = 0; i < 8; i++) {
+    output->push_back(static_cast<unsigned char>(value >> (8 * i)));
+  }
+}
+
+void AppendFloat(float value, std::vector<unsigned char>* output) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  AppendUint32(bits, output);
+}
+
+void AppendString(const std::string& value,
+                  std::vector<unsigned char>* output) {
+  output->insert(output->end(), value.begin(), value.end());
+  output->push_back(0);
+}
+
+void AppendAttribute(const std::string& name, const std::string& type,
+                     const std::vector<unsigned char>& value,
+                     std::vector<unsigned char>* output) {
+  AppendString(name, output);
+  AppendString(type, output);
+  AppendUint32(static_cast<uint32_t>(value.size()), output);
+  output->insert(output->end(), value.begin(), value.end());
+}
+
+std::vector<unsigned char> Header(
+    size_t num_columns, size_t num_rows,
+    const std::vector<std::string>& sorted_channels, uint8_t pixel_type,
+    ExrCompression compression) {
+  std::vector<unsigned char> header;
+  AppendUint32(20000630u, &header);
+  AppendUint32(2u, &header);
+
+  std::vector<unsigned char> value;
+  for (const auto& channel : sorted_channels) {
+    AppendString(channel, &value);
+    AppendUint32(pixel_type, &value);
+    AppendUint32(0u, &value);  // pLinear and reserved
+    AppendUint32(1u, &value);  // xSampling
+    AppendUint32(1u, &value);  // ySampling
+  }
+  value.push_back(0);
+  AppendAttribute("channels", "chlist", value, &header);
+
+  value.assign(1, CompressionCode(compression));
+  AppendAttribute("compression", "compression", value, &header);
+
+  value.clear();
+  AppendUint32(0u, &value);
+  AppendUint32(0u, &value);
+  AppendUint32(static_cast<uint32_t>(num_columns - 1), &value);
+  AppendUint32(static_cast<uint32_t>(num_rows - 1), &value);
+  AppendAttribute("dataWindow", "box2i", value, &header);
+  AppendAttribute("displayWindow", "box2i", value, &header);
+
+  value.assign(1, 0);  // INCREASING_Y
+  AppendAttribute("lineOrder", "lineOrder", value, &header);
+
+  value.clear();
+  AppendFloat(1.0f, &value);
+  AppendAttribute("pixelAspectRatio", "float", value, &header);
+
+  value.clear();
+  AppendFloat(0.0f, &value);
+  AppendFloat(0.0f, &value);
+  AppendAttribute("screenWindowCenter", "v2f", value, &header);
+
+  value.clear();
+  AppendFloat(1.0f, &value);
+  AppendAttribute("screenWindowWidth", "float", value, &header);
+
+  header.push_back(0);
+
+  return header;
+}
+
+// The ZIP compression of OpenEXR splits the bytes of the block into two
+// halves holding the even and odd bytes and replaces each byte with its
+// difference from the previous one before deflating them.
+void Predict(const std::vector<unsigned char>& raw,
+             std::vector<unsigned char>* output) {
+  output->resize(raw.size());
+
+  size_t half = (raw.size() + 1) / 2;
+  for (size_t i = 0; i < raw.size(); i++) {
+    (*output)[(i % 2 == 0) ? i / 2 : half + i / 2] = raw[i];
+  }
+
+  unsigned char previous = (*output)[0];
+  for (size_t i = 1; i < output->size(); i++) {
+    unsigned char current = (*output)[i];
+    (*output)[i] = static_cast<unsigned char>(current - previous + 128);
+    previous = current;
+  }
+}
+
+struct Block {
+  size_t first_row;
+  std::vector<unsigned char> data;
+};
+
+class BlockEncoder {
+ public:
+  BlockEncoder(size_t num_columns, size_t num_rows,
+               const std::vector<std::string>& channels,
+               ExrPixelType pixel_type, ExrCompression compression,
+               const ExrReadRow& read_row);
+
+  const std::vector<std::string>& SortedChannels() const {
+    return m_sorted_channels;
+  }
+
+  size_t NumBlocks() const {
+    return (m_num_rows + m_rows_per_block - 1) / m_rows_per_block;
+  }
+
+  // Returns the data of the chunk of the file holding the block, preceded by
+  // its first row and the size of the data.
+  std::vector<unsigned char> Encode(size_t block);
+
+ private:
+  size_t m_num_columns;
+  size_t m_num_rows;
+  size_t m_num_channels;
+  std::vector<std::string> m_sorted_channels;
+  std::vector<size_t> m_channel_order;
+  ExrPixelType m_pixel_type;
+  ExrCompression m_compression;
+  size_t m_rows_per_block;
+  const ExrReadRow& m_read_row;
+};
+
+BlockEncoder::BlockEncoder(size_t num_columns, size_t num_rows,
+                           const std::vector<std::string>& channels,
+                           ExrPixelType pixel_type,
+                           ExrCompression compression,
+                           const ExrReadRow& read_row)
+    : m_num_columns(num_columns),
+      m_num_rows(num_rows),
+      m_num_channels(channels.size()),
+      m_pixel_type(pixel_type),
+      m_compression(compression),
+      m_rows_per_block(RowsPerBlock(compression)),
+      m_read_row(read_row) {
+  for (size_t i = 0; i < channels.size(); i++) {
+    m_channel_order.push_back(i);
+  }
+
+  // OpenEXR requires the channels to be stored in alphabetical order.
+  std::sort(m_channel_order.begin(), m_channel_order.end(),
+            [&](size_t left, size_t right) {
+              return channels[left] < channels[right];
+            });
+
+  for (size_t index : m_channel_order) {
+    m_sorted_channels.push_back(channels[index]);
+  }
+}
+
+std::vector<unsigned char> BlockEncoder::Encode(size_t block) {
+  size_t first_row = block * m_rows_per_block;
+  size_t end_row = std::min(first_row + m_rows_per_block, m_num_rows);
+
+  std::vector<float> values(m_num_channels * m_num_columns);
+  std::vector<float*> channels;
+  for (size_t i = 0; i < m_num_channels; i++) {
+    channels.push_back(values.data() + i * m_num_columns);
+  }
+
+  size_t value_size = (m_pixel_type == ExrPixelType::HALF) ? 2 : 4;
+  std::vector<unsigned char> raw;
+  raw.reserve((end_row - first_row) * values.size() * value_size);
+
+  for (size_t row = first_row; row < end_row; row++) {
+    m_read_row(row, channels);
+
+    for (size_t index : m_channel_order) {
+      const float* channel = channels[index];
+      if (m_pixel_type == ExrPixelType::HALF) {
+        for (size_t column = 0; column < m_num_columns; column++) {
+          uint16_t half = FloatToHalf(channel[column]);
+          raw.push_back(static_cast<unsigned char>(half));
+          raw.push_back(static_cast<unsigned char>(half >> 8));
+        }
+      } else {
+        for (size_t column = 0; column < m_num_columns; column++) {
+          AppendFloat(channel[column], &raw);
+        }
+      }
+    }
+  }
+
+  // Blocks that do not shrink when compressed are stored uncompressed.
+  std::vector<unsigned char> compressed;
+  if (m_compression != ExrCompression::NONE) {
+    std::vector<unsigned char> predicted;
+    Predict(raw, &predicted);
+
+    uLongf compressed_size = compressBound(predicted.size());
+    compressed.resize(compressed_size);
+    int status = compress2(compressed.data(), &compressed_size,
+                           predicted.data(), predicted.size(),
+                           Z_DEFAULT_COMPRESSION);
+    if (status != Z_OK || raw.size() <= compressed_size) {
+      compressed.clear();
+    } else {
+      compressed.resize(compressed_size);
+    }
+  }
+
+  const std::vector<unsigned char>& data =
+      compressed.empty() ? raw : compressed;
+
+  std::vector<unsigned char> result;
+  result.reserve(8 + data.size());
+  AppendUint32(static_cast<uint32_t>(first_row), &result);
+  AppendUint32(static_cast<uint32_t>(data.size()), &result);
+  result.insert(result.end(), data.begin(), data.end());
+
+  return result;
+}
+
+}  // namespace
+
+bool WriteExr(const std::string& path, size_t num_columns, size_t num_rows,
+              const std::vector<std::string>& channels,
+              ExrPixelType pixel_type, ExrCompression compression,
+              size_t num_threads, const ExrReadRow& read_row) {
+  assert(num_threads != 0);
+
+  if (num_columns == 0 || num_rows == 0 || INT32_MAX < num_columns ||
+      INT32_MAX < num_rows || channels.empty()) {
+    return false;
+  }
+
+  BlockEncoder encoder(num_columns, num_rows, channels, pixel_type,
+                       compression, read_row);
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    return false;
+  }
+
+  std::vector<unsigned char> header =
+      Header(num_columns, num_rows, encoder.SortedChannels(),
+             (pixel_type == ExrPixelType::HALF) ? kHalf : kFloat,
+             compression);
+  file.write(reinterpret_cast<const char*>(header.data()), header.size());
+
+  // The offset table precedes the blocks, so it is written once they are.
+  size_t num_blocks = encoder.NumBlocks();
+  uint64_t offset_table = header.size();
+  std::vector<unsigned char> offsets(8 * num_blocks, 0);
+  file.write(reinterpret_cast<const char*>(offsets.data()), offsets.size());
+  offsets.clear();
+
+  size_t blocks_in_flight = kBlocksInFlightPerThread * num_threads;
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::map<size_t, std::vector<unsigned char>> encoded;
+  size_t next_block = 0;
+  size_t next_write = 0;
+
+  auto worker = [&]() {
+    for (;;) {
+      size_t block;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&]() {
+          return num_blocks <= next_block ||
+                 next_block < next_write + blocks_in_flight;
+        });
+
+        if (num_blocks <= next_block) {
+          return;
+        }
+
+        block = next_block++;
+      }
+
+      std::vector<unsigned char> chunk = encoder.Encode(block);
+
+      std::lock_guard<std::mutex> lock(mutex);
+      encoded[block] = std::move(chunk);
+      condition.notify_all();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; i++) {
+    threads.emplace_back(worker);
+  }
+
+  uint64_t offset = offset_table + 8 * num_blocks;
+  for (size_t block = 0; block < num_blocks; block++) {
+    std::vector<unsigned char> chunk;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      condition.wait(lock, [&]() { return encoded.count(block) != 0; });
+      chunk = std::move(encoded[block]);
+      encoded.erase(block);
+      next_write = block + 1;
+      condition.notify_all();
+    }
+
+    file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+    AppendUint64(offset, &offsets);
+    offset += chunk.size();
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  file.seekp(offset_table);
+  file.write(reinterpret_cast<const char*>(offsets.data()), offsets.size());
+  file.close();
+
+  return !file.fail();
+}
+
+}  // namespace iris
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef _SRC_FILMS_OUTPUT_WRITER_EXR_FILE_
+#define _SRC_FILMS_OUTPUT_WRITER_EXR_FILE_
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace iris {
+
+enum class ExrCompression { NONE, ZIPS, ZIP };
+enum class ExrPixelType { HALF, FLOAT };
+
+// Fills in the values of one row of the image for each channel, in the order
+// in which the channels were passed to WriteExr. Called concurrently for
+// different rows.
+typedef std::function<void(size_t row, const std::vector<float*>& channels)>
+    ExrReadRow;
+
+// Writes a scanline OpenEXR file. The rows are read, converted, and
+// compressed in blocks on num_threads threads and each block is written to
+// the file as soon as the blocks before it have been, so only a bounded
+// number of blocks are held in memory at once regardless of the size of the
+// image. Returns false if the file could not be written.
+bool WriteExr(const std::string& path, size_t num_columns, size_t num_rows,
+              const std::vector<std::string>& channels,
+              ExrPixelType pixel_type, ExrCompression compression,
+              size_t num_threads, const ExrReadRow& read_row);
+
+}  // namespace iris
+
+#endif  // _SRC_FILMS_OUTPUT_WRITER_EXR_FILE_
\ No newline at end of file
@@ -12,7 +12,8 @@ namespace {
 class PfmWriter final : public OutputWriterBase {
  public:
   static std::unique_ptr<OutputWriterBase> Create(absl::string_view file_name);
-  void Write(const Framebuffer& framebuffer);
+  void Write(const Framebuffer& framebuffer,
+             const std::vector<AovBuffer>& aovs);
 
  private:
   PfmWriter(std::string path);
@@ -30,9 +31,16 @@ std::unique_ptr<OutputWriterBase> PfmWriter::Create(
 PfmWriter::PfmWriter(std::string path)
     : m_lock_file(LockFile::Create(path)), m_path(std::move(path)) {}
 
-void PfmWriter::Write(const Framebuffer& framebuffer) {
+void PfmWriter::Write(const Framebuffer& framebuffer,
+                      const std::vector<AovBuffer>& aovs) {
   m_lock_file.reset();
 
+  if (!aovs.empty()) {
+    std::cerr << "WARNING: pfm output does not support aovs; they will not "
+                 "be written"
+              << std::endl;
+  }
+
   ISTATUS status = WriteToPfmFile(framebuffer.get(), m_path.c_str(),
                                   COLOR_SPACE_LINEAR_SRGB);
   switch (status) {
@@ -2,14 +2,18 @@
 #define _SRC_FILMS_OUTPUT_WRITER_RESULT_
 
 #include <memory>
+#include <vector>
 
+#include "src/common/aov.h"
 #include "src/common/pointer_types.h"
 
 namespace iris {
 
 class OutputWriterBase {
  public:
-  virtual void Write(const Framebuffer& framebuffer) = 0;
+  // Each AOV has the same size as the framebuffer.
+  virtual void Write(const Framebuffer& framebuffer,
+                     const std::vector<AovBuffer>& aovs) = 0;
   virtual ~OutputWriterBase() {}
 };
 
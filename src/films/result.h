@@ -1,14 +1,24 @@
 #ifndef _SRC_FILMS_RESULT_
 #define _SRC_FILMS_RESULT_
 
-#include <utility>
+#include <tuple>
 
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "src/common/aov.h"
+#include "src/common/pixel_bounds.h"
 #include "src/common/pointer_types.h"
 #include "src/films/output_writers/result.h"
 
 namespace iris {
 
-typedef std::pair<Framebuffer, OutputWriter> FilmResult;
+// The framebuffer always has the full resolution of the image. If pixel
+// bounds are present, only the pixels within them are rendered and written.
+// Each of the AOVs is rendered and written alongside the image.
+typedef std::tuple<Framebuffer, OutputWriter, absl::optional<PixelBounds>,
+                   std::vector<Aov>>
+    FilmResult;
 
 }  // namespace iris
 
@@ -0,0 +1,197 @@
+#include "src/integrators/aov.h"
+
+#include <cassert>
+#include <cmath>
+
+#include "iris_physx/iris_physx.h"
+#include "src/common/error.h"
+#include "src/randoms/sample_key.h"
+
+namespace iris {
+namespace {
+
+struct AovIntegratorContext {
+  AovAccumulator* accumulator;
+  PCCOLOR_INTEGRATOR color_integrator;
+};
+
+ISTATUS AovIntegratorIntegrate(
+    const void* context, PCRAY ray, PSHAPE_RAY_TRACER ray_tracer,
+    PLIGHT_SAMPLER light_sampler, PVISIBILITY_TESTER visibility_tester,
+    PBSDF_ALLOCATOR bsdf_allocator, PSPECTRUM_COMPOSITOR spectrum_compositor,
+    PREFLECTOR_COMPOSITOR reflector_compositor, PRANDOM rng,
+    float_t epsilon, PCSPECTRUM* spectrum) {
+  const AovIntegratorContext* integrator =
+      static_cast<const AovIntegratorContext*>(context);
+  *spectrum = nullptr;
+
+  uint64_t pixel = GetSampleKey().pixel;
+  assert(pixel != kNoPixel);
+
+  PCSPECTRUM emitted;
+  PCBSDF bsdf;
+  POINT3 hit_point;
+  VECTOR3 surface_normal, shading_normal;
+  ISTATUS status = ShapeRayTracerTraceClosestHit(
+      ray_tracer, *ray, epsilon, &emitted, &bsdf, &hit_point, &surface_normal,
+      &shading_normal);
+  if (status == ISTATUS_NO_INTERSECTION) {
+    integrator->accumulator->AddMiss(pixel);
+    return ISTATUS_SUCCESS;
+  }
+
+  if (status != ISTATUS_SUCCESS) {
+    return status;
+  }
+
+  shading_normal = VectorNormalize(shading_normal, nullptr, nullptr);
+  float_t depth = VectorLength(PointSubtract(hit_point, ray->origin));
+
+  // Surfaces that only emit light have no BSDF and a black albedo.
+  COLOR3 albedo = {{(float_t)0.0, (float_t)0.0, (float_t)0.0},
+                   COLOR_SPACE_LINEAR_SRGB};
+  if (bsdf) {
+    PCREFLECTOR reflector;
+    BSDF_SAMPLE_TYPE type;
+    VECTOR3 outgoing;
+    float_t pdf;
+    status = BsdfSample(bsdf, ray->direction, shading_normal, rng,
+                        reflector_compositor, &reflector, &type, &outgoing,
+                        &pdf);
+    if (status != ISTATUS_SUCCESS) {
+      return status;
+    }
+
+    status = ColorIntegratorComputeReflectorColor(integrator->color_integrator,
+                                                  reflector, &albedo);
+    if (status != ISTATUS_SUCCESS) {
+      return status;
+    }
+  }
+
+  integrator->accumulator->AddHit(pixel, albedo, shading_normal, depth);
+
+  return ISTATUS_SUCCESS;
+}
+
+ISTATUS AovIntegratorDuplicate(const void* context, PINTEGRATOR* duplicate);
+
+const INTEGRATOR_VTABLE kAovIntegratorVTable = {
+    AovIntegratorIntegrate, AovIntegratorDuplicate, nullptr};
+
+ISTATUS AovIntegratorDuplicate(const void* context, PINTEGRATOR* duplicate) {
+  return IntegratorAllocate(&kAovIntegratorVTable, context,
+                            sizeof(AovIntegratorContext),
+                            alignof(AovIntegratorContext), duplicate);
+}
+
+AovBuffer MakeBuffer(Aov aov, const PixelBounds& bounds) {
+  AovBuffer result;
+  result.aov = aov;
+  switch (aov) {
+    case Aov::ALBEDO:
+      result.name = "albedo";
+      result.channels = {"R", "G", "B"};
+      break;
+    case Aov::NORMAL:
+      result.name = "normal";
+      result.channels = {"X", "Y", "Z"};
+      break;
+    case Aov::DEPTH:
+      result.name = "depth";
+      result.channels = {"Z"};
+      break;
+  }
+
+  result.num_columns = bounds.NumColumns();
+  result.num_rows = bounds.NumRows();
+  result.values.reserve(result.channels.size() * bounds.NumColumns() *
+                        bounds.NumRows());
+
+  return result;
+}
+
+}  // namespace
+
+AovAccumulator::AovAccumulator(const std::vector<Aov>& aovs,
+                               size_t num_columns, const PixelBounds& bounds,
+                               PCCOLOR_INTEGRATOR color_integrator)
+    : m_aovs(aovs),
+      m_num_columns(num_columns),
+      m_bounds(bounds),
+      m_color_integrator(color_integrator),
+      m_sums(bounds.NumColumns() * bounds.NumRows(),
+             PixelSums{{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, 0.0f, 0}) {}
+
+Integrator AovAccumulator::CreateIntegrator() {
+  AovIntegratorContext context = {this, m_color_integrator};
+
+  Integrator result;
+  ISTATUS status = IntegratorAllocate(
+      &kAovIntegratorVTable, &context, sizeof(AovIntegratorContext),
+      alignof(AovIntegratorContext), result.release_and_get_address());
+  SuccessOrOOM(status);
+
+  return result;
+}
+
+AovAccumulator::PixelSums& AovAccumulator::Sums(uint64_t pixel) {
+  size_t column = pixel % m_num_columns;
+  size_t row = pixel / m_num_columns;
+  assert(m_bounds.min_column <= column && column < m_bounds.max_column);
+  assert(m_bounds.min_row <= row && row < m_bounds.max_row);
+
+  return m_sums[(row - m_bounds.min_row) * m_bounds.NumColumns() +
+                (column - m_bounds.min_column)];
+}
+
+void AovAccumulator::AddMiss(uint64_t pixel) { Sums(pixel).num_samples += 1; }
+
+void AovAccumulator::AddHit(uint64_t pixel, const COLOR3& albedo,
+                            const VECTOR3& normal, float_t depth) {
+  PixelSums& sums = Sums(pixel);
+
+  COLOR3 rgb = ColorConvert(albedo, COLOR_SPACE_LINEAR_SRGB);
+  for (size_t i = 0; i < 3; i++) {
+    sums.albedo[i] += static_cast<float>(rgb.values[i]);
+  }
+
+  sums.normal[0] += static_cast<float>(normal.x);
+  sums.normal[1] += static_cast<float>(normal.y);
+  sums.normal[2] += static_cast<float>(normal.z);
+  sums.depth += static_cast<float>(depth);
+  sums.num_samples += 1;
+}
+
+std::vector<AovBuffer> AovAccumulator::Resolve() const {
+  std::vector<AovBuffer> result;
+  for (Aov aov : m_aovs) {
+    AovBuffer buffer = MakeBuffer(aov, m_bounds);
+    for (const auto& sums : m_sums) {
+      float scale = (sums.num_samples != 0)
+                        ? 1.0f / static_cast<float>(sums.num_samples)
+                        : 0.0f;
+      switch (aov) {
+        case Aov::ALBEDO:
+          for (size_t i = 0; i < 3; i++) {
+            buffer.values.push_back(sums.albedo[i] * scale);
+          }
+          break;
+        case Aov::NORMAL:
+          for (size_t i = 0; i < 3; i++) {
+            buffer.values.push_back(sums.normal[i] * scale);
+          }
+          break;
+        case Aov::DEPTH:
+          buffer.values.push_back(sums.depth * scale);
+          break;
+      }
+    }
+
+    result.push_back(std::move(buffer));
+  }
+
+  return result;
+}
+
+}  // namespace iris
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef _SRC_INTEGRATORS_AOV_
+#define _SRC_INTEGRATORS_AOV_
+
+#include <cstdint>
+#include <vector>
+
+#include "src/common/aov.h"
+#include "src/common/pixel_bounds.h"
+#include "src/common/pointer_types.h"
+
+namespace iris {
+
+// Accumulates the AOVs of the first hits of the samples traced by its
+// integrators, which return no light. The pixel of each sample is taken from
+// the sample key, so the integrators must be used with an image sampler that
+// sets it, such as that of ProgressiveSampler. Integrators may run
+// concurrently as long as they do not trace samples of the same pixel at the
+// same time.
+class AovAccumulator {
+ public:
+  AovAccumulator(const std::vector<Aov>& aovs, size_t num_columns,
+                 const PixelBounds& bounds,
+                 PCCOLOR_INTEGRATOR color_integrator);
+
+  // The integrator must not outlive the accumulator.
+  Integrator CreateIntegrator();
+
+  void AddMiss(uint64_t pixel);
+  void AddHit(uint64_t pixel, const COLOR3& albedo, const VECTOR3& normal,
+              float_t depth);
+
+  // Returns the average of each AOV over the samples of each pixel within
+  // the bounds.
+  std::vector<AovBuffer> Resolve() const;
+
+ private:
+  struct PixelSums {
+    float albedo[3];
+    float normal[3];
+    float depth;
+    uint32_t num_samples;
+  };
+
+  PixelSums& Sums(uint64_t pixel);
+
+  std::vector<Aov> m_aovs;
+  size_t m_num_columns;
+  PixelBounds m_bounds;
+  PCCOLOR_INTEGRATOR m_color_integrator;
+  std::vector<PixelSums> m_sums;
+};
+
+}  // namespace iris
+
+#endif  // _SRC_INTEGRATORS_AOV_
\ No newline at end of file
@@ -33,13 +33,21 @@ IntegratorResult ParsePath(Parameters& parameters) {
   parameters.Match(lightsamplestrategy, maxdepth, rrminbounces,
                    rrminprobability, rrthreshold);
 
-  Integrator integrator;
-  ISTATUS status = PathTracerAllocate(
-      rrminbounces.Get(), maxdepth.Get() - 1, *rrminprobability.Get(),
-      *rrthreshold.Get(), integrator.release_and_get_address());
-  SuccessOrOOM(status);
-
-  return std::make_pair(std::move(integrator),
+  uint8_t min_bounces = rrminbounces.Get();
+  uint8_t max_bounces = maxdepth.Get() - 1;
+  float_t min_probability = *rrminprobability.Get();
+  float_t threshold = *rrthreshold.Get();
+  IntegratorFactory factory = [=]() {
+    Integrator integrator;
+    ISTATUS status =
+        PathTracerAllocate(min_bounces, max_bounces, min_probability,
+                           threshold, integrator.release_and_get_address());
+    SuccessOrOOM(status);
+
+    return integrator;
+  };
+
+  return std::make_pair(std::move(factory),
                         ParseLightStrategy(lightsamplestrategy.Get()));
 }  // namespace iris
 
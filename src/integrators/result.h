@@ -1,6 +1,7 @@
 #ifndef _SRC_INTEGRATORS_RESULT_
 #define _SRC_INTEGRATORS_RESULT_
 
+#include <functional>
 #include <utility>
 
 #include "src/common/pointer_types.h"
@@ -8,7 +9,11 @@
 
 namespace iris {
 
-typedef std::pair<Integrator, LightSamplerFactory> IntegratorResult;
+// Returns a new integrator each time it is called so that renders running
+// concurrently can each have their own.
+typedef std::function<Integrator()> IntegratorFactory;
+
+typedef std::pair<IntegratorFactory, LightSamplerFactory> IntegratorResult;
 
 }  // namespace iris
 
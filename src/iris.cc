@@ -1,8 +1,10 @@
+#include <fstream>
 #include <iostream>
 #include <sstream>
 #include <thread>
 
 #ifdef INSTRUMENTED_BUILD
+#include <gperftools/heap-profiler.h>
 #include <gperftools/profiler.h>
 #endif  // INSTRUMENTED_BUILD
 
@@ -10,6 +12,10 @@
 #include "absl/flags/parse.h"
 #include "absl/flags/usage.h"
 #include "absl/flags/usage_config.h"
+#include "src/common/perf_counters.h"
+#include "src/common/pointer_counters.h"
+#include "src/common/run_statistics.h"
+#include "src/common/trace.h"
 #include "src/directives/color_space.h"
 #include "src/directives/parser.h"
 #include "src/render.h"
@@ -19,6 +25,18 @@ ABSL_FLAG(
     std::string, cpu_profile, "",
     "If non-empty, enable CPU profiling and save traces to the file specified. "
     "If empty, CPU profiling is disabled and no output is generated.");
+
+ABSL_FLAG(std::string, heap_profile, "",
+          "If non-empty, enable heap profiling and save profiles to files "
+          "beginning with the prefix specified. A profile is dumped after each "
+          "scene is parsed and after each scene is rendered in addition to "
+          "the profiles dumped periodically by the heap profiler. If empty, "
+          "heap profiling is disabled and no output is generated.");
+
+ABSL_FLAG(bool, pointer_counts, false,
+          "If true, the number of live objects held by the frontend of each "
+          "pointer type is printed after each scene is parsed and after each "
+          "scene is rendered. Use --heap_profile for their sizes.");
 #endif  // INSTRUMENTED_BUILD
 
 ABSL_FLAG(float_t, epsilon, 0.001,
@@ -34,6 +52,33 @@ ABSL_FLAG(bool, report_progress, true,
           "If false, no status bar or progress reporting will be displayed "
           "while rendering.");
 
+ABSL_FLAG(bool, print_stats, false,
+          "If true, the time, CPU time, and peak memory use of each phase of "
+          "parsing and rendering, summed over every render, and counts of "
+          "the data loaded are printed once rendering is done.");
+
+ABSL_FLAG(bool, perf_counters, false,
+          "If true, the hardware performance counters of every thread are "
+          "recorded for each phase and the instructions per cycle, L1 data "
+          "and last level cache misses per sample, and branch miss rate of "
+          "each phase are added to the statistics of --print_stats, which "
+          "are then printed even if --print_stats is false, and to the last "
+          "record of each phase of --progress_format=json. The counts of a "
+          "thread are only added once it exits, so those of threads that "
+          "outlive a phase, such as the one writing --progress_file, are "
+          "added to the phase in which they exit. Requires perf_event_open "
+          "to be permitted.");
+
+ABSL_FLAG(std::string, stats_file, "",
+          "If non-empty, the statistics of --print_stats are written to this "
+          "file as JSON once rendering is done.");
+
+ABSL_FLAG(std::string, trace_file, "",
+          "If non-empty, a timeline of the directives parsed, files loaded, "
+          "acceleration structures built, tiles rendered on each thread, and "
+          "phases of each render is written to this file in the Chrome trace "
+          "event format once rendering is done.");
+
 ABSL_FLAG(bool, welcome_message, true,
           "If true, the welcome message will not be shown.");
 
@@ -182,6 +227,30 @@ int main(int argc, char** argv) {
     absl::SetFlag(&FLAGS_num_threads, std::thread::hardware_concurrency());
   }
 
+  // The counters are only inherited by threads created after they are opened.
+  if (absl::GetFlag(FLAGS_perf_counters) && !iris::EnablePerfCounters()) {
+    std::cerr << "WARNING: Failed to open hardware performance counters"
+              << std::endl;
+  }
+
+  const auto& trace_file = absl::GetFlag(FLAGS_trace_file);
+  if (!trace_file.empty()) {
+    iris::EnableTracing();
+  }
+
+#ifdef INSTRUMENTED_BUILD
+  if (absl::GetFlag(FLAGS_pointer_counts)) {
+    iris::EnablePointerCounters();
+  }
+
+  const auto& heap_profile = absl::GetFlag(FLAGS_heap_profile);
+  if (!heap_profile.empty()) {
+    HeapProfilerStart(heap_profile.c_str());
+    iris::SetMemoryCheckpointHook(
+        [](const std::string& name) { HeapProfilerDump(name.c_str()); });
+  }
+#endif  // INSTRUMENTED_BUILD
+
   iris::Parser parser;
   if (unparsed.size() == 1) {
     parser = iris::Parser::Create(std::cin);
@@ -190,7 +259,7 @@ int main(int argc, char** argv) {
   }
 
   if (absl::GetFlag(FLAGS_welcome_message)) {
-    std::cout << VersionString();
+    iris::MessageOutput() << VersionString();
   }
 
 #ifdef INSTRUMENTED_BUILD
@@ -211,7 +280,31 @@ int main(int argc, char** argv) {
 
 #ifdef INSTRUMENTED_BUILD
   ProfilerStop();
+  if (!heap_profile.empty()) {
+    HeapProfilerStop();
+  }
 #endif  // INSTRUMENTED_BUILD
 
+  if (absl::GetFlag(FLAGS_print_stats) || iris::PerfCountersEnabled()) {
+    iris::WriteRunStatistics(iris::MessageOutput());
+  }
+
+  if (!trace_file.empty() && !iris::WriteTrace(trace_file)) {
+    std::cerr << "ERROR: Failed to write trace file: " << trace_file
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  const auto& stats_file = absl::GetFlag(FLAGS_stats_file);
+  if (!stats_file.empty()) {
+    std::ofstream output(stats_file);
+    iris::WriteRunStatisticsJson(output);
+    if (!output) {
+      std::cerr << "ERROR: Failed to write stats file: " << stats_file
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
   return EXIT_SUCCESS;
 }
\ No newline at end of file
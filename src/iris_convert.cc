@@ -0,0 +1,260 @@
+#include <fstream>
+#include <iostream>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "src/common/binary_scene.h"
+#include "src/common/quoted_string.h"
+#include "src/common/tokenizer.h"
+#include "src/shapes/plymesh.h"
+
+namespace {
+
+static const absl::flat_hash_set<absl::string_view> kFloatTypes = {
+    "color", "float",  "normal",  "point", "point3",
+    "rgb",   "vector", "vector3", "xyz"};
+
+static const absl::string_view kIntType = "integer";
+
+struct ParameterValues {
+  std::string declaration;
+  std::vector<std::string> values;
+  bool bracketed;
+};
+
+absl::optional<std::pair<absl::string_view, absl::string_view>>
+SplitDeclaration(absl::string_view token) {
+  auto unquoted = iris::UnquoteToken(token);
+  if (!unquoted) {
+    return absl::nullopt;
+  }
+
+  std::vector<absl::string_view> type_and_name =
+      absl::StrSplit(*unquoted, " ", absl::SkipEmpty());
+  if (type_and_name.size() != 2) {
+    return absl::nullopt;
+  }
+
+  return std::make_pair(type_and_name[0], type_and_name[1]);
+}
+
+ParameterValues ReadParameter(absl::string_view declaration,
+                              iris::Tokenizer& tokenizer) {
+  ParameterValues result;
+  result.declaration = std::string(declaration);
+  result.bracketed = false;
+
+  auto token = tokenizer.Next();
+  if (!token) {
+    return result;
+  }
+
+  if (*token != "[") {
+    result.values.push_back(std::string(*token));
+    return result;
+  }
+
+  result.bracketed = true;
+  for (token = tokenizer.Next(); token && *token != "]";
+       token = tokenizer.Next()) {
+    result.values.push_back(std::string(*token));
+  }
+
+  return result;
+}
+
+template <typename Type, bool (*ParseFunc)(absl::string_view, Type*)>
+bool ParseValues(const std::vector<std::string>& tokens,
+                 std::vector<Type>* values) {
+  for (const auto& token : tokens) {
+    Type value;
+    if (!ParseFunc(token, &value)) {
+      return false;
+    }
+    values->push_back(value);
+  }
+  return true;
+}
+
+// Numeric values are stored as arrays. Everything else, including values that
+// fail to parse, is stored as tokens so that the renderer reports any errors.
+void WriteParameter(const ParameterValues& parameter,
+                    iris::BinarySceneWriter& writer) {
+  writer.AddToken(parameter.declaration);
+
+  auto type_and_name = SplitDeclaration(parameter.declaration);
+  if (type_and_name && kFloatTypes.contains(type_and_name->first)) {
+    std::vector<float> values;
+    if (ParseValues<float, absl::SimpleAtof>(parameter.values, &values)) {
+      writer.AddFloats(values);
+      return;
+    }
+  }
+
+  if (type_and_name && type_and_name->first == kIntType) {
+    std::vector<int32_t> values;
+    if (ParseValues<int32_t, absl::SimpleAtoi>(parameter.values, &values)) {
+      writer.AddInts(values);
+      return;
+    }
+  }
+
+  if (parameter.bracketed) {
+    writer.AddToken("[");
+  }
+
+  for (const auto& value : parameter.values) {
+    writer.AddToken(value);
+  }
+
+  if (parameter.bracketed) {
+    writer.AddToken("]");
+  }
+}
+
+// Replaces a plymesh with a trianglemesh holding the contents of the PLY file
+void ConvertPlyMesh(iris::Tokenizer& tokenizer,
+                    iris::BinarySceneWriter& writer) {
+  std::vector<ParameterValues> parameters;
+  absl::optional<std::string> filename;
+  for (auto token = tokenizer.Peek(); token && SplitDeclaration(*token);
+       token = tokenizer.Peek()) {
+    std::string declaration(*tokenizer.Next());
+    auto parameter = ReadParameter(declaration, tokenizer);
+    if (declaration == "\"string filename\"" && parameter.values.size() == 1) {
+      filename.emplace();
+      if (!iris::ParseQuotedTokenToString(parameter.values[0], &*filename)) {
+        filename = absl::nullopt;
+      }
+    }
+    parameters.push_back(std::move(parameter));
+  }
+
+  if (!filename) {
+    writer.AddToken("Shape");
+    writer.AddToken("\"plymesh\"");
+    for (const auto& parameter : parameters) {
+      WriteParameter(parameter, writer);
+    }
+    return;
+  }
+
+  std::vector<POINT3> vertices;
+  std::vector<VECTOR3> normals;
+  std::vector<std::pair<float_t, float_t>> uvs;
+  std::vector<size_t> faces;
+  iris::ReadPlyMesh(*filename, tokenizer.ResolvePath(*filename), &vertices,
+                    &normals, &uvs, &faces);
+
+  if ((size_t)INT32_MAX < vertices.size()) {
+    std::cerr << "ERROR: PLY file contained too many vertices to convert: "
+              << *filename << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  writer.AddToken("Shape");
+  writer.AddToken("\"trianglemesh\"");
+
+  std::vector<float> values;
+  for (const auto& vertex : vertices) {
+    values.push_back(vertex.x);
+    values.push_back(vertex.y);
+    values.push_back(vertex.z);
+  }
+  writer.AddToken("\"point P\"");
+  writer.AddFloats(values);
+
+  std::vector<int32_t> indices(faces.begin(), faces.end());
+  writer.AddToken("\"integer indices\"");
+  writer.AddInts(indices);
+
+  if (!normals.empty()) {
+    values.clear();
+    for (const auto& normal : normals) {
+      values.push_back(normal.x);
+      values.push_back(normal.y);
+      values.push_back(normal.z);
+    }
+    writer.AddToken("\"normal N\"");
+    writer.AddFloats(values);
+  }
+
+  if (!uvs.empty()) {
+    values.clear();
+    for (const auto& uv : uvs) {
+      values.push_back(uv.first);
+      values.push_back(uv.second);
+    }
+    writer.AddToken("\"float uv\"");
+    writer.AddFloats(values);
+  }
+
+  for (const auto& parameter : parameters) {
+    if (parameter.declaration != "\"string filename\"") {
+      WriteParameter(parameter, writer);
+    }
+  }
+}
+
+void Convert(iris::Tokenizer& tokenizer, iris::BinarySceneWriter& writer) {
+  for (auto token = tokenizer.Next(); token; token = tokenizer.Next()) {
+    if (*token == "Include") {
+      auto quoted_path = tokenizer.Next();
+      std::string path;
+      if (!quoted_path ||
+          !iris::ParseQuotedTokenToString(*quoted_path, &path)) {
+        std::cerr << "ERROR: Failed to parse Include parameter" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+      tokenizer.Include(path);
+      continue;
+    }
+
+    if (*token == "Shape" && tokenizer.Peek() == "\"plymesh\"") {
+      tokenizer.Next();
+      ConvertPlyMesh(tokenizer, writer);
+      continue;
+    }
+
+    if (SplitDeclaration(*token)) {
+      std::string declaration(*token);
+      WriteParameter(ReadParameter(declaration, tokenizer), writer);
+      continue;
+    }
+
+    writer.AddToken(*token);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  absl::SetProgramUsageMessage(
+      "Converts a pbrt file, along with any files it includes and any PLY "
+      "meshes it references, into the binary scene format read by iris. "
+      "Relative paths are resolved against the location of the converted "
+      "file, so it should be written to the same directory as the input."
+      "\n\nUsage: iris_convert [options] input output");
+
+  auto unparsed = absl::ParseCommandLine(argc, argv);
+  if (unparsed.size() != 3) {
+    std::cerr << "ERROR: An input file and an output file are required"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  auto tokenizer = iris::Tokenizer::CreateFromFile(unparsed[1]);
+  iris::BinarySceneWriter writer;
+  Convert(tokenizer, writer);
+
+  std::ofstream output(unparsed[2], std::ios::binary);
+  if (!output || !writer.Write(output)) {
+    std::cerr << "ERROR: Failed to write file: " << unparsed[2] << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
\ No newline at end of file
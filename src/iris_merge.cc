@@ -0,0 +1,122 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+#include "src/common/error.h"
+#include "src/common/pixel_bounds.h"
+#include "src/films/output_writers/parser.h"
+#include "src/samplers/checkpoint.h"
+
+namespace {
+
+iris::Checkpoint Read(const std::string& path) {
+  auto checkpoint = iris::ReadCheckpoint(path);
+  if (!checkpoint) {
+    std::cerr << "ERROR: Failed to open checkpoint file: " << path
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  return std::move(*checkpoint);
+}
+
+bool Overlaps(const iris::PixelBounds& left, const iris::PixelBounds& right) {
+  return left.min_column < right.max_column &&
+         right.min_column < left.max_column && left.min_row < right.max_row &&
+         right.min_row < left.max_row;
+}
+
+// Renders drawing from overlapping ranges of samples are not independent, so
+// combining them does not reduce noise as much as their sample counts imply.
+void CheckSampleRanges(const std::vector<iris::Checkpoint>& checkpoints,
+                       const std::vector<std::string>& paths) {
+  for (size_t i = 0; i < checkpoints.size(); i++) {
+    for (size_t j = i + 1; j < checkpoints.size(); j++) {
+      if (Overlaps(checkpoints[i].pixel_bounds, checkpoints[j].pixel_bounds) &&
+          checkpoints[i].sample_offset < checkpoints[j].first_sample_index &&
+          checkpoints[j].sample_offset < checkpoints[i].first_sample_index) {
+        std::cerr << "WARNING: Checkpoints " << paths[i] << " and "
+                  << paths[j] << " contain overlapping ranges of samples"
+                  << std::endl;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  absl::SetProgramUsageMessage(
+      "Combines the checkpoints written by renders of the same image, such "
+      "as those of processes rendering with different values of "
+      "--sample_offset or different --pixel_bounds, into a single image. "
+      "Each pixel is the average of the samples it received in every "
+      "render and pixels that were not rendered are black."
+      "\n\nUsage: iris_merge [options] output input...");
+
+  auto unparsed = absl::ParseCommandLine(argc, argv);
+  if (unparsed.size() < 3) {
+    std::cerr << "ERROR: An output file and at least one input file are "
+                 "required"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<std::string> paths(unparsed.begin() + 2, unparsed.end());
+  std::vector<iris::Checkpoint> checkpoints;
+  for (const auto& path : paths) {
+    checkpoints.push_back(Read(path));
+    if (checkpoints.back().num_columns != checkpoints[0].num_columns ||
+        checkpoints.back().num_rows != checkpoints[0].num_rows) {
+      std::cerr << "ERROR: Checkpoint has different dimensions than "
+                << paths[0] << ": " << path << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  CheckSampleRanges(checkpoints, paths);
+
+  size_t num_columns = checkpoints[0].num_columns;
+  size_t num_rows = checkpoints[0].num_rows;
+
+  std::vector<iris::PixelStatistics> merged(num_columns * num_rows,
+                                            iris::PixelStatistics());
+  for (const auto& checkpoint : checkpoints) {
+    const iris::PixelBounds& bounds = checkpoint.pixel_bounds;
+    for (size_t row = 0; row < bounds.NumRows(); row++) {
+      for (size_t column = 0; column < bounds.NumColumns(); column++) {
+        const iris::PixelStatistics& statistics =
+            checkpoint.statistics[row * bounds.NumColumns() + column];
+        iris::PixelStatistics& pixel =
+            merged[(bounds.min_row + row) * num_columns + bounds.min_column +
+                   column];
+        for (size_t j = 0; j < 3; j++) {
+          pixel.xyz_sum[j] += statistics.xyz_sum[j];
+        }
+        pixel.luminance_sum_of_squares += statistics.luminance_sum_of_squares;
+        pixel.num_samples += statistics.num_samples;
+        pixel.num_passes += statistics.num_passes;
+      }
+    }
+  }
+
+  iris::Framebuffer framebuffer;
+  ISTATUS status = FramebufferAllocate(num_columns, num_rows,
+                                       framebuffer.release_and_get_address());
+  iris::SuccessOrOOM(status);
+
+  for (size_t row = 0; row < num_rows; row++) {
+    for (size_t column = 0; column < num_columns; column++) {
+      size_t pixel = row * num_columns + column;
+      status = FramebufferSetPixel(framebuffer.get(), column, row,
+                                   iris::Mean(merged[pixel]));
+      iris::SuccessOrOOM(status);
+    }
+  }
+
+  iris::ParseOutputWriter(unparsed[1])->Write(framebuffer, {});
+
+  return EXIT_SUCCESS;
+}
\ No newline at end of file
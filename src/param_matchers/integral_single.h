@@ -47,6 +47,8 @@ typedef IntegralSingleValueMatcher<uint8_t, 1, UINT8_MAX>
     NonZeroSingleUInt8Matcher;
 typedef IntegralSingleValueMatcher<uint16_t, 1, UINT16_MAX>
     NonZeroSingleUInt16Matcher;
+typedef IntegralSingleValueMatcher<uint32_t, 0, UINT32_MAX>
+    SingleUInt32Matcher;
 typedef IntegralSingleValueMatcher<size_t, 1, SIZE_MAX>
     NonZeroSingleSizeTMatcher;
 
@@ -1,19 +1,22 @@
 #include "src/randoms/parser.h"
 
 #include "src/randoms/pcg.h"
+#include "src/randoms/philox.h"
 
 namespace iris {
 namespace {
 
-const Directive::Implementations<Random> kImpls = {{"pcg", ParsePcg}};
+const Directive::Implementations<RandomResult> kImpls = {
+    {"pcg", ParsePcg},
+    {"philox", ParsePhilox}};
 
 }  // namespace
 
-Random ParseRandom(Directive& directive) {
+RandomResult ParseRandom(Directive& directive) {
   return directive.Invoke(kImpls);
 }
 
-Random CreateDefaultRandom() {
+RandomResult CreateDefaultRandom() {
   Parameters parameters;
   return ParsePcg(parameters);
 }
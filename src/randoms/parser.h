@@ -1,13 +1,13 @@
 #ifndef _SRC_RANDOMS_PARSER_
 #define _SRC_RANDOMS_PARSER_
 
-#include "src/common/pointer_types.h"
 #include "src/common/directive.h"
+#include "src/randoms/result.h"
 
 namespace iris {
 
-Random ParseRandom(Directive& directive);
-Random CreateDefaultRandom();
+RandomResult ParseRandom(Directive& directive);
+RandomResult CreateDefaultRandom();
 
 }  // namespace iris
 
@@ -2,6 +2,8 @@
 
 #include "iris_advanced_toolkit/pcg_random.h"
 #include "src/common/error.h"
+#include "src/param_matchers/integral_single.h"
+#include "src/randoms/seed.h"
 
 namespace iris {
 namespace {
@@ -9,18 +11,65 @@ namespace {
 static const uint64_t kPcgRandomDefaultState = 0x853c49e6748fea9bULL;
 static const uint64_t kPcgRandomDefaultOutputSequence = 0xda3e39cb94b95bdbULL;
 
-}  // namespace
+static const uint32_t kPcgRandomDefaultSeed = 0;
+static const uint32_t kPcgRandomDefaultStream = 0;
+
+uint64_t Hash(uint64_t value) {
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdULL;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ULL;
+  value ^= value >> 33;
+  return value;
+}
 
-Random ParsePcg(Parameters& parameters) {
-  parameters.Match();
+uint64_t InitialState(uint32_t seed) {
+  if (seed == 0) {
+    return kPcgRandomDefaultState;
+  }
 
-  Random result;
-  ISTATUS status = PermutedCongruentialRandomAllocate(
-      kPcgRandomDefaultState, kPcgRandomDefaultOutputSequence,
-      result.release_and_get_address());
-  SuccessOrOOM(status);
+  return Hash(kPcgRandomDefaultState + seed);
+}
+
+// Every stream and every pass and tile within a stream uses a different
+// output sequence. The sequence is selected by hashing since PCG streams with
+// nearby increments are correlated.
+uint64_t OutputSequence(uint32_t stream, uint32_t first_sample_index,
+                        size_t tile_index) {
+  if (stream == 0 && first_sample_index == 0 && tile_index == 0) {
+    return kPcgRandomDefaultOutputSequence;
+  }
+
+  uint64_t result = Hash(kPcgRandomDefaultOutputSequence ^
+                         ((uint64_t)stream << 32 | first_sample_index));
+  if (tile_index != 0) {
+    result = Hash(result ^ tile_index);
+  }
 
   return result;
 }
 
+}  // namespace
+
+RandomResult ParsePcg(Parameters& parameters) {
+  SingleUInt32Matcher seed("seed", false, kPcgRandomDefaultSeed);
+  SingleUInt32Matcher stream("stream", false, kPcgRandomDefaultStream);
+  parameters.Match(seed, stream);
+
+  uint64_t state = InitialState(SeedOverride(seed.Get()));
+  uint32_t stream_index = StreamOverride(stream.Get());
+  RandomFactory factory = [state, stream_index](uint32_t first_sample_index,
+                                                 size_t tile_index) {
+    Random result;
+    ISTATUS status = PermutedCongruentialRandomAllocate(
+        state, OutputSequence(stream_index, first_sample_index, tile_index),
+        result.release_and_get_address());
+    SuccessOrOOM(status);
+
+    return result;
+  };
+
+  return std::make_pair(std::move(factory), false);
+}
+
 }  // namespace iris
\ No newline at end of file
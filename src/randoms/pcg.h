@@ -1,12 +1,12 @@
 #ifndef _SRC_RANDOMS_CIE_
 #define _SRC_RANDOMS_CIE_
 
-#include "src/common/pointer_types.h"
 #include "src/common/parameters.h"
+#include "src/randoms/result.h"
 
 namespace iris {
 
-Random ParsePcg(Parameters& parameters);
+RandomResult ParsePcg(Parameters& parameters);
 
 }  // namespace iris
 
@@ -0,0 +1,161 @@
+#include "src/randoms/philox.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "iris_advanced/iris_advanced.h"
+#include "src/common/error.h"
+#include "src/param_matchers/integral_single.h"
+#include "src/randoms/sample_key.h"
+#include "src/randoms/seed.h"
+
+namespace iris {
+namespace {
+
+static const uint32_t kPhiloxDefaultSeed = 0;
+static const uint32_t kPhiloxDefaultStream = 0;
+
+static const uint32_t kPhiloxMultiplier0 = 0xD2511F53u;
+static const uint32_t kPhiloxMultiplier1 = 0xCD9E8D57u;
+static const uint32_t kPhiloxWeyl0 = 0x9E3779B9u;
+static const uint32_t kPhiloxWeyl1 = 0xBB67AE85u;
+static const int kPhiloxRounds = 10;
+
+// The values drawn while tracing a sample are numbered by dimension and are
+// taken four at a time from the block whose counter is formed from the
+// dimension, the sample index, and the pixel. Threads without a sample key,
+// such as when rendering with an image sampler that does not set one, instead
+// draw from a sequence selected by the index of their replica.
+struct PhiloxContext {
+  std::array<uint32_t, 2> key;
+  uint64_t pixel;
+  uint32_t sample_index;
+  uint32_t replica;
+  uint32_t next_replica;
+  uint64_t dimension;
+  std::array<uint32_t, 4> block;
+};
+
+uint32_t NextValue(PhiloxContext* context) {
+  const SampleKey& sample = GetSampleKey();
+  if (sample.pixel != context->pixel ||
+      sample.sample_index != context->sample_index) {
+    context->pixel = sample.pixel;
+    context->sample_index = sample.sample_index;
+    context->dimension = 0;
+  }
+
+  if (context->dimension % 4 == 0) {
+    uint64_t block_index = context->dimension / 4;
+    std::array<uint32_t, 4> counter;
+    if (context->pixel == kNoPixel) {
+      counter = {static_cast<uint32_t>(block_index),
+                 static_cast<uint32_t>(block_index >> 32), context->replica,
+                 UINT32_MAX};
+    } else {
+      counter = {static_cast<uint32_t>(block_index), context->sample_index,
+                 static_cast<uint32_t>(context->pixel),
+                 static_cast<uint32_t>(context->pixel >> 32)};
+    }
+    context->block = Philox4x32(counter, context->key);
+  }
+
+  return context->block[context->dimension++ % 4];
+}
+
+ISTATUS PhiloxGenerateFloat(void* context, float_t minimum, float_t maximum,
+                            float_t* random_value) {
+  PhiloxContext* philox = static_cast<PhiloxContext*>(context);
+  float_t unit = (NextValue(philox) >> 8) * (float_t)0x1p-24;
+  float_t value = minimum + (maximum - minimum) * unit;
+  if (minimum < maximum) {
+    value = std::min(value, std::nextafter(maximum, minimum));
+  }
+  *random_value = value;
+  return ISTATUS_SUCCESS;
+}
+
+ISTATUS PhiloxGenerateIndex(void* context, size_t upper_bound,
+                            size_t* random_value) {
+  PhiloxContext* philox = static_cast<PhiloxContext*>(context);
+  uint64_t value = NextValue(philox);
+  if (upper_bound <= UINT32_MAX) {
+    *random_value = static_cast<size_t>((value * upper_bound) >> 32);
+  } else {
+    value = (value << 32) | NextValue(philox);
+    *random_value = static_cast<size_t>(value % upper_bound);
+  }
+  return ISTATUS_SUCCESS;
+}
+
+ISTATUS PhiloxReplicate(void* context, PRANDOM* replica);
+
+const RANDOM_VTABLE kPhiloxVTable = {PhiloxGenerateFloat, PhiloxGenerateIndex,
+                                     PhiloxReplicate, nullptr};
+
+Random AllocatePhilox(const PhiloxContext& context) {
+  Random result;
+  ISTATUS status =
+      RandomAllocate(&kPhiloxVTable, &context, sizeof(PhiloxContext),
+                     alignof(PhiloxContext), result.release_and_get_address());
+  SuccessOrOOM(status);
+
+  return result;
+}
+
+ISTATUS PhiloxReplicate(void* context, PRANDOM* replica) {
+  PhiloxContext* philox = static_cast<PhiloxContext*>(context);
+
+  PhiloxContext replica_context = *philox;
+  replica_context.replica = philox->next_replica++;
+  replica_context.next_replica = 0;
+
+  return RandomAllocate(&kPhiloxVTable, &replica_context,
+                        sizeof(PhiloxContext), alignof(PhiloxContext),
+                        replica);
+}
+
+}  // namespace
+
+std::array<uint32_t, 4> Philox4x32(const std::array<uint32_t, 4>& counter,
+                                   const std::array<uint32_t, 2>& key) {
+  std::array<uint32_t, 4> result = counter;
+  std::array<uint32_t, 2> round_key = key;
+  for (int i = 0; i < kPhiloxRounds; i++) {
+    uint64_t product0 = (uint64_t)kPhiloxMultiplier0 * result[0];
+    uint64_t product1 = (uint64_t)kPhiloxMultiplier1 * result[2];
+    result = {static_cast<uint32_t>(product1 >> 32) ^ result[1] ^ round_key[0],
+              static_cast<uint32_t>(product1),
+              static_cast<uint32_t>(product0 >> 32) ^ result[3] ^ round_key[1],
+              static_cast<uint32_t>(product0)};
+    round_key[0] += kPhiloxWeyl0;
+    round_key[1] += kPhiloxWeyl1;
+  }
+  return result;
+}
+
+// The output for a sample does not depend on which pass or tile renders it, so
+// the first sample index and tile index are not used.
+RandomResult ParsePhilox(Parameters& parameters) {
+  SingleUInt32Matcher seed("seed", false, kPhiloxDefaultSeed);
+  SingleUInt32Matcher stream("stream", false, kPhiloxDefaultStream);
+  parameters.Match(seed, stream);
+
+  PhiloxContext context;
+  context.key = {SeedOverride(seed.Get()), StreamOverride(stream.Get())};
+  context.pixel = kNoPixel;
+  context.sample_index = 0;
+  context.replica = 0;
+  context.next_replica = 1;
+  context.dimension = 0;
+  context.block = {};
+
+  RandomFactory factory = [context](uint32_t first_sample_index,
+                                    size_t tile_index) {
+    return AllocatePhilox(context);
+  };
+
+  return std::make_pair(std::move(factory), true);
+}
+
+}  // namespace iris
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef _SRC_RANDOMS_PHILOX_
+#define _SRC_RANDOMS_PHILOX_
+
+#include <array>
+#include <cstdint>
+
+#include "src/common/parameters.h"
+#include "src/randoms/result.h"
+
+namespace iris {
+
+// The Philox4x32-10 block function. Each evaluation maps a counter to four
+// independent random values and has no other state, so values for any number
+// of counters can be generated independently and in any order.
+std::array<uint32_t, 4> Philox4x32(const std::array<uint32_t, 4>& counter,
+                                   const std::array<uint32_t, 2>& key);
+
+RandomResult ParsePhilox(Parameters& parameters);
+
+}  // namespace iris
+
+#endif  // _SRC_RANDOMS_PHILOX_
\ No newline at end of file
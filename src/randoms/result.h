@@ -0,0 +1,27 @@
+#ifndef _SRC_RANDOMS_RESULT_
+#define _SRC_RANDOMS_RESULT_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include "src/common/pointer_types.h"
+
+namespace iris {
+
+// Creates the random number generator used to render the pass of an image
+// whose samples begin at first_sample_index, or the tile of the pass with
+// tile_index. Each pass and tile receives an independent stream so that its
+// output does not depend on the passes or tiles rendered before it, in this
+// process or in any other, or on the thread that renders it.
+typedef std::function<Random(uint32_t first_sample_index, size_t tile_index)>
+    RandomFactory;
+
+// The second element is true if the generator derives its output from the
+// sample key, which is only set by the progressive image sampler.
+typedef std::pair<RandomFactory, bool> RandomResult;
+
+}  // namespace iris
+
+#endif  // _SRC_RANDOMS_RESULT_
\ No newline at end of file
@@ -0,0 +1,14 @@
+#include "src/randoms/sample_key.h"
+
+namespace iris {
+namespace {
+
+thread_local SampleKey current_key = {kNoPixel, 0};
+
+}  // namespace
+
+void SetSampleKey(const SampleKey& key) { current_key = key; }
+
+const SampleKey& GetSampleKey() { return current_key; }
+
+}  // namespace iris
\ No newline at end of file
@@ -0,0 +1,25 @@
+#ifndef _SRC_RANDOMS_SAMPLE_KEY_
+#define _SRC_RANDOMS_SAMPLE_KEY_
+
+#include <cstdint>
+
+namespace iris {
+
+// Identifies the sample that the calling thread is about to trace. Image
+// samplers that know the pixel and sample index of each sample set the key so
+// that counter-based random number generators can derive their output from
+// the sample rather than from the order in which samples are traced.
+struct SampleKey {
+  uint64_t pixel;
+  uint32_t sample_index;
+};
+
+// The pixel of the key of a thread that has not set one.
+static const uint64_t kNoPixel = UINT64_MAX;
+
+void SetSampleKey(const SampleKey& key);
+const SampleKey& GetSampleKey();
+
+}  // namespace iris
+
+#endif  // _SRC_RANDOMS_SAMPLE_KEY_
\ No newline at end of file
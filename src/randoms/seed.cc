@@ -0,0 +1,42 @@
+#include "src/randoms/seed.h"
+
+#include <iostream>
+
+#include "absl/flags/flag.h"
+
+ABSL_FLAG(int64_t, random_seed, -1,
+          "If non-negative, overrides the seed of the random number generator "
+          "of every render. Processes rendering the same image with different "
+          "seeds produce independent noise.");
+ABSL_FLAG(int64_t, random_stream, -1,
+          "If non-negative, overrides the stream of the random number "
+          "generator of every render. Processes rendering the same image "
+          "with different streams produce independent noise.");
+
+namespace iris {
+namespace {
+
+uint32_t Override(int64_t value, const char* name, uint32_t scene_value) {
+  if (value < 0) {
+    return scene_value;
+  }
+
+  if (UINT32_MAX < value) {
+    std::cerr << "ERROR: " << name << " must be less than 2^32" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  return static_cast<uint32_t>(value);
+}
+
+}  // namespace
+
+uint32_t SeedOverride(uint32_t seed) {
+  return Override(absl::GetFlag(FLAGS_random_seed), "random_seed", seed);
+}
+
+uint32_t StreamOverride(uint32_t stream) {
+  return Override(absl::GetFlag(FLAGS_random_stream), "random_stream", stream);
+}
+
+}  // namespace iris
\ No newline at end of file
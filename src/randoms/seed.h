@@ -0,0 +1,16 @@
+#ifndef _SRC_RANDOMS_SEED_
+#define _SRC_RANDOMS_SEED_
+
+#include <cstdint>
+
+namespace iris {
+
+// Returns the seed or stream to use for a random number generator whose scene
+// parameters specified the values passed in. The values are replaced by those
+// of --random_seed and --random_stream if they are set.
+uint32_t SeedOverride(uint32_t seed);
+uint32_t StreamOverride(uint32_t stream);
+
+}  // namespace iris
+
+#endif  // _SRC_RANDOMS_SEED_
\ No newline at end of file
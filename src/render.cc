@@ -1,17 +1,178 @@
 #include "src/render.h"
 
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "absl/flags/flag.h"
+#include "absl/time/time.h"
 #include "iris_camera_toolkit/status_bar_progress_reporter.h"
 #include "iris_physx_toolkit/sample_tracer.h"
+#include "src/common/denoiser.h"
 #include "src/common/error.h"
+#include "src/common/live_preview.h"
+#include "src/common/numa.h"
 #include "src/common/ostream.h"
+#include "src/common/pixel_bounds.h"
+#include "src/common/pointer_counters.h"
+#include "src/common/progress_telemetry.h"
+#include "src/common/run_statistics.h"
+#include "src/common/tile_scheduler.h"
+#include "src/common/worker_pool.h"
 #include "src/directives/parser.h"
+#include "src/integrators/aov.h"
+
+ABSL_FLAG(absl::Duration, time_limit, absl::InfiniteDuration(),
+          "If set, each image is rendered in progressive passes and rendering "
+          "stops once this much time has elapsed, writing the image formed "
+          "by the passes completed so far. Must be greater than zero.");
+ABSL_FLAG(uint32_t, sample_offset, 0,
+          "If non-zero, each image is rendered in progressive passes using "
+          "the samples of each pixel beginning at this index. Independent "
+          "processes rendering the same image with disjoint ranges of "
+          "samples, such as offsets that are multiples of pixelsamples, can "
+          "have their checkpoints combined with iris_merge.");
+ABSL_FLAG(std::string, checkpoint_file, "",
+          "If set, each image is rendered in progressive passes and the "
+          "state of the render is periodically saved to this file so that "
+          "an interrupted render can be continued with --resume. When the "
+          "input contains more than one render, the index of the render is "
+          "appended to the name of the file for each render after the "
+          "first.");
+ABSL_FLAG(absl::Duration, checkpoint_interval, absl::Minutes(5),
+          "The minimum amount of time between writes of --checkpoint_file. "
+          "Must not be negative.");
+ABSL_FLAG(bool, resume, false,
+          "If true, each render continues from the state saved in "
+          "--checkpoint_file if that file exists. Requires "
+          "--checkpoint_file.");
+ABSL_FLAG(uint32_t, tile_size, 0,
+          "If non-zero, each image is rendered in progressive passes that are "
+          "split into square tiles with sides of this many pixels. The tiles "
+          "are scheduled by the frontend onto the rendering threads, which "
+          "steal tiles from each other once they run out, and the time each "
+          "thread spent rendering is reported once the image is done.");
+ABSL_FLAG(std::string, tile_order, "hilbert",
+          "The order in which the tiles of --tile_size are assigned to "
+          "threads. One of scanline, morton, or hilbert.");
+ABSL_FLAG(std::string, numa_mode, "off",
+          "How rendering threads are placed on machines with more than one "
+          "NUMA node. One of off, shared, or replicated. If shared, the "
+          "threads are pinned to the nodes in equal blocks and share one "
+          "copy of the scene. If replicated, each node also builds its own "
+          "copy of the top level acceleration structure of the scene, which "
+          "uses more memory but keeps the reads of that structure local to "
+          "the node. Nothing else is replicated: the meshes, the "
+          "acceleration structures of object instances, and the textures are "
+          "shared by every node. Either mode renders in tiles of "
+          "--tile_size, or of 32 pixels if it is not set.");
+ABSL_FLAG(uint32_t, num_workers, 0,
+          "If non-zero, each image is split into square regions of 4 by 4 "
+          "tiles of --tile_size, or of 32 pixels if it is not set, that are "
+          "rendered by this many worker processes forked once the scene has "
+          "been parsed. The rendering threads are divided evenly between the "
+          "workers and a worker that dies is replaced. The image is the same "
+          "as one rendered in a single process with the same tile size. "
+          "Cannot be combined with --time_limit, --checkpoint_file, or "
+          "--numa_mode.");
+ABSL_FLAG(std::string, preview_file, "",
+          "If set, each image is rendered in progressive passes and the "
+          "image formed by the passes completed so far is published to this "
+          "file, which viewers can memory map, as described in "
+          "src/common/live_preview.h. Place the file in /dev/shm to keep it "
+          "in shared memory. When the input contains more than one render, "
+          "the index of the render is appended to the name of the file for "
+          "each render after the first.");
+ABSL_FLAG(absl::Duration, preview_interval, absl::Seconds(1),
+          "The minimum amount of time between updates of --preview_file. "
+          "Must not be negative.");
+ABSL_FLAG(std::string, progress_format, "bar",
+          "How progress is reported while rendering. One of bar or json. If "
+          "json, records describing the progress, throughput, and memory use "
+          "of each phase of each render are appended to --progress_file one "
+          "per line, as described in src/common/progress_telemetry.h. Samples "
+          "are counted as each progressive pass or tile finishes, so renders "
+          "that are neither progressive nor tiled only count them once they "
+          "are done; setting --tile_size counts them throughout.");
+ABSL_FLAG(std::string, progress_file, "/dev/stdout",
+          "The file to which --progress_format=json appends its records. An "
+          "inherited file descriptor N can be named as /dev/fd/N. If this is "
+          "stdout, everything else the frontend would write to stdout is "
+          "written to stderr instead.");
+ABSL_FLAG(absl::Duration, progress_interval, absl::Seconds(1),
+          "The amount of time between the records of --progress_format=json. "
+          "Must be greater than zero.");
+ABSL_FLAG(bool, denoise, false,
+          "If true, noise is filtered from each image before it is written "
+          "using the albedo, normal, and depth of the first hit of each "
+          "pixel as a guide. These AOVs are rendered for the filter even if "
+          "the film does not request them, in which case they are not "
+          "written.");
+ABSL_FLAG(uint32_t, denoise_radius, 5,
+          "The radius in pixels of the filter of --denoise. Larger radii "
+          "remove more noise at the cost of time and detail. Must be greater "
+          "than zero.");
 
 namespace iris {
+namespace {
+
+static const uint32_t kDefaultNumaTileSize = 32;
+static const uint32_t kDefaultWorkerTileSize = 32;
+static const uint32_t kWorkerRegionTiles = 4;
+static const uint32_t kMaxAovSamplesPerPixel = 16;
+
+// The output writers have no notion of a data window, so only the pixels
+// within the bounds are written.
+Framebuffer Crop(const Framebuffer& framebuffer, const PixelBounds& bounds) {
+  Framebuffer result;
+  ISTATUS status = FramebufferAllocate(
+      bounds.NumColumns(), bounds.NumRows(), result.release_and_get_address());
+  SuccessOrOOM(status);
+
+  for (size_t row = 0; row < bounds.NumRows(); row++) {
+    for (size_t column = 0; column < bounds.NumColumns(); column++) {
+      COLOR3 color;
+      status = FramebufferGetPixel(framebuffer.get(),
+                                   bounds.min_column + column,
+                                   bounds.min_row + row, &color);
+      assert(status == ISTATUS_SUCCESS);
+
+      status = FramebufferSetPixel(result.get(), column, row, color);
+      assert(status == ISTATUS_SUCCESS);
+    }
+  }
+
+  return result;
+}
+
+}  // namespace
+
+std::ostream& MessageOutput() {
+  if (absl::GetFlag(FLAGS_progress_format) != "json") {
+    return std::cout;
+  }
+
+  struct stat progress_file, standard_output;
+  if (stat(absl::GetFlag(FLAGS_progress_file).c_str(), &progress_file) != 0 ||
+      fstat(STDOUT_FILENO, &standard_output) != 0 ||
+      progress_file.st_dev != standard_output.st_dev ||
+      progress_file.st_ino != standard_output.st_ino) {
+    return std::cout;
+  }
+
+  return std::cerr;
+}
 
-std::pair<Framebuffer, OutputWriter> RenderToFramebuffer(
+RenderResult RenderToFramebuffer(
     Parser& parser, size_t render_index, float_t epsilon, size_t num_threads,
     bool report_progress,
     absl::optional<SpectralRepresentation> spectral_representation_override,
@@ -20,19 +181,237 @@ std::pair<Framebuffer, OutputWriter> RenderToFramebuffer(
   assert(isfinite(epsilon) && (float_t)0.0 <= epsilon);
   assert(num_threads != 0);
 
+  // Progress is only reported as JSON from the frontend, which counts the
+  // samples of each pass or tile as it finishes.
+  std::unique_ptr<ProgressTelemetry> telemetry;
+  std::string progress_format = absl::GetFlag(FLAGS_progress_format);
+  if (progress_format == "json") {
+    absl::Duration progress_interval = absl::GetFlag(FLAGS_progress_interval);
+    if (progress_interval <= absl::ZeroDuration()) {
+      std::cerr << "ERROR: progress_interval must be greater than zero"
+                << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+    if (report_progress) {
+      telemetry.reset(new ProgressTelemetry(absl::GetFlag(FLAGS_progress_file),
+                                            render_index, progress_interval));
+      report_progress = false;
+    }
+  } else if (progress_format != "bar") {
+    std::cerr << "ERROR: Unsupported progress_format: " << progress_format
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  absl::Duration time_limit = absl::GetFlag(FLAGS_time_limit);
+  if (time_limit <= absl::ZeroDuration()) {
+    std::cerr << "ERROR: time_limit must be greater than zero" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  uint32_t sample_offset = absl::GetFlag(FLAGS_sample_offset);
+  if (UINT32_MAX - UINT16_MAX < sample_offset) {
+    std::cerr << "ERROR: sample_offset must be less than "
+              << UINT32_MAX - UINT16_MAX << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  absl::optional<ProgressiveSampler::CheckpointOptions> checkpoint;
+  std::string checkpoint_file = absl::GetFlag(FLAGS_checkpoint_file);
+  if (!checkpoint_file.empty()) {
+    if (render_index != 0) {
+      checkpoint_file += "." + std::to_string(render_index);
+    }
+
+    checkpoint = ProgressiveSampler::CheckpointOptions{
+        checkpoint_file, absl::GetFlag(FLAGS_checkpoint_interval),
+        absl::GetFlag(FLAGS_resume)};
+    if (checkpoint->interval < absl::ZeroDuration()) {
+      std::cerr << "ERROR: checkpoint_interval must not be negative"
+                << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  } else if (absl::GetFlag(FLAGS_resume)) {
+    std::cerr << "ERROR: resume requires checkpoint_file" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  std::string numa_mode = absl::GetFlag(FLAGS_numa_mode);
+  if (numa_mode != "off" && numa_mode != "shared" &&
+      numa_mode != "replicated") {
+    std::cerr << "ERROR: Unsupported numa_mode: " << numa_mode << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  bool pin_threads = numa_mode != "off";
+  bool replicate_scene = numa_mode == "replicated";
+
+  bool denoise = absl::GetFlag(FLAGS_denoise);
+  uint32_t denoise_radius = absl::GetFlag(FLAGS_denoise_radius);
+  if (denoise && denoise_radius == 0) {
+    std::cerr << "ERROR: denoise_radius must be greater than zero"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  size_t num_worker_threads = num_threads;
+  uint32_t num_workers = absl::GetFlag(FLAGS_num_workers);
+  if (num_workers != 0) {
+    if (time_limit != absl::InfiniteDuration() || checkpoint || pin_threads) {
+      std::cerr << "ERROR: num_workers cannot be combined with time_limit, "
+                   "checkpoint_file, or numa_mode"
+                << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+    // The threads of the process are split between the workers, while the
+    // coordinator keeps all of them for the passes it runs itself once the
+    // workers are done.
+    num_worker_threads = std::max(num_threads / num_workers, (size_t)1);
+  }
+
+  uint32_t tile_size = absl::GetFlag(FLAGS_tile_size);
+  if (tile_size == 0 && pin_threads) {
+    tile_size = kDefaultNumaTileSize;
+  } else if (tile_size == 0 && num_workers != 0) {
+    tile_size = kDefaultWorkerTileSize;
+  }
+
+  std::unique_ptr<TileScheduler> tile_scheduler;
+  std::unique_ptr<TileScheduler> worker_tile_scheduler;
+  if (tile_size != 0) {
+    std::string tile_order = absl::GetFlag(FLAGS_tile_order);
+
+    TileScheduler::Order order;
+    if (tile_order == "scanline") {
+      order = TileScheduler::Order::SCANLINE;
+    } else if (tile_order == "morton") {
+      order = TileScheduler::Order::MORTON;
+    } else if (tile_order == "hilbert") {
+      order = TileScheduler::Order::HILBERT;
+    } else {
+      std::cerr << "ERROR: Unsupported tile_order: " << tile_order
+                << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+    tile_scheduler.reset(
+        new TileScheduler(num_threads, tile_size, order, pin_threads));
+    if (num_workers != 0) {
+      worker_tile_scheduler.reset(new TileScheduler(
+          num_worker_threads, tile_size, order, pin_threads));
+    }
+  }
+
+  // Each phase of the render is timed until the next one begins or the
+  // render ends.
+  absl::optional<ScopedPhase> phase;
+  auto begin_phase = [&](const char* name, absl::Duration time_limit) {
+    phase.reset();
+    phase.emplace(name);
+    if (telemetry) {
+      telemetry->BeginPhase(name, time_limit);
+    }
+  };
+
+  begin_phase("parse", absl::InfiniteDuration());
+
   auto render_config =
       *parser.Next(spectral_representation_override, rgb_color_space_override,
                    always_compute_reflective_color_override);
+  MemoryCheckpoint("parse", render_index, MessageOutput());
 
-  ISTATUS status = IntegratorPrepare(
-      std::get<5>(render_config).get(), std::get<0>(render_config).get(),
-      std::get<1>(render_config).get(), std::get<6>(render_config).get());
-  SuccessOrOOM(status);
+  std::unique_ptr<LivePreview> preview;
+  std::string preview_file = absl::GetFlag(FLAGS_preview_file);
+  if (!preview_file.empty()) {
+    absl::Duration preview_interval = absl::GetFlag(FLAGS_preview_interval);
+    if (preview_interval < absl::ZeroDuration()) {
+      std::cerr << "ERROR: preview_interval must not be negative"
+                << std::endl;
+      exit(EXIT_FAILURE);
+    }
 
-  SampleTracer sample_tracer;
-  status = PhysxSampleTracerAllocate(std::get<5>(render_config).detach(),
-                                     sample_tracer.release_and_get_address());
-  SuccessOrOOM(status);
+    if (render_index != 0) {
+      preview_file += "." + std::to_string(render_index);
+    }
+
+    size_t num_columns, num_rows;
+    FramebufferGetSize(std::get<8>(render_config).get(), &num_columns,
+                       &num_rows);
+    preview.reset(new LivePreview(preview_file, num_columns, num_rows,
+                                  absl::ToChronoNanoseconds(preview_interval)));
+  }
+
+  // Tiles rendered concurrently each take a sample tracer from the pool of
+  // their NUMA node for as long as they are rendering, so each pool has one
+  // for every thread pinned to the node.
+  std::vector<size_t> num_sample_tracers(1, 1);
+  if (tile_scheduler) {
+    num_sample_tracers.assign(tile_scheduler->NumaNode(num_threads - 1) + 1,
+                              0);
+    for (size_t i = 0; i < num_threads; i++) {
+      num_sample_tracers[tile_scheduler->NumaNode(i)] += 1;
+    }
+  }
+
+  std::vector<Scene> scenes(num_sample_tracers.size());
+  std::vector<std::vector<SampleTracer>> sample_tracers(
+      num_sample_tracers.size());
+  auto prepare_sample_tracers = [&](size_t node,
+                                    const IntegratorFactory& factory) {
+    sample_tracers[node].clear();
+    for (size_t i = 0; i < num_sample_tracers[node]; i++) {
+      Integrator integrator = factory();
+      ISTATUS status = IntegratorPrepare(
+          integrator.get(), scenes[node].get(),
+          std::get<1>(render_config).get(), std::get<6>(render_config).get());
+      SuccessOrOOM(status);
+
+      SampleTracer sample_tracer;
+      status = PhysxSampleTracerAllocate(
+          integrator.detach(), sample_tracer.release_and_get_address());
+      SuccessOrOOM(status);
+
+      sample_tracers[node].push_back(std::move(sample_tracer));
+    }
+  };
+
+  // The scene and sample tracers of each node are allocated on a thread
+  // pinned to the node so that their memory is local to it.
+  auto on_each_numa_node = [&](const std::function<void(size_t)>& prepare) {
+    for (size_t node = 0; node < num_sample_tracers.size(); node++) {
+      if (pin_threads) {
+        std::thread([&, node]() {
+          PinThreadToNumaNode(node);
+          prepare(node);
+        }).join();
+      } else {
+        prepare(node);
+      }
+    }
+  };
+
+  begin_phase("prepare", absl::InfiniteDuration());
+
+  // The acceleration structure of the scene is built here rather than while
+  // parsing, so that replicated scenes build only the copy of each node.
+  Scene shared_scene;
+  if (!replicate_scene) {
+    shared_scene = std::get<0>(render_config)();
+  }
+
+  on_each_numa_node([&](size_t node) {
+    if (replicate_scene) {
+      scenes[node] = std::get<0>(render_config)();
+    } else {
+      scenes[node] = shared_scene;
+    }
+
+    prepare_sample_tracers(node, std::get<5>(render_config));
+  });
+
+  std::mutex sample_tracers_mutex;
 
   ProgressReporter progress_reporter;
   if (report_progress) {
@@ -43,30 +422,282 @@ std::pair<Framebuffer, OutputWriter> RenderToFramebuffer(
       progress_label = "Rendering (" + std::to_string(render_index + 1) + ")";
     }
 
-    status = StatusBarProgressReporterAllocate(
+    ISTATUS status = StatusBarProgressReporterAllocate(
         progress_label.c_str(), progress_reporter.release_and_get_address());
     SuccessOrOOM(status);
   }
 
-  status = IrisCameraRender(
-      std::get<2>(render_config).get(), std::get<3>(render_config).get(),
-      std::get<4>(render_config).get(), sample_tracer.get(),
-      std::get<7>(render_config).get(), std::get<8>(render_config).get(),
-      progress_reporter.get(), epsilon, num_threads);
+  // Tiles are rendered concurrently on the threads of the tile scheduler, each
+  // of which renders its tile on its own without reporting progress.
+  auto render_pass = [&](uint32_t first_sample_index, size_t tile_index,
+                         PCIMAGE_SAMPLER image_sampler,
+                         PFRAMEBUFFER framebuffer) {
+    Random rng =
+        std::get<7>(render_config).first(first_sample_index, tile_index);
 
-  switch (status) {
-    case ISTATUS_SUCCESS:
-      break;
-    case ISTATUS_ALLOCATION_FAILED:
-      ReportOOM();
-    default:
-      std::cerr << "ERROR: " << status << " returned from rendering"
-                << std::endl;
-      exit(EXIT_FAILURE);
+    auto& pool = sample_tracers[CurrentNumaNode()];
+
+    SampleTracer sample_tracer;
+    {
+      std::lock_guard<std::mutex> lock(sample_tracers_mutex);
+      sample_tracer = std::move(pool.back());
+      pool.pop_back();
+    }
+
+    ISTATUS status = IrisCameraRender(
+        std::get<2>(render_config).get(), std::get<3>(render_config).get(),
+        image_sampler, sample_tracer.get(), rng.get(), framebuffer,
+        tile_scheduler ? nullptr : progress_reporter.get(), epsilon,
+        tile_scheduler ? 1 : num_threads);
+
+    switch (status) {
+      case ISTATUS_SUCCESS:
+        break;
+      case ISTATUS_ALLOCATION_FAILED:
+        ReportOOM();
+      default:
+        std::cerr << "ERROR: " << status << " returned from rendering"
+                  << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    std::lock_guard<std::mutex> lock(sample_tracers_mutex);
+    pool.push_back(std::move(sample_tracer));
+  };
+
+  // Generators keyed on the sample require the progressive image sampler.
+  auto& sampler = std::get<4>(render_config);
+  auto& pixel_bounds = std::get<10>(render_config);
+  begin_phase("render", time_limit);
+  absl::Time render_start = absl::Now();
+
+  // Adaptive renders are counted as if each pixel took as many samples as
+  // the pixels that took the most.
+  uint32_t samples_per_pixel = sampler.second.MaxSamples();
+
+  std::ostream& statistics_output = MessageOutput();
+  if (num_workers != 0) {
+    Framebuffer& framebuffer = std::get<8>(render_config);
+
+    size_t num_columns, num_rows;
+    FramebufferGetSize(framebuffer.get(), &num_columns, &num_rows);
+
+    PixelBounds bounds =
+        pixel_bounds.value_or(PixelBounds{0, num_columns, 0, num_rows});
+
+    // The regions are aligned to the tiles of the workers so that the tiles,
+    // and the random number streams chosen by their indices, are the same as
+    // in a render of the whole image.
+    TileScheduler region_grid(1, tile_size * kWorkerRegionTiles,
+                              TileScheduler::Order::HILBERT, false);
+
+    std::vector<PixelBounds> regions;
+    for (const auto& tile : region_grid.Tiles(num_columns, num_rows)) {
+      PixelBounds region{std::max(tile.column, bounds.min_column),
+                         std::min(tile.column + tile.num_columns,
+                                  bounds.max_column),
+                         std::max(tile.row, bounds.min_row),
+                         std::min(tile.row + tile.num_rows, bounds.max_row)};
+      if (region.min_column < region.max_column &&
+          region.min_row < region.max_row) {
+        regions.push_back(region);
+      }
+    }
+
+    auto render_region = [&](const PixelBounds& region,
+                             std::vector<COLOR3>* pixels) {
+      ProgressiveSampler::RenderOptions options = {
+          time_limit, sample_offset, absl::nullopt,
+          worker_tile_scheduler.get(), region, nullptr, nullptr};
+      sampler.second.Render(render_pass, options, framebuffer);
+
+      for (size_t row = region.min_row; row < region.max_row; row++) {
+        for (size_t column = region.min_column; column < region.max_column;
+             column++) {
+          COLOR3 color;
+          ISTATUS status =
+              FramebufferGetPixel(framebuffer.get(), column, row, &color);
+          assert(status == ISTATUS_SUCCESS);
+          pixels->push_back(color);
+        }
+      }
+    };
+
+    auto receive_region = [&](const PixelBounds& region,
+                              const std::vector<COLOR3>& pixels) {
+      auto pixel = pixels.begin();
+      for (size_t row = region.min_row; row < region.max_row; row++) {
+        for (size_t column = region.min_column; column < region.max_column;
+             column++) {
+          ISTATUS status =
+              FramebufferSetPixel(framebuffer.get(), column, row, *pixel++);
+          assert(status == ISTATUS_SUCCESS);
+        }
+      }
+
+      if (telemetry) {
+        telemetry->AddSamples(static_cast<uint64_t>(pixels.size()) *
+                              sampler.second.MaxSamples());
+        telemetry->Poll();
+      }
+
+      // Only the coordinator writes to the preview and each region is
+      // published once, as soon as it arrives.
+      if (preview) {
+        preview->Publish(
+            region,
+            [&](size_t column, size_t row) {
+              return pixels[(row - region.min_row) * region.NumColumns() +
+                            (column - region.min_column)];
+            },
+            /*force=*/true);
+      }
+    };
+
+    if (telemetry) {
+      telemetry->SetTotalSamples(static_cast<uint64_t>(bounds.NumColumns()) *
+                                 bounds.NumRows() *
+                                 sampler.second.MaxSamples());
+    }
+
+    // The workers are forked throughout the run, so progress is only
+    // recorded as regions arrive.
+    if (telemetry) {
+      telemetry->Suspend();
+    }
+
+    WorkerPool worker_pool(num_workers);
+    worker_pool.Run(regions, render_region, receive_region);
+    worker_pool.WriteStatistics(statistics_output);
+
+    if (telemetry) {
+      telemetry->Resume();
+    }
+  } else if (!sampler.first.get() || sampler.second.IsAdaptive() ||
+      std::get<7>(render_config).second ||
+      time_limit != absl::InfiniteDuration() || sample_offset != 0 ||
+      checkpoint || tile_scheduler || pixel_bounds || preview) {
+    ProgressiveSampler::RenderOptions options = {
+        time_limit, sample_offset, checkpoint, tile_scheduler.get(),
+        pixel_bounds, preview.get(), telemetry.get()};
+    samples_per_pixel = sampler.second.Render(render_pass, options,
+                                              std::get<8>(render_config));
+    if (time_limit != absl::InfiniteDuration()) {
+      statistics_output << "Rendered " << samples_per_pixel
+                        << " samples per pixel" << std::endl;
+    }
+    if (tile_scheduler) {
+      tile_scheduler->WriteStatistics(statistics_output);
+    }
+  } else {
+    size_t num_columns, num_rows;
+    FramebufferGetSize(std::get<8>(render_config).get(), &num_columns,
+                       &num_rows);
+    uint64_t total_samples =
+        static_cast<uint64_t>(num_columns) * num_rows * samples_per_pixel;
+
+    if (telemetry) {
+      telemetry->SetTotalSamples(total_samples);
+    }
+
+    render_pass(0, 0, sampler.first.get(), std::get<8>(render_config).get());
+
+    if (telemetry) {
+      telemetry->AddSamples(total_samples);
+    }
   }
 
-  return std::make_pair(std::move(std::get<8>(render_config)),
-                        std::move(std::get<9>(render_config)));
+  if (preview) {
+    preview->Finish();
+  }
+
+  size_t num_columns, num_rows;
+  FramebufferGetSize(std::get<8>(render_config).get(), &num_columns,
+                     &num_rows);
+  PixelBounds render_bounds =
+      pixel_bounds.value_or(PixelBounds{0, num_columns, 0, num_rows});
+  uint64_t num_pixels =
+      static_cast<uint64_t>(render_bounds.NumColumns()) *
+      render_bounds.NumRows();
+  phase->AddSamples(num_pixels * samples_per_pixel);
+
+  MemoryCheckpoint("render", render_index, MessageOutput());
+
+  // The AOVs are rendered in a second pass that reuses the scene of each node
+  // with integrators that record the first hit of each sample. The pass takes
+  // no more samples per pixel than the image did and counts against the same
+  // time limit.
+  const auto& film_aovs = std::get<11>(render_config);
+  std::vector<Aov> aovs = film_aovs;
+  if (denoise) {
+    for (Aov aov : {Aov::ALBEDO, Aov::NORMAL, Aov::DEPTH}) {
+      if (std::find(aovs.begin(), aovs.end(), aov) == aovs.end()) {
+        aovs.push_back(aov);
+      }
+    }
+  }
+
+  std::vector<AovBuffer> aov_buffers;
+  if (!aovs.empty()) {
+    AovAccumulator accumulator(aovs, num_columns, render_bounds,
+                               std::get<6>(render_config).get());
+
+    IntegratorFactory aov_integrators = [&]() {
+      return accumulator.CreateIntegrator();
+    };
+    on_each_numa_node(
+        [&](size_t node) { prepare_sample_tracers(node, aov_integrators); });
+
+    Framebuffer aov_framebuffer;
+    ISTATUS status =
+        FramebufferAllocate(num_columns, num_rows,
+                            aov_framebuffer.release_and_get_address());
+    SuccessOrOOM(status);
+
+    // A time limit that has already expired still renders one sample.
+    absl::Duration aov_time_limit = absl::InfiniteDuration();
+    if (time_limit != absl::InfiniteDuration()) {
+      aov_time_limit = std::max(time_limit - (absl::Now() - render_start),
+                                absl::Nanoseconds(1));
+    }
+
+    progress_reporter.reset();
+    begin_phase("aovs", aov_time_limit);
+
+    uint32_t aov_samples_per_pixel = std::max(
+        UINT32_C(1), std::min(samples_per_pixel, kMaxAovSamplesPerPixel));
+    ProgressiveSampler aov_sampler(ProgressiveSampler::Sequence::SOBOL,
+                                   aov_samples_per_pixel, absl::nullopt);
+    ProgressiveSampler::RenderOptions options = {
+        aov_time_limit, 0, absl::nullopt, tile_scheduler.get(),
+        pixel_bounds, nullptr, telemetry.get()};
+    aov_samples_per_pixel =
+        aov_sampler.Render(render_pass, options, aov_framebuffer);
+    phase->AddSamples(num_pixels * aov_samples_per_pixel);
+
+    aov_buffers = accumulator.Resolve();
+  }
+
+  Framebuffer framebuffer =
+      pixel_bounds ? Crop(std::get<8>(render_config), *pixel_bounds)
+                   : std::move(std::get<8>(render_config));
+
+  if (denoise) {
+    begin_phase("denoise", absl::InfiniteDuration());
+    Denoise(aov_buffers, denoise_radius, num_threads, framebuffer);
+
+    aov_buffers.erase(
+        std::remove_if(aov_buffers.begin(), aov_buffers.end(),
+                       [&](const AovBuffer& buffer) {
+                         return std::find(film_aovs.begin(), film_aovs.end(),
+                                          buffer.aov) == film_aovs.end();
+                       }),
+        aov_buffers.end());
+  }
+
+  return std::make_tuple(std::move(framebuffer),
+                         std::move(std::get<9>(render_config)),
+                         std::move(aov_buffers));
 }
 
 void RenderToOutput(
@@ -79,7 +710,10 @@ void RenderToOutput(
       parser, render_index, epsilon, num_threads, report_progress,
       spectral_representation_override, rgb_color_space_override,
       always_compute_reflective_color_override);
-  render_result.second->Write(render_result.first);
+
+  ScopedPhase phase("write");
+  std::get<1>(render_result)
+      ->Write(std::get<0>(render_result), std::get<2>(render_result));
 }
 
 }  // namespace iris
\ No newline at end of file
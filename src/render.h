@@ -1,13 +1,28 @@
 #ifndef _SRC_RENDER_
 #define _SRC_RENDER_
 
+#include <ostream>
+#include <tuple>
+#include <vector>
+
+#include "src/common/aov.h"
 #include "src/common/pointer_types.h"
 #include "src/directives/parser.h"
 #include "src/films/output_writers/result.h"
 
 namespace iris {
 
-std::pair<Framebuffer, OutputWriter> RenderToFramebuffer(
+// The image, the writer for it, and the AOVs requested by the film, which
+// have the same size as the image.
+typedef std::tuple<Framebuffer, OutputWriter, std::vector<AovBuffer>>
+    RenderResult;
+
+// The stream to which the frontend writes messages and statistics, which is
+// std::cerr if --progress_format=json is writing its records to stdout and
+// std::cout otherwise.
+std::ostream& MessageOutput();
+
+RenderResult RenderToFramebuffer(
     Parser& parser, size_t render_index, float_t epsilon, size_t num_threads,
     bool report_progress,
     absl::optional<SpectralRepresentation> spectral_representation_override,
@@ -0,0 +1,59 @@
+#include "src/samplers/adaptive.h"
+
+#include <iostream>
+
+#include "src/param_matchers/float_single.h"
+#include "src/param_matchers/integral_single.h"
+#include "src/param_matchers/single.h"
+
+namespace iris {
+namespace {
+
+static const char* kAdaptiveSamplerDefaultSequence = "halton";
+static const uint16_t kAdaptiveSamplerDefaultPixelSamples = 16;
+static const uint16_t kAdaptiveSamplerDefaultMaxPixelSamples = 1024;
+static const float_t kAdaptiveSamplerDefaultRelativeError = (float_t)0.02;
+
+}  // namespace
+
+SamplerResult ParseAdaptive(Parameters& parameters) {
+  SingleStringMatcher sequence("sequence", false,
+                               kAdaptiveSamplerDefaultSequence);
+  NonZeroSingleUInt16Matcher pixelsamples("pixelsamples", false,
+                                          kAdaptiveSamplerDefaultPixelSamples);
+  NonZeroSingleUInt16Matcher maxpixelsamples(
+      "maxpixelsamples", false, kAdaptiveSamplerDefaultMaxPixelSamples);
+  SingleFloatMatcher relativeerror("relativeerror", false, false, (float_t)0.0,
+                                   (float_t)INFINITY,
+                                   kAdaptiveSamplerDefaultRelativeError);
+  parameters.Match(sequence, pixelsamples, maxpixelsamples, relativeerror);
+
+  ProgressiveSampler::Sequence base_sequence;
+  if (sequence.Get() == "halton") {
+    base_sequence = ProgressiveSampler::Sequence::HALTON;
+  } else if (sequence.Get() == "pmj02bn") {
+    base_sequence = ProgressiveSampler::Sequence::PMJ02BN;
+  } else if (sequence.Get() == "sobol") {
+    base_sequence = ProgressiveSampler::Sequence::SOBOL;
+  } else if (sequence.Get() == "zsobol") {
+    base_sequence = ProgressiveSampler::Sequence::ZSOBOL;
+  } else {
+    std::cerr << "ERROR: Unsupported sequence for adaptive Sampler: "
+              << sequence.Get() << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  if (maxpixelsamples.Get() < pixelsamples.Get()) {
+    std::cerr << "ERROR: maxpixelsamples must not be less than pixelsamples "
+                 "for adaptive Sampler"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  ProgressiveSampler::AdaptiveOptions adaptive = {maxpixelsamples.Get(),
+                                                  *relativeerror.Get()};
+  ProgressiveSampler progressive(base_sequence, pixelsamples.Get(), adaptive);
+  return std::make_pair(Sampler(), std::move(progressive));
+}
+
+}  // namespace iris
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef _SRC_SAMPLERS_ADAPTIVE_
+#define _SRC_SAMPLERS_ADAPTIVE_
+
+#include "src/common/parameters.h"
+#include "src/samplers/result.h"
+
+namespace iris {
+
+SamplerResult ParseAdaptive(Parameters& parameters);
+
+}  // namespace iris
+
+#endif  // _SRC_SAMPLERS_ADAPTIVE_
\ No newline at end of file
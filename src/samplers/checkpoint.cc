@@ -0,0 +1,162 @@
+#include "src/samplers/checkpoint.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace iris {
+namespace {
+
+// Pixels darker than this are treated as having this luminance when computing
+// their relative error so that black pixels can converge.
+static const double kMinimumLuminance = 0.001;
+
+static const char kMagic[8] = {'I', 'R', 'I', 'S', 'C', 'K', 'P', 'T'};
+static const uint32_t kVersion = 3;
+
+// The header is followed by the statistics of every pixel and then by a byte
+// per pixel that is non-zero if the pixel is still being sampled.
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t sequence;
+  uint32_t pixel_samples;
+  uint32_t max_samples;
+  double relative_error;
+  uint64_t num_columns;
+  uint64_t num_rows;
+  uint64_t min_column;
+  uint64_t max_column;
+  uint64_t min_row;
+  uint64_t max_row;
+  uint32_t sample_offset;
+  uint32_t first_sample_index;
+};
+
+}  // namespace
+
+COLOR3 Mean(const PixelStatistics& statistics) {
+  float_t values[3] = {(float_t)0.0, (float_t)0.0, (float_t)0.0};
+  if (statistics.num_samples != 0) {
+    for (size_t i = 0; i < 3; i++) {
+      values[i] =
+          static_cast<float_t>(statistics.xyz_sum[i] / statistics.num_samples);
+    }
+  }
+  return ColorCreate(COLOR_SPACE_XYZ, values);
+}
+
+// The variance of each pixel is estimated from the means of the passes that
+// sampled it, weighted by the number of samples in each pass.
+void AddPass(COLOR3 color, uint32_t num_samples, PixelStatistics* statistics) {
+  COLOR3 xyz = ColorConvert(color, COLOR_SPACE_XYZ);
+  for (size_t i = 0; i < 3; i++) {
+    statistics->xyz_sum[i] += (double)xyz.values[i] * num_samples;
+  }
+  statistics->luminance_sum_of_squares +=
+      (double)xyz.values[1] * (double)xyz.values[1] * num_samples;
+  statistics->num_samples += num_samples;
+  statistics->num_passes += 1;
+}
+
+bool Converged(const PixelStatistics& statistics, double relative_error) {
+  if (statistics.num_passes < 2) {
+    return false;
+  }
+
+  double num_samples = statistics.num_samples;
+  double mean = statistics.xyz_sum[1] / num_samples;
+  double variance = (statistics.luminance_sum_of_squares -
+                     statistics.xyz_sum[1] * mean) /
+                    (statistics.num_passes - 1);
+  double standard_error = std::sqrt(std::max(0.0, variance) / num_samples);
+  return standard_error <= relative_error * std::max(mean, kMinimumLuminance);
+}
+
+void WriteCheckpoint(const std::string& path, const Checkpoint& checkpoint) {
+  Header header;
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.sequence = checkpoint.sequence;
+  header.pixel_samples = checkpoint.pixel_samples;
+  header.max_samples = checkpoint.max_samples;
+  header.relative_error = checkpoint.relative_error;
+  header.num_columns = checkpoint.num_columns;
+  header.num_rows = checkpoint.num_rows;
+  header.min_column = checkpoint.pixel_bounds.min_column;
+  header.max_column = checkpoint.pixel_bounds.max_column;
+  header.min_row = checkpoint.pixel_bounds.min_row;
+  header.max_row = checkpoint.pixel_bounds.max_row;
+  header.sample_offset = checkpoint.sample_offset;
+  header.first_sample_index = checkpoint.first_sample_index;
+
+  std::string temporary_path = path + ".tmp";
+  std::ofstream output(temporary_path, std::ios::binary | std::ios::trunc);
+  output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  output.write(reinterpret_cast<const char*>(checkpoint.statistics.data()),
+               sizeof(PixelStatistics) * checkpoint.statistics.size());
+  output.write(reinterpret_cast<const char*>(checkpoint.active.data()),
+               checkpoint.active.size());
+  output.close();
+
+  if (output.fail() || rename(temporary_path.c_str(), path.c_str()) != 0) {
+    std::cerr << "ERROR: Failed to write checkpoint file: " << path
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+}
+
+absl::optional<Checkpoint> ReadCheckpoint(const std::string& path) {
+  std::ifstream input(path, std::ios::binary);
+  if (!input) {
+    return absl::nullopt;
+  }
+
+  Header header;
+  input.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!input || memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.version != kVersion) {
+    std::cerr << "ERROR: Not a checkpoint file: " << path << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  Checkpoint result;
+  result.sequence = header.sequence;
+  result.pixel_samples = header.pixel_samples;
+  result.max_samples = header.max_samples;
+  result.relative_error = header.relative_error;
+  result.num_columns = header.num_columns;
+  result.num_rows = header.num_rows;
+  result.pixel_bounds = {header.min_column, header.max_column,
+                         header.min_row, header.max_row};
+  result.sample_offset = header.sample_offset;
+  result.first_sample_index = header.first_sample_index;
+
+  const PixelBounds& bounds = result.pixel_bounds;
+  size_t max_pixels = SIZE_MAX / sizeof(PixelStatistics);
+  if (header.num_columns < bounds.max_column ||
+      header.num_rows < bounds.max_row || bounds.Empty() ||
+      max_pixels / bounds.NumRows() < bounds.NumColumns()) {
+    std::cerr << "ERROR: Checkpoint file is corrupt: " << path << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  size_t num_pixels = bounds.NumColumns() * bounds.NumRows();
+  result.statistics.resize(num_pixels);
+  result.active.resize(num_pixels);
+
+  input.read(reinterpret_cast<char*>(result.statistics.data()),
+             sizeof(PixelStatistics) * num_pixels);
+  input.read(reinterpret_cast<char*>(result.active.data()), num_pixels);
+  if (!input || input.peek() != std::ifstream::traits_type::eof()) {
+    std::cerr << "ERROR: Checkpoint file is corrupt: " << path << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  return result;
+}
+
+}  // namespace iris
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef _SRC_SAMPLERS_CHECKPOINT_
+#define _SRC_SAMPLERS_CHECKPOINT_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "src/common/pixel_bounds.h"
+#include "src/common/pointer_types.h"
+
+namespace iris {
+
+// The samples accumulated by a pixel during progressive rendering. The colors
+// of the passes that sampled the pixel are summed in XYZ, weighted by the
+// number of samples in each pass.
+struct PixelStatistics {
+  double xyz_sum[3];
+  double luminance_sum_of_squares;
+  uint32_t num_samples;
+  uint32_t num_passes;
+};
+
+// Returns the mean XYZ color of a pixel, or black if it has no samples.
+COLOR3 Mean(const PixelStatistics& statistics);
+
+// Adds the mean color of a pass that took num_samples samples of the pixel.
+void AddPass(COLOR3 color, uint32_t num_samples, PixelStatistics* statistics);
+
+// Returns true once the estimated standard error of the luminance of a pixel
+// is at most relative_error times its mean luminance.
+//
+// The variance is estimated from the spread of the pass means, which is only
+// an unbiased estimate of the error if the passes are independent. Passes
+// drawn from consecutive ranges of one low discrepancy sequence are not: each
+// pass is itself well stratified, so its mean is closer to the others than
+// those of an independent sampler would be, and the estimate understates the
+// error relative to independent sampling. relative_error is therefore a
+// target rather than a bound on the error of a converged pixel.
+bool Converged(const PixelStatistics& statistics, double relative_error);
+
+// The state of a progressive render. Samples with indices in the range
+// [sample_offset, first_sample_index) have been taken by every active pixel.
+// The statistics and active flags cover only the pixels within pixel_bounds
+// of an image of num_columns by num_rows pixels.
+struct Checkpoint {
+  uint32_t sequence;
+  uint32_t pixel_samples;
+  uint32_t max_samples;
+  double relative_error;
+  uint64_t num_columns;
+  uint64_t num_rows;
+  PixelBounds pixel_bounds;
+  uint32_t sample_offset;
+  uint32_t first_sample_index;
+  std::vector<PixelStatistics> statistics;
+  std::vector<uint8_t> active;
+};
+
+// Checkpoints are written in native byte order to a temporary file which then
+// replaces path so that a valid checkpoint exists at all times.
+void WriteCheckpoint(const std::string& path, const Checkpoint& checkpoint);
+
+// Returns absl::nullopt if path does not exist.
+absl::optional<Checkpoint> ReadCheckpoint(const std::string& path);
+
+}  // namespace iris
+
+#endif  // _SRC_SAMPLERS_CHECKPOINT_
\ No newline at end of file
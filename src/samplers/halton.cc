@@ -12,7 +12,7 @@ static const uint16_t kHaltonSamplerDefaultPixelSamples = 16;
 
 }  // namespace
 
-Sampler ParseHalton(Parameters& parameters) {
+SamplerResult ParseHalton(Parameters& parameters) {
   NonZeroSingleUInt16Matcher pixelsamples("pixelsamples", false,
                                           kHaltonSamplerDefaultPixelSamples);
   parameters.Match(pixelsamples);
@@ -26,7 +26,9 @@ Sampler ParseHalton(Parameters& parameters) {
       sequence.get(), pixelsamples.Get(), result.release_and_get_address());
   SuccessOrOOM(status);
 
-  return result;
+  ProgressiveSampler progressive(ProgressiveSampler::Sequence::HALTON,
+                                 pixelsamples.Get(), absl::nullopt);
+  return std::make_pair(std::move(result), std::move(progressive));
 }
 
 }  // namespace iris
\ No newline at end of file
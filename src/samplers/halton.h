@@ -1,12 +1,12 @@
 #ifndef _SRC_SAMPLERS_HALTON_
 #define _SRC_SAMPLERS_HALTON_
 
-#include "src/common/pointer_types.h"
 #include "src/common/parameters.h"
+#include "src/samplers/result.h"
 
 namespace iris {
 
-Sampler ParseHalton(Parameters& parameters);
+SamplerResult ParseHalton(Parameters& parameters);
 
 }  // namespace iris
 
@@ -1,22 +1,30 @@
 #include "src/samplers/parser.h"
 
+#include "src/samplers/adaptive.h"
 #include "src/samplers/halton.h"
+#include "src/samplers/pmj02bn.h"
 #include "src/samplers/sobol.h"
 #include "src/samplers/stratified.h"
+#include "src/samplers/zsobol.h"
 
 namespace iris {
 namespace {
 
-const Directive::Implementations<Sampler> kImpls = {
+const Directive::Implementations<SamplerResult> kImpls = {
+    {"adaptive", ParseAdaptive},
     {"halton", ParseHalton},
+    {"pmj02bn", ParsePmj02bn},
     {"sobol", ParseSobol},
-    {"stratified", ParseStratified}};
+    {"stratified", ParseStratified},
+    {"zsobol", ParseZSobol}};
 
 }  // namespace
 
-Sampler ParseSampler(Directive& directive) { return directive.Invoke(kImpls); }
+SamplerResult ParseSampler(Directive& directive) {
+  return directive.Invoke(kImpls);
+}
 
-Sampler CreateDefaultSampler() {
+SamplerResult CreateDefaultSampler() {
   Parameters parameters;
   return ParseHalton(parameters);
 }
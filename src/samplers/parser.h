@@ -1,13 +1,13 @@
 #ifndef _SRC_SAMPLERS_PARSER_
 #define _SRC_SAMPLERS_PARSER_
 
-#include "src/common/pointer_types.h"
 #include "src/common/directive.h"
+#include "src/samplers/result.h"
 
 namespace iris {
 
-Sampler ParseSampler(Directive& directive);
-Sampler CreateDefaultSampler();
+SamplerResult ParseSampler(Directive& directive);
+SamplerResult CreateDefaultSampler();
 
 }  // namespace iris
 
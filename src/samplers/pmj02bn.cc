@@ -0,0 +1,24 @@
+#include "src/samplers/pmj02bn.h"
+
+#include "src/param_matchers/integral_single.h"
+
+namespace iris {
+namespace {
+
+static const uint16_t kPmj02bnSamplerDefaultPixelSamples = 16;
+
+}  // namespace
+
+// There is no single pass implementation of this sampler, so images are
+// always rendered progressively.
+SamplerResult ParsePmj02bn(Parameters& parameters) {
+  NonZeroSingleUInt16Matcher pixelsamples("pixelsamples", false,
+                                          kPmj02bnSamplerDefaultPixelSamples);
+  parameters.Match(pixelsamples);
+
+  ProgressiveSampler progressive(ProgressiveSampler::Sequence::PMJ02BN,
+                                 pixelsamples.Get(), absl::nullopt);
+  return std::make_pair(Sampler(), std::move(progressive));
+}
+
+}  // namespace iris
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef _SRC_SAMPLERS_PMJ02BN_
+#define _SRC_SAMPLERS_PMJ02BN_
+
+#include "src/common/parameters.h"
+#include "src/samplers/result.h"
+
+namespace iris {
+
+SamplerResult ParsePmj02bn(Parameters& parameters);
+
+}  // namespace iris
+
+#endif  // _SRC_SAMPLERS_PMJ02BN_
\ No newline at end of file
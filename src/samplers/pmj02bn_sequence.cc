@@ -0,0 +1,273 @@
+#include "src/samplers/pmj02bn_sequence.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+namespace iris {
+namespace {
+
+// The number of valid positions considered for each sample.
+static const size_t kNumCandidates = 10;
+
+// splitmix64, which is used rather than the standard library distributions
+// so that the sequences are identical on every platform.
+class Random {
+ public:
+  explicit Random(uint64_t seed) : m_state(seed) {}
+
+  uint64_t Next() {
+    uint64_t value = (m_state += UINT64_C(0x9e3779b97f4a7c15));
+    value = (value ^ (value >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    value = (value ^ (value >> 27)) * UINT64_C(0x94d049bb133111eb);
+    return value ^ (value >> 31);
+  }
+
+  double Uniform() { return (Next() >> 11) * 0x1p-53; }
+
+ private:
+  uint64_t m_state;
+};
+
+// Samples are rounded down so that they stay within their strata.
+float RoundDown(double value) {
+  float result = static_cast<float>(value);
+  if (value < result) {
+    result = std::nextafter(result, 0.0f);
+  }
+  return result;
+}
+
+// Implements the pmj02 construction of Christensen, Kensler and Kilpatrick,
+// "Progressive Multi-Jittered Sample Sequences", with best candidate sampling
+// within the positions that keep the sequence stratified.
+class Pmj02bnGenerator {
+ public:
+  explicit Pmj02bnGenerator(uint64_t seed) : m_random(seed) {}
+
+  std::vector<std::array<float, 2>> Generate(size_t length);
+
+ private:
+  void StartPowerOfTwo(size_t num_samples);
+  void Mark(const std::array<double, 2>& sample);
+  void AddToGrid(size_t sample);
+  double MinimumDistanceSquared(const std::array<double, 2>& sample) const;
+  void AddSample(size_t column, size_t row, size_t x_half, size_t y_half,
+                 size_t grid_size);
+  std::array<size_t, 4> Subquadrant(const std::array<double, 2>& sample,
+                                    size_t grid_size) const;
+
+  Random m_random;
+  std::vector<std::array<double, 2>> m_samples;
+
+  // Occupancy of the strata of each elementary interval shape for the next
+  // power of two. Shape i has 2^i columns and 2^(m_log2_strata - i) rows.
+  size_t m_log2_strata;
+  std::vector<std::vector<bool>> m_occupied;
+
+  // Samples bucketed by position for finding nearest neighbors.
+  size_t m_neighbor_grid_size;
+  std::vector<std::vector<size_t>> m_neighbor_grid;
+};
+
+void Pmj02bnGenerator::StartPowerOfTwo(size_t num_samples) {
+  m_log2_strata = 0;
+  while ((size_t(1) << m_log2_strata) < num_samples) {
+    m_log2_strata += 1;
+  }
+
+  m_occupied.assign(m_log2_strata + 1,
+                    std::vector<bool>(size_t(1) << m_log2_strata, false));
+  for (const auto& sample : m_samples) {
+    Mark(sample);
+  }
+
+  m_neighbor_grid_size = std::max(
+      size_t(1), static_cast<size_t>(std::sqrt((double)num_samples)));
+  m_neighbor_grid.assign(m_neighbor_grid_size * m_neighbor_grid_size,
+                         std::vector<size_t>());
+  for (size_t i = 0; i < m_samples.size(); i++) {
+    AddToGrid(i);
+  }
+}
+
+void Pmj02bnGenerator::Mark(const std::array<double, 2>& sample) {
+  size_t x = static_cast<size_t>(sample[0] * (size_t(1) << m_log2_strata));
+  size_t y = static_cast<size_t>(sample[1] * (size_t(1) << m_log2_strata));
+  for (size_t i = 0; i <= m_log2_strata; i++) {
+    size_t column = x >> (m_log2_strata - i);
+    size_t row = y >> i;
+    m_occupied[i][(column << (m_log2_strata - i)) | row] = true;
+  }
+}
+
+void Pmj02bnGenerator::AddToGrid(size_t sample) {
+  size_t x = static_cast<size_t>(m_samples[sample][0] * m_neighbor_grid_size);
+  size_t y = static_cast<size_t>(m_samples[sample][1] * m_neighbor_grid_size);
+  m_neighbor_grid[y * m_neighbor_grid_size + x].push_back(sample);
+}
+
+// Distances wrap around the unit square so that the sequences tile without
+// seams.
+double Pmj02bnGenerator::MinimumDistanceSquared(
+    const std::array<double, 2>& sample) const {
+  static const int kSearchRadius = 2;
+
+  int grid_size = static_cast<int>(m_neighbor_grid_size);
+  int x = static_cast<int>(sample[0] * grid_size);
+  int y = static_cast<int>(sample[1] * grid_size);
+
+  double result = INFINITY;
+  for (int dy = -kSearchRadius; dy <= kSearchRadius; dy++) {
+    for (int dx = -kSearchRadius; dx <= kSearchRadius; dx++) {
+      int column = (x + dx + grid_size) % grid_size;
+      int row = (y + dy + grid_size) % grid_size;
+      for (size_t neighbor : m_neighbor_grid[row * grid_size + column]) {
+        double distance_x = std::abs(m_samples[neighbor][0] - sample[0]);
+        double distance_y = std::abs(m_samples[neighbor][1] - sample[1]);
+        distance_x = std::min(distance_x, 1.0 - distance_x);
+        distance_y = std::min(distance_y, 1.0 - distance_y);
+        result = std::min(result,
+                          distance_x * distance_x + distance_y * distance_y);
+      }
+    }
+  }
+
+  return result;
+}
+
+// Returns the cell of a grid_size by grid_size grid containing sample and the
+// quadrant of that cell containing it.
+std::array<size_t, 4> Pmj02bnGenerator::Subquadrant(
+    const std::array<double, 2>& sample, size_t grid_size) const {
+  double x = sample[0] * grid_size;
+  double y = sample[1] * grid_size;
+  size_t column = static_cast<size_t>(x);
+  size_t row = static_cast<size_t>(y);
+  return {column, row, static_cast<size_t>(2.0 * (x - column)),
+          static_cast<size_t>(2.0 * (y - row))};
+}
+
+// Adds a sample to the given quadrant of a cell. Within the quadrant, the
+// unoccupied columns and rows of the finest strata are found first, and then
+// each combination of them is checked against the remaining strata.
+void Pmj02bnGenerator::AddSample(size_t column, size_t row, size_t x_half,
+                                 size_t y_half, size_t grid_size) {
+  size_t num_strata = size_t(1) << m_log2_strata;
+  size_t width = num_strata / (2 * grid_size);
+  size_t first_x = (2 * column + x_half) * width;
+  size_t first_y = (2 * row + y_half) * width;
+
+  std::vector<size_t> free_x, free_y;
+  for (size_t i = 0; i < width; i++) {
+    if (!m_occupied[m_log2_strata][first_x + i]) {
+      free_x.push_back(first_x + i);
+    }
+    if (!m_occupied[0][first_y + i]) {
+      free_y.push_back(first_y + i);
+    }
+  }
+
+  std::vector<std::array<size_t, 2>> valid;
+  for (size_t x : free_x) {
+    for (size_t y : free_y) {
+      bool occupied = false;
+      for (size_t i = 1; i < m_log2_strata && !occupied; i++) {
+        size_t stratum_column = x >> (m_log2_strata - i);
+        size_t stratum_row = y >> i;
+        occupied =
+            m_occupied[i][(stratum_column << (m_log2_strata - i)) |
+                          stratum_row];
+      }
+      if (!occupied) {
+        valid.push_back({x, y});
+      }
+    }
+  }
+
+  assert(!valid.empty());
+
+  std::array<double, 2> best;
+  double best_distance = -1.0;
+  for (size_t i = 0; i < kNumCandidates; i++) {
+    const auto& stratum = valid[m_random.Next() % valid.size()];
+    std::array<double, 2> candidate = {
+        (stratum[0] + m_random.Uniform()) / num_strata,
+        (stratum[1] + m_random.Uniform()) / num_strata};
+    double distance = MinimumDistanceSquared(candidate);
+    if (best_distance < distance) {
+      best = candidate;
+      best_distance = distance;
+    }
+  }
+
+  m_samples.push_back(best);
+  Mark(best);
+  AddToGrid(m_samples.size() - 1);
+}
+
+// Each step doubles the number of samples. When the number of samples is a
+// power of four, every existing sample is paired with a new sample in the
+// diagonally opposite quadrant of its cell. Otherwise, the two quadrants of
+// each cell that are still empty are filled, choosing at random which of them
+// is filled by the first half of the new samples.
+std::vector<std::array<float, 2>> Pmj02bnGenerator::Generate(size_t length) {
+  m_samples.clear();
+  m_samples.push_back({m_random.Uniform(), m_random.Uniform()});
+
+  for (size_t num_samples = 1; num_samples < length; num_samples *= 2) {
+    StartPowerOfTwo(2 * num_samples);
+
+    if (m_log2_strata % 2 == 1) {
+      size_t grid_size =
+          static_cast<size_t>(std::sqrt((double)num_samples) + 0.5);
+      for (size_t i = 0; i < num_samples; i++) {
+        auto cell = Subquadrant(m_samples[i], grid_size);
+        AddSample(cell[0], cell[1], 1 - cell[2], 1 - cell[3], grid_size);
+      }
+    } else {
+      size_t grid_size =
+          static_cast<size_t>(std::sqrt((double)(num_samples / 2)) + 0.5);
+      for (size_t i = 0; i < num_samples / 2; i++) {
+        auto cell = Subquadrant(m_samples[i], grid_size);
+        if (m_random.Next() & 1) {
+          AddSample(cell[0], cell[1], 1 - cell[2], cell[3], grid_size);
+        } else {
+          AddSample(cell[0], cell[1], cell[2], 1 - cell[3], grid_size);
+        }
+      }
+
+      for (size_t i = 0; i < num_samples / 2; i++) {
+        auto cell = Subquadrant(m_samples[num_samples + i], grid_size);
+        AddSample(cell[0], cell[1], 1 - cell[2], 1 - cell[3], grid_size);
+      }
+    }
+  }
+
+  std::vector<std::array<float, 2>> result;
+  for (size_t i = 0; i < length; i++) {
+    result.push_back({RoundDown(m_samples[i][0]), RoundDown(m_samples[i][1])});
+  }
+
+  return result;
+}
+
+}  // namespace
+
+const std::vector<std::array<float, 2>>& Pmj02bnSequence(size_t index) {
+  assert(index < kNumPmj02bnSequences);
+
+  static const auto* sequences = [] {
+    auto* result = new std::vector<std::array<float, 2>>[kNumPmj02bnSequences];
+    for (size_t i = 0; i < kNumPmj02bnSequences; i++) {
+      result[i] = Pmj02bnGenerator(i).Generate(kPmj02bnSequenceLength);
+    }
+    return result;
+  }();
+
+  return sequences[index];
+}
+
+}  // namespace iris
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef _SRC_SAMPLERS_PMJ02BN_SEQUENCE_
+#define _SRC_SAMPLERS_PMJ02BN_SEQUENCE_
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace iris {
+
+static const size_t kNumPmj02bnSequences = 2;
+static const size_t kPmj02bnSequenceLength = 4096;
+
+// Returns one of a fixed set of two dimensional progressive multi-jittered
+// (0,2) sequences with blue noise properties. Every prefix of a sequence whose
+// length is a power of two is stratified in every elementary interval of that
+// size, and each sample is the best of several valid candidates at keeping
+// its distance from the samples before it. Sequences are generated on first
+// use, which is thread safe.
+const std::vector<std::array<float, 2>>& Pmj02bnSequence(size_t index);
+
+}  // namespace iris
+
+#endif  // _SRC_SAMPLERS_PMJ02BN_SEQUENCE_
\ No newline at end of file
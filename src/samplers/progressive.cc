@@ -0,0 +1,705 @@
+#include "src/samplers/progressive.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include "absl/time/clock.h"
+#include "src/common/error.h"
+#include "src/common/trace.h"
+#include "src/randoms/sample_key.h"
+#include "src/samplers/checkpoint.h"
+#include "src/samplers/pmj02bn_sequence.h"
+
+namespace iris {
+namespace {
+
+// When sampling adaptively, the initial samples are split over this many
+// passes so that every pixel has a variance estimate before any of them are
+// allowed to stop. Later passes grow with the number of samples already taken
+// to bound the number of passes.
+static const uint32_t kInitialAdaptivePasses = 4;
+
+// The 24 permutations of the base 4 digits used by zsobol.
+static const uint8_t kBase4Permutations[24][4] = {
+    {0, 1, 2, 3}, {0, 1, 3, 2}, {0, 2, 1, 3}, {0, 2, 3, 1}, {0, 3, 1, 2},
+    {0, 3, 2, 1}, {1, 0, 2, 3}, {1, 0, 3, 2}, {1, 2, 0, 3}, {1, 2, 3, 0},
+    {1, 3, 0, 2}, {1, 3, 2, 0}, {2, 0, 1, 3}, {2, 0, 3, 1}, {2, 1, 0, 3},
+    {2, 1, 3, 0}, {2, 3, 0, 1}, {2, 3, 1, 0}, {3, 0, 1, 2}, {3, 0, 2, 1},
+    {3, 1, 0, 2}, {3, 1, 2, 0}, {3, 2, 0, 1}, {3, 2, 1, 0}};
+
+// The zsobol sequence indexes the samples of every pixel in the image as one
+// sequence, with log2_samples bits of each index selecting the sample within
+// the pixel and the remaining num_base4_digits - log2_samples / 2 base 4
+// digits holding the Morton code of the pixel.
+struct PassState {
+  ProgressiveSampler::Sequence sequence;
+  uint32_t samples_per_pixel;
+  uint32_t first_sample_index;
+  uint32_t log2_samples;
+  uint32_t num_base4_digits;
+  size_t num_columns;
+  size_t num_rows;
+  PixelBounds bounds;
+  const std::vector<uint8_t>* active;
+};
+
+// Pixels are identified by their column and row in the image, which when
+// rendering a tile are offset from those of the tile's framebuffer.
+struct ImageSamplerContext {
+  const PassState* pass;
+  const TileScheduler::Tile* tile;
+  size_t column;
+  size_t row;
+  size_t pixel;
+  uint64_t morton_code;
+  uint32_t pixel_scramble;
+  uint32_t lens_scramble;
+  uint32_t sample_index;
+};
+
+uint32_t Hash(uint64_t value) {
+  value ^= value >> 33;
+  value *= UINT64_C(0xff51afd7ed558ccd);
+  value ^= value >> 33;
+  value *= UINT64_C(0xc4ceb9fe1a85ec53);
+  value ^= value >> 33;
+  return static_cast<uint32_t>(value);
+}
+
+uint64_t MixBits(uint64_t value) {
+  value ^= value >> 31;
+  value *= UINT64_C(0x7fb5d329728ea185);
+  value ^= value >> 27;
+  value *= UINT64_C(0x81dadef4bc2dd44d);
+  value ^= value >> 33;
+  return value;
+}
+
+uint32_t ReverseBits(uint32_t value) {
+  value = (value << 16) | (value >> 16);
+  value = ((value & 0x00FF00FFu) << 8) | ((value & 0xFF00FF00u) >> 8);
+  value = ((value & 0x0F0F0F0Fu) << 4) | ((value & 0xF0F0F0F0u) >> 4);
+  value = ((value & 0x33333333u) << 2) | ((value & 0xCCCCCCCCu) >> 2);
+  value = ((value & 0x55555555u) << 1) | ((value & 0xAAAAAAAAu) >> 1);
+  return value;
+}
+
+// Second dimension of the Sobol sequence, which together with the van der
+// Corput sequence in the first dimension forms a (0,2)-sequence in base 2.
+uint32_t SobolSecondDimension(uint32_t index) {
+  uint32_t result = 0;
+  for (uint32_t v = UINT32_C(1) << 31; index != 0; index >>= 1, v ^= v >> 1) {
+    if (index & 1) {
+      result ^= v;
+    }
+  }
+  return result;
+}
+
+// A hash based approximation of Owen scrambling by Laine and Karras, as
+// improved by Burley, that randomly permutes the binary digits of value while
+// preserving the stratification of the sequence it is applied to.
+uint32_t OwenScramble(uint32_t value, uint32_t seed) {
+  value = ReverseBits(value);
+  value ^= value * 0x3d20adeau;
+  value += seed;
+  value *= (seed >> 16) | 1;
+  value ^= value * 0x05526c56u;
+  value ^= value * 0x53a22864u;
+  return ReverseBits(value);
+}
+
+uint64_t SpreadBits(uint32_t value) {
+  uint64_t result = value;
+  result = (result | (result << 16)) & UINT64_C(0x0000ffff0000ffff);
+  result = (result | (result << 8)) & UINT64_C(0x00ff00ff00ff00ff);
+  result = (result | (result << 4)) & UINT64_C(0x0f0f0f0f0f0f0f0f);
+  result = (result | (result << 2)) & UINT64_C(0x3333333333333333);
+  result = (result | (result << 1)) & UINT64_C(0x5555555555555555);
+  return result;
+}
+
+uint64_t EncodeMorton2(uint32_t x, uint32_t y) {
+  return (SpreadBits(y) << 1) | SpreadBits(x);
+}
+
+// The zsobol index of a sample, from Ahmed and Wonka, "Screen-Space Blue-Noise
+// Diffusion of Monte Carlo Sampling Error via Hierarchical Ordering of
+// Pixels". Each base 4 digit of the Morton ordered index is permuted based on
+// the digits above it so that the samples of nearby pixels are spread over the
+// sequence and their error is distributed as blue noise.
+uint64_t ZSobolIndex(const PassState& pass, uint64_t morton_index,
+                     uint32_t dimension) {
+  uint64_t dimension_hash = UINT64_C(0x55555555) * dimension;
+  uint32_t odd = pass.log2_samples & 1;
+
+  uint64_t result = 0;
+  for (uint32_t i = pass.num_base4_digits; odd < i; i--) {
+    uint32_t shift = 2 * (i - 1) - odd;
+    uint64_t digit = (morton_index >> shift) & 3;
+    uint64_t higher_digits = morton_index >> (shift + 2);
+    uint64_t permutation = (MixBits(higher_digits ^ dimension_hash) >> 24) % 24;
+    result |= (uint64_t)kBase4Permutations[permutation][digit] << shift;
+  }
+
+  if (odd) {
+    uint64_t digit = morton_index & 1;
+    result |= digit ^ (MixBits((morton_index >> 1) ^ dimension_hash) & 1);
+  }
+
+  return result;
+}
+
+double RadicalInverse(uint32_t base, uint32_t index) {
+  double inverse_base = 1.0 / base;
+  double scale = inverse_base;
+  double result = 0.0;
+  while (index != 0) {
+    result += (index % base) * scale;
+    index /= base;
+    scale *= inverse_base;
+  }
+  return result;
+}
+
+float_t ToUnitInterval(double value) {
+  static const float_t kOneMinusEpsilon =
+      (float_t)1.0 - std::numeric_limits<float_t>::epsilon() / (float_t)2.0;
+  return std::min(static_cast<float_t>(value), kOneMinusEpsilon);
+}
+
+// Returns one of the first two dimensions of the Owen scrambled Sobol sequence.
+// Only the low 32 bits of an index contribute to a 32 bit sample, so longer
+// sequences are split into blocks of 2^32 consecutive indices that are each
+// scrambled with their own seed. The samples of a pixel never span more than
+// one block, within which they keep the stratification of the sequence.
+float_t ScrambledSobol(uint64_t index, uint32_t dimension, uint32_t seed) {
+  uint32_t low_bits = static_cast<uint32_t>(index);
+  uint32_t value =
+      dimension == 0 ? ReverseBits(low_bits) : SobolSecondDimension(low_bits);
+  uint32_t scramble = Hash(((index >> 32) << 3) | seed);
+  return ToUnitInterval(OwenScramble(value, scramble) * 0x1p-32);
+}
+
+// Cranley-Patterson rotation of a sample by an offset derived from a scramble.
+float_t Rotate(double value, uint32_t scramble) {
+  value += scramble * 0x1p-32;
+  if (value >= 1.0) {
+    value -= 1.0;
+  }
+  return ToUnitInterval(value);
+}
+
+// Random digit scrambling of a sample in [0, 1).
+float_t Scramble(float value, uint32_t scramble) {
+  uint32_t bits = static_cast<uint32_t>(value * 0x1p32f);
+  return ToUnitInterval((bits ^ scramble) * 0x1p-32);
+}
+
+float_t Lerp(float_t minimum, float_t maximum, float_t t) {
+  return minimum + (maximum - minimum) * t;
+}
+
+// Iris divides the image plane evenly among the pixels of the framebuffer
+// being rendered in the order of their indices. When rendering a tile, the
+// bounds it computes for a pixel of the tile's framebuffer are rescaled to the
+// bounds of the same pixel in the image.
+void MapToImage(size_t tile_index, size_t tile_size, size_t image_index,
+                size_t image_size, float_t* minimum, float_t* maximum) {
+  float_t tile_pixel_size = *maximum - *minimum;
+  float_t origin = *minimum - tile_pixel_size * (float_t)tile_index;
+  float_t image_pixel_size =
+      tile_pixel_size * (float_t)tile_size / (float_t)image_size;
+  *minimum = origin + image_pixel_size * (float_t)image_index;
+  *maximum = *minimum + image_pixel_size;
+}
+
+ISTATUS ProgressiveImageSamplerPrepareSamples(void* context, PRANDOM rng,
+                                           size_t column, size_t num_columns,
+                                           size_t row, size_t num_rows,
+                                           uint32_t* num_samples) {
+  ImageSamplerContext* sampler = static_cast<ImageSamplerContext*>(context);
+  const PassState& pass = *sampler->pass;
+  if (sampler->tile) {
+    column += sampler->tile->column;
+    row += sampler->tile->row;
+  }
+
+  // The active flags only cover the pixels within the bounds.
+  if (column < pass.bounds.min_column || pass.bounds.max_column <= column ||
+      row < pass.bounds.min_row || pass.bounds.max_row <= row) {
+    *num_samples = 0;
+    return ISTATUS_SUCCESS;
+  }
+
+  size_t pixel = row * pass.num_columns + column;
+  size_t bounds_pixel = (row - pass.bounds.min_row) * pass.bounds.NumColumns() +
+                        (column - pass.bounds.min_column);
+  if (!(*pass.active)[bounds_pixel]) {
+    *num_samples = 0;
+    return ISTATUS_SUCCESS;
+  }
+
+  sampler->column = column;
+  sampler->row = row;
+  sampler->pixel = pixel;
+  sampler->morton_code =
+      EncodeMorton2(static_cast<uint32_t>(column), static_cast<uint32_t>(row));
+  sampler->pixel_scramble = Hash(pixel);
+  sampler->lens_scramble = Hash(pixel + pass.num_columns * pass.num_rows);
+  sampler->sample_index = sampler->pass->first_sample_index;
+  *num_samples = sampler->pass->samples_per_pixel;
+
+  return ISTATUS_SUCCESS;
+}
+
+ISTATUS ProgressiveImageSamplerNextSample(
+    void* context, PRANDOM rng, float_t pixel_min_u, float_t pixel_max_u,
+    float_t pixel_min_v, float_t pixel_max_v, float_t lens_min_u,
+    float_t lens_max_u, float_t lens_min_v, float_t lens_max_v,
+    float_t* pixel_sample_u, float_t* pixel_sample_v, float_t* lens_sample_u,
+    float_t* lens_sample_v) {
+  ImageSamplerContext* sampler = static_cast<ImageSamplerContext*>(context);
+  uint32_t index = sampler->sample_index++;
+  SetSampleKey({sampler->pixel, index});
+
+  float_t pixel_u, pixel_v, lens_u, lens_v;
+  switch (sampler->pass->sequence) {
+    case ProgressiveSampler::Sequence::HALTON:
+      pixel_u = Rotate(RadicalInverse(2, index), sampler->pixel_scramble);
+      pixel_v =
+          Rotate(RadicalInverse(3, index), Hash(sampler->pixel_scramble));
+      break;
+    case ProgressiveSampler::Sequence::SOBOL:
+      pixel_u = ToUnitInterval((ReverseBits(index) ^ sampler->pixel_scramble) *
+                               0x1p-32);
+      pixel_v = ToUnitInterval((SobolSecondDimension(index) ^
+                                Hash(sampler->pixel_scramble)) *
+                               0x1p-32);
+      break;
+    case ProgressiveSampler::Sequence::ZSOBOL: {
+      // The first two dimensions of the Sobol sequence are used for both the
+      // pixel and the lens, with different index permutations and scrambles.
+      uint64_t morton_index =
+          (sampler->morton_code << sampler->pass->log2_samples) | index;
+      uint64_t pixel_index = ZSobolIndex(*sampler->pass, morton_index, 0);
+      uint64_t lens_index = ZSobolIndex(*sampler->pass, morton_index, 2);
+      pixel_u = ScrambledSobol(pixel_index, 0, 1);
+      pixel_v = ScrambledSobol(pixel_index, 1, 2);
+      lens_u = ScrambledSobol(lens_index, 0, 3);
+      lens_v = ScrambledSobol(lens_index, 1, 4);
+      break;
+    }
+    case ProgressiveSampler::Sequence::PMJ02BN: {
+      // Pixels are decorrelated by scrambling the binary digits of the
+      // sequences, which preserves their stratification. Samples past the end
+      // of the sequences repeat them with a different scramble.
+      uint32_t repetition = index / kPmj02bnSequenceLength;
+      uint32_t pixel_scramble = Hash(
+          ((uint64_t)repetition << 32) | sampler->pixel_scramble);
+      uint32_t lens_scramble = Hash(
+          ((uint64_t)repetition << 32) | sampler->lens_scramble);
+      const auto& pixel_sample =
+          Pmj02bnSequence(0)[index % kPmj02bnSequenceLength];
+      const auto& lens_sample =
+          Pmj02bnSequence(1)[index % kPmj02bnSequenceLength];
+      pixel_u = Scramble(pixel_sample[0], pixel_scramble);
+      pixel_v = Scramble(pixel_sample[1], Hash(pixel_scramble));
+      lens_u = Scramble(lens_sample[0], lens_scramble);
+      lens_v = Scramble(lens_sample[1], Hash(lens_scramble));
+      break;
+    }
+  }
+
+  if (sampler->pass->sequence == ProgressiveSampler::Sequence::HALTON ||
+      sampler->pass->sequence == ProgressiveSampler::Sequence::SOBOL) {
+    lens_u = Rotate(RadicalInverse(5, index), sampler->lens_scramble);
+    lens_v = Rotate(RadicalInverse(7, index), Hash(sampler->lens_scramble));
+  }
+
+  if (sampler->tile) {
+    const TileScheduler::Tile& tile = *sampler->tile;
+    MapToImage(sampler->column - tile.column, tile.num_columns,
+               sampler->column, sampler->pass->num_columns, &pixel_min_u,
+               &pixel_max_u);
+    MapToImage(sampler->row - tile.row, tile.num_rows, sampler->row,
+               sampler->pass->num_rows, &pixel_min_v, &pixel_max_v);
+  }
+
+  *pixel_sample_u = Lerp(pixel_min_u, pixel_max_u, pixel_u);
+  *pixel_sample_v = Lerp(pixel_min_v, pixel_max_v, pixel_v);
+  *lens_sample_u = Lerp(lens_min_u, lens_max_u, lens_u);
+  *lens_sample_v = Lerp(lens_min_v, lens_max_v, lens_v);
+
+  return ISTATUS_SUCCESS;
+}
+
+ISTATUS ProgressiveImageSamplerDuplicate(const void* context,
+                                      PIMAGE_SAMPLER* duplicate);
+
+const IMAGE_SAMPLER_VTABLE kProgressiveImageSamplerVTable = {
+    ProgressiveImageSamplerPrepareSamples, ProgressiveImageSamplerNextSample,
+    ProgressiveImageSamplerDuplicate, nullptr};
+
+ISTATUS ProgressiveImageSamplerDuplicate(const void* context,
+                                      PIMAGE_SAMPLER* duplicate) {
+  return ImageSamplerAllocate(&kProgressiveImageSamplerVTable, context,
+                              sizeof(ImageSamplerContext),
+                              alignof(ImageSamplerContext), duplicate);
+}
+
+Sampler AllocateImageSampler(const PassState& pass,
+                             const TileScheduler::Tile* tile) {
+  ImageSamplerContext context = {&pass, tile, 0, 0, 0, 0, 0, 0, 0};
+
+  Sampler result;
+  ISTATUS status = ImageSamplerAllocate(
+      &kProgressiveImageSamplerVTable, &context, sizeof(ImageSamplerContext),
+      alignof(ImageSamplerContext), result.release_and_get_address());
+  SuccessOrOOM(status);
+
+  return result;
+}
+
+// Returns the part of a tile within the bounds, which is empty if the tile is
+// entirely outside of them.
+TileScheduler::Tile ClipTile(TileScheduler::Tile tile,
+                             const PixelBounds& bounds) {
+  size_t max_column = std::min(tile.column + tile.num_columns,
+                               bounds.max_column);
+  size_t max_row = std::min(tile.row + tile.num_rows, bounds.max_row);
+  tile.column = std::max(tile.column, bounds.min_column);
+  tile.row = std::max(tile.row, bounds.min_row);
+  tile.num_columns = (tile.column < max_column) ? max_column - tile.column : 0;
+  tile.num_rows = (tile.row < max_row) ? max_row - tile.row : 0;
+  return tile;
+}
+
+// The pass framebuffer covers the pixels within the bounds of the pass. Tiles
+// that cross the bounds are rendered whole, with no samples taken outside of
+// the bounds, so that their pixels are mapped to the image exactly as in a
+// render of the whole image.
+void RenderTile(const ProgressiveSampler::RenderPass& render_pass,
+                const PassState& pass, const TileScheduler::Tile& tile,
+                PFRAMEBUFFER pass_framebuffer) {
+  TraceScope trace("render", "RenderTile", tile.index);
+  Framebuffer tile_framebuffer;
+  ISTATUS status =
+      FramebufferAllocate(tile.num_columns, tile.num_rows,
+                          tile_framebuffer.release_and_get_address());
+  SuccessOrOOM(status);
+
+  Sampler image_sampler = AllocateImageSampler(pass, &tile);
+  render_pass(pass.first_sample_index, tile.index, image_sampler.get(),
+              tile_framebuffer.get());
+
+  TileScheduler::Tile clipped = ClipTile(tile, pass.bounds);
+  for (size_t row = clipped.row; row < clipped.row + clipped.num_rows; row++) {
+    for (size_t column = clipped.column;
+         column < clipped.column + clipped.num_columns; column++) {
+      COLOR3 color;
+      status = FramebufferGetPixel(tile_framebuffer.get(),
+                                   column - tile.column, row - tile.row,
+                                   &color);
+      SuccessOrOOM(status);
+
+      status = FramebufferSetPixel(pass_framebuffer,
+                                   column - pass.bounds.min_column,
+                                   row - pass.bounds.min_row, color);
+      SuccessOrOOM(status);
+    }
+  }
+}
+
+// Counts the active pixels of the part of a tile within the bounds.
+size_t CountActive(const std::vector<uint8_t>& active,
+                   const PixelBounds& bounds, TileScheduler::Tile tile) {
+  tile = ClipTile(tile, bounds);
+  size_t result = 0;
+  for (size_t row = tile.row; row < tile.row + tile.num_rows; row++) {
+    auto begin = active.begin() +
+                 (row - bounds.min_row) * bounds.NumColumns() +
+                 (tile.column - bounds.min_column);
+    result += std::count_if(begin, begin + tile.num_columns,
+                            [](uint8_t value) { return value != 0; });
+  }
+  return result;
+}
+
+}  // namespace
+
+ProgressiveSampler::ProgressiveSampler(Sequence sequence,
+                                       uint32_t pixel_samples,
+                                       absl::optional<AdaptiveOptions> adaptive)
+    : m_sequence(sequence),
+      m_pixel_samples(pixel_samples),
+      m_adaptive(adaptive) {
+  assert(pixel_samples != 0);
+  assert(!adaptive || (pixel_samples <= adaptive->max_samples &&
+                       std::isfinite(adaptive->relative_error) &&
+                       (float_t)0.0 < adaptive->relative_error));
+}
+
+uint32_t ProgressiveSampler::NextPassSamples(uint32_t samples_taken) const {
+  if (!m_adaptive) {
+    uint32_t samples = std::max(UINT32_C(1), samples_taken);
+    return std::min(samples, m_pixel_samples - samples_taken);
+  }
+
+  uint32_t samples =
+      std::max(UINT32_C(1), m_pixel_samples / kInitialAdaptivePasses);
+  samples = std::max(samples, samples_taken / 4);
+  return std::min(samples, m_adaptive->max_samples - samples_taken);
+}
+
+uint32_t ProgressiveSampler::Render(const RenderPass& render_pass,
+                                    const RenderOptions& options,
+                                    Framebuffer& framebuffer) const {
+  absl::Time start_time = absl::Now();
+
+  size_t num_columns, num_rows;
+  FramebufferGetSize(framebuffer.get(), &num_columns, &num_rows);
+
+  PixelBounds bounds = options.pixel_bounds.value_or(
+      PixelBounds{0, num_columns, 0, num_rows});
+  assert(!bounds.Empty() && bounds.max_column <= num_columns &&
+         bounds.max_row <= num_rows);
+  bool whole_image = bounds.NumColumns() == num_columns &&
+                     bounds.NumRows() == num_rows;
+
+  Framebuffer pass_framebuffer;
+  ISTATUS status =
+      FramebufferAllocate(bounds.NumColumns(), bounds.NumRows(),
+                          pass_framebuffer.release_and_get_address());
+  SuccessOrOOM(status);
+
+  uint32_t max_samples = MaxSamples();
+
+  Checkpoint state;
+  state.sequence = static_cast<uint32_t>(m_sequence);
+  state.pixel_samples = m_pixel_samples;
+  state.max_samples = max_samples;
+  state.relative_error = m_adaptive ? m_adaptive->relative_error : 0.0;
+  state.num_columns = num_columns;
+  state.num_rows = num_rows;
+  state.pixel_bounds = bounds;
+  state.sample_offset = options.sample_offset;
+  state.first_sample_index = options.sample_offset;
+  state.statistics.resize(bounds.NumColumns() * bounds.NumRows(),
+                          PixelStatistics());
+  state.active.resize(bounds.NumColumns() * bounds.NumRows(), 1);
+
+  const auto& checkpoint = options.checkpoint;
+  if (checkpoint && checkpoint->resume) {
+    auto saved = ReadCheckpoint(checkpoint->path);
+    if (saved) {
+      if (saved->sequence != state.sequence ||
+          saved->pixel_samples != state.pixel_samples ||
+          saved->max_samples != state.max_samples ||
+          saved->relative_error != state.relative_error ||
+          saved->num_columns != state.num_columns ||
+          saved->num_rows != state.num_rows ||
+          saved->pixel_bounds.min_column != bounds.min_column ||
+          saved->pixel_bounds.max_column != bounds.max_column ||
+          saved->pixel_bounds.min_row != bounds.min_row ||
+          saved->pixel_bounds.max_row != bounds.max_row ||
+          saved->sample_offset != state.sample_offset) {
+        std::cerr << "ERROR: Checkpoint file was not written for this render: "
+                  << checkpoint->path << std::endl;
+        exit(EXIT_FAILURE);
+      }
+
+      state = std::move(*saved);
+    }
+  }
+
+  std::vector<PixelStatistics>& statistics = state.statistics;
+  std::vector<uint8_t>& active = state.active;
+  size_t num_active = std::count_if(active.begin(), active.end(),
+                                    [](uint8_t value) { return value != 0; });
+
+  ProgressTelemetry* telemetry = options.telemetry;
+  if (telemetry) {
+    for (const auto& pixel : statistics) {
+      telemetry->AddSamples(pixel.num_samples);
+    }
+    telemetry->SetTotalSamples(static_cast<uint64_t>(statistics.size()) *
+                               max_samples);
+  }
+
+  absl::Time last_checkpoint_time = start_time;
+  auto mean_color = [&](size_t column, size_t row) {
+    return Mean(statistics[(row - bounds.min_row) * bounds.NumColumns() +
+                           (column - bounds.min_column)]);
+  };
+
+  double pixel_samples_rendered = 0.0;
+  uint32_t log2_resolution = 0;
+  while ((size_t(1) << log2_resolution) < std::max(num_columns, num_rows)) {
+    log2_resolution += 1;
+  }
+
+  uint32_t log2_samples = 0;
+  while ((uint64_t(1) << log2_samples) <
+         (uint64_t)options.sample_offset + max_samples) {
+    log2_samples += 1;
+  }
+
+  // The zsobol index of a sample holds the Morton code of its pixel above the
+  // bits of its sample index.
+  uint32_t num_base4_digits = log2_resolution + (log2_samples + 1) / 2;
+  if (m_sequence == Sequence::ZSOBOL && 32 < num_base4_digits) {
+    std::cerr << "ERROR: The image resolution and number of samples are too "
+                 "large for the zsobol sampler"
+              << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  PassState pass = {m_sequence,
+                    0,
+                    state.first_sample_index,
+                    log2_samples,
+                    num_base4_digits,
+                    num_columns,
+                    num_rows,
+                    bounds,
+                    &active};
+
+  // Tiles are laid out over the whole image so that they, and so their
+  // random number streams, are the same whatever the bounds.
+  std::vector<TileScheduler::Tile> tiles;
+  if (options.tile_scheduler) {
+    for (const auto& tile :
+         options.tile_scheduler->Tiles(num_columns, num_rows)) {
+      TileScheduler::Tile clipped = ClipTile(tile, bounds);
+      if (clipped.num_columns != 0 && clipped.num_rows != 0) {
+        tiles.push_back(tile);
+      }
+    }
+  } else if (!whole_image) {
+    tiles.push_back({bounds.min_column, bounds.min_row, bounds.NumColumns(),
+                     bounds.NumRows(), 0});
+  }
+
+  uint32_t samples_taken = pass.first_sample_index - options.sample_offset;
+  while (num_active != 0 && samples_taken < max_samples) {
+    pass.samples_per_pixel = NextPassSamples(samples_taken);
+
+    absl::Duration elapsed = absl::Now() - start_time;
+    if (options.time_limit != absl::InfiniteDuration() &&
+        pixel_samples_rendered != 0.0) {
+      if (options.time_limit <= elapsed) {
+        break;
+      }
+
+      double pixel_samples_per_second =
+          pixel_samples_rendered / absl::ToDoubleSeconds(elapsed);
+      double affordable_samples =
+          absl::ToDoubleSeconds(options.time_limit - elapsed) *
+          pixel_samples_per_second / num_active;
+      if (affordable_samples < 1.0) {
+        break;
+      }
+
+      if (affordable_samples < pass.samples_per_pixel) {
+        pass.samples_per_pixel = static_cast<uint32_t>(affordable_samples);
+      }
+    }
+
+    if (options.tile_scheduler) {
+      std::vector<TileScheduler::Tile> pass_tiles;
+      for (const auto& tile : tiles) {
+        if (CountActive(active, bounds, tile) != 0) {
+          pass_tiles.push_back(tile);
+        }
+      }
+
+      // The active flags are only updated between passes.
+      options.tile_scheduler->Run(
+          pass_tiles, [&](const TileScheduler::Tile& tile) {
+            RenderTile(render_pass, pass, tile, pass_framebuffer.get());
+            if (telemetry) {
+              telemetry->AddSamples(
+                  static_cast<uint64_t>(CountActive(active, bounds, tile)) *
+                  pass.samples_per_pixel);
+            }
+          });
+    } else if (!whole_image) {
+      RenderTile(render_pass, pass, tiles[0], pass_framebuffer.get());
+    } else {
+      TraceScope trace("render", "RenderPass");
+      Sampler image_sampler = AllocateImageSampler(pass, nullptr);
+      render_pass(pass.first_sample_index, 0, image_sampler.get(),
+                  pass_framebuffer.get());
+    }
+
+    if (telemetry && !options.tile_scheduler) {
+      telemetry->AddSamples(static_cast<uint64_t>(num_active) *
+                            pass.samples_per_pixel);
+    }
+    pixel_samples_rendered +=
+        static_cast<double>(num_active) * pass.samples_per_pixel;
+
+    for (size_t row = 0; row < bounds.NumRows(); row++) {
+      for (size_t column = 0; column < bounds.NumColumns(); column++) {
+        size_t pixel = row * bounds.NumColumns() + column;
+        if (!active[pixel]) {
+          continue;
+        }
+
+        COLOR3 color;
+        status = FramebufferGetPixel(pass_framebuffer.get(), column, row,
+                                     &color);
+        SuccessOrOOM(status);
+
+        AddPass(color, pass.samples_per_pixel, &statistics[pixel]);
+
+        if (m_adaptive && m_pixel_samples <= statistics[pixel].num_samples &&
+            Converged(statistics[pixel], m_adaptive->relative_error)) {
+          active[pixel] = 0;
+          num_active -= 1;
+        }
+      }
+    }
+
+    pass.first_sample_index += pass.samples_per_pixel;
+    samples_taken += pass.samples_per_pixel;
+    state.first_sample_index = pass.first_sample_index;
+
+    absl::Time now = absl::Now();
+    if (checkpoint && checkpoint->interval <= now - last_checkpoint_time) {
+      WriteCheckpoint(checkpoint->path, state);
+      last_checkpoint_time = now;
+    }
+
+    if (options.preview && num_active != 0 && samples_taken < max_samples) {
+      options.preview->Publish(bounds, mean_color);
+    }
+  }
+
+  if (checkpoint) {
+    WriteCheckpoint(checkpoint->path, state);
+  }
+
+  if (options.preview) {
+    options.preview->Publish(bounds, mean_color, /*force=*/true);
+  }
+
+  for (size_t row = 0; row < bounds.NumRows(); row++) {
+    for (size_t column = 0; column < bounds.NumColumns(); column++) {
+      size_t pixel = row * bounds.NumColumns() + column;
+      status = FramebufferSetPixel(framebuffer.get(),
+                                   bounds.min_column + column,
+                                   bounds.min_row + row,
+                                   Mean(statistics[pixel]));
+      SuccessOrOOM(status);
+    }
+  }
+
+  return samples_taken;
+}
+
+}  // namespace iris
\ No newline at end of file
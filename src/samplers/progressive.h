@@ -0,0 +1,114 @@
+#ifndef _SRC_SAMPLERS_PROGRESSIVE_
+#define _SRC_SAMPLERS_PROGRESSIVE_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "absl/time/time.h"
+#include "absl/types/optional.h"
+#include "src/common/live_preview.h"
+#include "src/common/pixel_bounds.h"
+#include "src/common/pointer_types.h"
+#include "src/common/progress_telemetry.h"
+#include "src/common/tile_scheduler.h"
+
+namespace iris {
+
+// Renders an image in passes of increasing size, drawing samples from a
+// sequence that continues across passes so that the passes combine into the
+// same image as a single render with the total number of samples.
+//
+// If adaptive sampling is enabled, the variance of each pixel is estimated
+// from the passes rendered so far and pixels stop receiving samples once the
+// estimated relative error of their luminance falls below the target.
+class ProgressiveSampler {
+ public:
+  enum class Sequence { HALTON, SOBOL, ZSOBOL, PMJ02BN };
+
+  struct AdaptiveOptions {
+    uint16_t max_samples;
+    float_t relative_error;
+  };
+
+  // The state of the render is saved to path every interval and when
+  // rendering stops. If resume is set and path exists, rendering continues
+  // from the saved state instead of starting over.
+  struct CheckpointOptions {
+    std::string path;
+    absl::Duration interval;
+    bool resume;
+  };
+
+  // Passes are rendered until every pixel is done or until time_limit has
+  // elapsed. The pass in progress when the time limit expires is finished and
+  // passes that are not expected to finish in time are shortened.
+  //
+  // Samples are drawn starting from index sample_offset so that independent
+  // renders of the same image can each take a disjoint range of samples.
+  //
+  // If tile_scheduler is not null, each pass is split into tiles that are
+  // rendered concurrently and tiles without any unconverged pixels are
+  // skipped.
+  //
+  // If pixel_bounds is set, only the pixels within it are rendered and
+  // written to the framebuffer. They receive the same samples as they would
+  // in a render of the whole image.
+  //
+  // If preview is not null, the image formed by the passes completed so far
+  // is published to it between passes whenever it is due and once rendering
+  // stops.
+  //
+  // If telemetry is not null, the samples of each pixel are added to it as
+  // they are rendered and its total is set to the most samples the render
+  // could take.
+  struct RenderOptions {
+    absl::Duration time_limit;
+    uint32_t sample_offset;
+    absl::optional<CheckpointOptions> checkpoint;
+    TileScheduler* tile_scheduler;
+    absl::optional<PixelBounds> pixel_bounds;
+    LivePreview* preview;
+    ProgressTelemetry* telemetry;
+  };
+
+  // Renders one pass, or one tile of a pass, into framebuffer. The samples of
+  // the pass begin at first_sample_index, which is different for every pass
+  // of every render drawing from a disjoint range of samples. Together with
+  // tile_index, which is zero for untiled passes, it can be used to select an
+  // independent random number stream for the pass.
+  //
+  // When rendering a tile, or pixel bounds smaller than the image,
+  // framebuffer is the size of the tile and the image sampler maps its pixels
+  // onto the tile's area of the image. Tiles may be rendered concurrently.
+  typedef std::function<void(uint32_t first_sample_index, size_t tile_index,
+                             PCIMAGE_SAMPLER image_sampler,
+                             PFRAMEBUFFER framebuffer)>
+      RenderPass;
+
+  ProgressiveSampler(Sequence sequence, uint32_t pixel_samples,
+                     absl::optional<AdaptiveOptions> adaptive);
+
+  bool IsAdaptive() const { return m_adaptive.has_value(); }
+
+  // The number of samples each pixel takes if it never converges.
+  uint32_t MaxSamples() const {
+    return m_adaptive ? m_adaptive->max_samples : m_pixel_samples;
+  }
+
+  // Returns the largest number of samples taken by any pixel. Each pass draws
+  // the same samples whether or not the render was resumed.
+  uint32_t Render(const RenderPass& render_pass, const RenderOptions& options,
+                  Framebuffer& framebuffer) const;
+
+ private:
+  uint32_t NextPassSamples(uint32_t samples_taken) const;
+
+  Sequence m_sequence;
+  uint32_t m_pixel_samples;
+  absl::optional<AdaptiveOptions> m_adaptive;
+};
+
+}  // namespace iris
+
+#endif  // _SRC_SAMPLERS_PROGRESSIVE_
\ No newline at end of file
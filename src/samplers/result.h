@@ -0,0 +1,17 @@
+#ifndef _SRC_SAMPLERS_RESULT_
+#define _SRC_SAMPLERS_RESULT_
+
+#include <utility>
+
+#include "src/common/pointer_types.h"
+#include "src/samplers/progressive.h"
+
+namespace iris {
+
+// The image sampler is used when an image is rendered in a single pass and
+// may be null for samplers that can only be rendered progressively.
+typedef std::pair<Sampler, ProgressiveSampler> SamplerResult;
+
+}  // namespace iris
+
+#endif  // _SRC_SAMPLERS_RESULT_
\ No newline at end of file
@@ -12,7 +12,7 @@ static const uint16_t kSobolSamplerDefaultPixelSamples = 16;
 
 }  // namespace
 
-Sampler ParseSobol(Parameters& parameters) {
+SamplerResult ParseSobol(Parameters& parameters) {
   NonZeroSingleUInt16Matcher pixelsamples("pixelsamples", false,
                                           kSobolSamplerDefaultPixelSamples);
   parameters.Match(pixelsamples);
@@ -26,7 +26,9 @@ Sampler ParseSobol(Parameters& parameters) {
       sequence.get(), pixelsamples.Get(), result.release_and_get_address());
   SuccessOrOOM(status);
 
-  return result;
+  ProgressiveSampler progressive(ProgressiveSampler::Sequence::SOBOL,
+                                 pixelsamples.Get(), absl::nullopt);
+  return std::make_pair(std::move(result), std::move(progressive));
 }
 
 }  // namespace iris
\ No newline at end of file
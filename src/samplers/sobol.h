@@ -1,12 +1,12 @@
 #ifndef _SRC_SAMPLERS_SOBOL_
 #define _SRC_SAMPLERS_SOBOL_
 
-#include "src/common/pointer_types.h"
 #include "src/common/parameters.h"
+#include "src/samplers/result.h"
 
 namespace iris {
 
-Sampler ParseSobol(Parameters& parameters);
+SamplerResult ParseSobol(Parameters& parameters);
 
 }  // namespace iris
 
@@ -14,7 +14,7 @@ static const uint16_t kStratifiedSamplerDefaultYSamples = 2;
 
 }  // namespace
 
-Sampler ParseStratified(Parameters& parameters) {
+SamplerResult ParseStratified(Parameters& parameters) {
   SingleBoolMatcher jitter("jitter", false, kStratifiedSamplerDefaultJitter);
   NonZeroSingleUInt16Matcher xsamples("xsamples", false,
                                       kStratifiedSamplerDefaultXSamples);
@@ -28,7 +28,13 @@ Sampler ParseStratified(Parameters& parameters) {
                                1, false, result.release_and_get_address());
   SuccessOrOOM(status);
 
-  return result;
+  // Progressive renders use a Sobol sequence, whose first two dimensions are
+  // stratified at every power of two.
+  uint32_t pixel_samples =
+      static_cast<uint32_t>(xsamples.Get()) * ysamples.Get();
+  ProgressiveSampler progressive(ProgressiveSampler::Sequence::SOBOL,
+                                 pixel_samples, absl::nullopt);
+  return std::make_pair(std::move(result), std::move(progressive));
 }
 
 }  // namespace iris
\ No newline at end of file
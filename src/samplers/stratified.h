@@ -1,12 +1,12 @@
 #ifndef _SRC_SAMPLERS_STRATIFIED_
 #define _SRC_SAMPLERS_STRATIFIED_
 
-#include "src/common/pointer_types.h"
 #include "src/common/parameters.h"
+#include "src/samplers/result.h"
 
 namespace iris {
 
-Sampler ParseStratified(Parameters& parameters);
+SamplerResult ParseStratified(Parameters& parameters);
 
 }  // namespace iris
 
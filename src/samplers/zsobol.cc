@@ -0,0 +1,24 @@
+#include "src/samplers/zsobol.h"
+
+#include "src/param_matchers/integral_single.h"
+
+namespace iris {
+namespace {
+
+static const uint16_t kZSobolSamplerDefaultPixelSamples = 16;
+
+}  // namespace
+
+// There is no single pass implementation of this sampler, so images are
+// always rendered progressively.
+SamplerResult ParseZSobol(Parameters& parameters) {
+  NonZeroSingleUInt16Matcher pixelsamples("pixelsamples", false,
+                                          kZSobolSamplerDefaultPixelSamples);
+  parameters.Match(pixelsamples);
+
+  ProgressiveSampler progressive(ProgressiveSampler::Sequence::ZSOBOL,
+                                 pixelsamples.Get(), absl::nullopt);
+  return std::make_pair(Sampler(), std::move(progressive));
+}
+
+}  // namespace iris
\ No newline at end of file
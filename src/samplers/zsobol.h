@@ -0,0 +1,13 @@
+#ifndef _SRC_SAMPLERS_ZSOBOL_
+#define _SRC_SAMPLERS_ZSOBOL_
+
+#include "src/common/parameters.h"
+#include "src/samplers/result.h"
+
+namespace iris {
+
+SamplerResult ParseZSobol(Parameters& parameters);
+
+}  // namespace iris
+
+#endif  // _SRC_SAMPLERS_ZSOBOL_
\ No newline at end of file
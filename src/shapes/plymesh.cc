@@ -10,7 +10,10 @@
 #include "rply.h"
 #include "rplyfile.h"
 #include "src/common/error.h"
+#include "src/common/input_stream.h"
 #include "src/common/ostream.h"
+#include "src/common/run_statistics.h"
+#include "src/common/trace.h"
 #include "src/param_matchers/file.h"
 #include "src/param_matchers/float_texture.h"
 
@@ -497,7 +500,8 @@ static void InitializeUVCallbacks(p_ply ply, PlyData* ply_data,
 
 PlyData ReadPlyFile(absl::string_view file_name,
                     const std::string& resolved_file_name) {
-  FILE* file = fopen(resolved_file_name.c_str(), "rb");
+  TraceScope trace("load", "ReadPlyFile", file_name);
+  FILE* file = OpenInputFile(resolved_file_name);
   if (!file) {
     std::cerr << "ERROR: Failed to open PLY file: " << file_name << std::endl;
     exit(EXIT_FAILURE);
@@ -562,9 +566,14 @@ PlyData ReadPlyFile(absl::string_view file_name,
   }
 
   int read_status = ply_read(ply);
+  long bytes_read = ftell(file);
   ply_close(ply);
   fclose(file);
 
+  if (0 < bytes_read) {
+    IncrementCounter(Counter::PLY_BYTES_READ, bytes_read);
+  }
+
   if (read_status != kRplySuccess) {
     std::cerr << "ERROR: Unexpected failure reading PLY file" << std::endl;
     exit(EXIT_FAILURE);
@@ -625,6 +634,18 @@ PlyData ReadPlyFile(absl::string_view file_name,
 
 }  // namespace
 
+void ReadPlyMesh(absl::string_view file_name,
+                 const std::string& resolved_file_name,
+                 std::vector<POINT3>* vertices, std::vector<VECTOR3>* normals,
+                 std::vector<std::pair<float_t, float_t>>* uvs,
+                 std::vector<size_t>* faces) {
+  PlyData fileData = ReadPlyFile(file_name, resolved_file_name);
+  *vertices = std::move(fileData.GetVertices());
+  *normals = std::move(fileData.GetNormals());
+  *uvs = fileData.GetUVs();
+  *faces = fileData.GetFaces();
+}
+
 ShapeResult ParsePlyMesh(Parameters& parameters, const Matrix& model_to_world,
                          MaterialManager& material_manager,
                          const NamedTextureManager& named_texture_manager,
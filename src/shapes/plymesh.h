@@ -1,6 +1,10 @@
 #ifndef _SRC_SHAPES_PLYMESH_
 #define _SRC_SHAPES_PLYMESH_
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "src/common/parameters.h"
 #include "src/materials/result.h"
 #include "src/shapes/result.h"
@@ -17,6 +21,14 @@ ShapeResult ParsePlyMesh(Parameters& parameters, const Matrix& model_to_world,
                          const EmissiveMaterial& front_emissive_material,
                          const EmissiveMaterial& back_emissive_material);
 
+// Reads the contents of a PLY file without creating any shapes. The faces
+// are returned as triangle indices and normals and uvs may be empty.
+void ReadPlyMesh(absl::string_view file_name,
+                 const std::string& resolved_file_name,
+                 std::vector<POINT3>* vertices, std::vector<VECTOR3>* normals,
+                 std::vector<std::pair<float_t, float_t>>* uvs,
+                 std::vector<size_t>* faces);
+
 }  // namespace iris
 
 #endif  // _SRC_SHAPES_PLYMESH_
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <iostream>
 
 #include "iris_physx_toolkit/shapes/triangle_mesh.h"
+#include "iris_physx_toolkit/triangle_mesh_normal_map.h"
+#include "iris_physx_toolkit/triangle_mesh_texture_coordinate_map.h"
 #include "src/common/error.h"
 #include "src/common/ostream.h"
 #include "src/param_matchers/float_texture.h"
@@ -16,8 +18,16 @@ typedef ListValueMatcher<Point3Parameter, POINT3, 3, 1>
 
 typedef ListValueMatcher<IntParameter, int, 3, 3> TriangleMeshIndexListMatcher;
 
+typedef ListValueMatcher<NormalParameter, VECTOR3, 1, 1>
+    TriangleMeshNormalListMatcher;
+
+typedef ListValueMatcher<FloatParameter, float_t, 2, 2>
+    TriangleMeshUVListMatcher;
+
 static const std::vector<POINT3> kTriangleMeshDefaultPoints;
 static const std::vector<int> kTriangleMeshDefaultIndices;
+static const std::vector<VECTOR3> kTriangleMeshDefaultNormals;
+static const std::vector<float_t> kTriangleMeshDefaultUVs;
 static const FloatTexture kTriangleMeshDefaultAlpha;
 
 }  // namespace
@@ -35,11 +45,14 @@ ShapeResult ParseTriangleMesh(Parameters& parameters,
   TriangleMeshPointListMatcher points("P", true, kTriangleMeshDefaultPoints);
   TriangleMeshIndexListMatcher int_indices("indices", true,
                                            kTriangleMeshDefaultIndices);
+  TriangleMeshNormalListMatcher normals("N", false,
+                                        kTriangleMeshDefaultNormals);
+  TriangleMeshUVListMatcher uvs("uv", false, kTriangleMeshDefaultUVs);
   FloatTextureMatcher alpha("alpha", false, true, (float_t)0.0, (float_t)1.0,
                             named_texture_manager, texture_manager,
                             kTriangleMeshDefaultAlpha);
   auto unused_parameters =
-      parameters.MatchAllowUnused(points, int_indices, alpha);
+      parameters.MatchAllowUnused(points, int_indices, normals, uvs, alpha);
   auto material = material_result(unused_parameters, material_manager,
                                   named_texture_manager, normal_map_manager,
                                   texture_manager, spectrum_manager);
@@ -59,18 +72,57 @@ ShapeResult ParseTriangleMesh(Parameters& parameters,
     indices.push_back(entry);
   }
 
+  if (!normals.Get().empty() && normals.Get().size() != points.Get().size()) {
+    std::cerr << "ERROR: Wrong number of values for "
+              << unused_parameters.Name() << " parameter: N" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
+  if (!uvs.Get().empty() && uvs.Get().size() != 2 * points.Get().size()) {
+    std::cerr << "ERROR: Wrong number of values for "
+              << unused_parameters.Name() << " parameter: uv" << std::endl;
+    exit(EXIT_FAILURE);
+  }
+
   // TODO: Check for nonsensical indices
 
   for (auto& point : points.GetMutable()) {
     point = PointMatrixMultiply(model_to_world.get(), point);
   }
 
+  for (auto& normal : normals.GetMutable()) {
+    normal =
+        VectorMatrixInverseTransposedMultiply(model_to_world.get(), normal);
+    normal = VectorNormalize(normal, nullptr, nullptr);
+  }
+
+  TextureCoordinateMaps texture_coordinate_map;
+  if (!uvs.Get().empty()) {
+    ISTATUS status = TriangleMeshTextureCoordinateMapAllocate(
+        reinterpret_cast<const float_t(*)[2]>(uvs.Get().data()),
+        uvs.Get().size() / 2, texture_coordinate_map.release_and_get_address());
+    SuccessOrOOM(status);
+  }
+
+  NormalMap front_normal_map, back_normal_map;
+  if (material.second.get()) {
+    front_normal_map = material.second;
+    back_normal_map = material.second;
+  } else if (!normals.Get().empty()) {
+    ISTATUS status = TriangleMeshNormalMapAllocate(
+        normals.Get().data(), normals.Get().size(),
+        front_normal_map.release_and_get_address());
+    back_normal_map = front_normal_map;
+    SuccessOrOOM(status);
+  }
+
   std::vector<Shape> shapes(indices.size() / 3);
   size_t triangles_allocated;
   ISTATUS status = TriangleMeshAllocate(
       points.Get().data(), points.Get().size(),
       reinterpret_cast<const size_t(*)[3]>(indices.data()), indices.size() / 3,
-      nullptr, nullptr, nullptr, nullptr, material.first.get(),
+      texture_coordinate_map.get(), texture_coordinate_map.get(),
+      front_normal_map.get(), back_normal_map.get(), material.first.get(),
       material.first.get(), front_emissive_material.get(),
       back_emissive_material.get(), reinterpret_cast<PSHAPE*>(shapes.data()),
       &triangles_allocated);
@@ -69,25 +69,17 @@ ReflectorTexture ParseImageMapReflector(
       trilinear.Get() ? TEXTURE_FILTERING_ALGORITHM_TRILINEAR
                       : TEXTURE_FILTERING_ALGORITHM_EWA;
 
-  ReflectorMipmap mipmap;
-  ISTATUS status = PngReflectorMipmapAllocate(
-      filename.Get().second.c_str(), algorithm, *maxanisotropy.Get(), wrap_mode,
-      spectrum_manager.GetColorExtrapolator().get(),
-      mipmap.release_and_get_address());
-  switch (status) {
-    case ISTATUS_IO_ERROR:
-      std::cerr << "ERROR: Failed to read PNG file: " << filename.Get().first
-                << std::endl;
-      exit(EXIT_FAILURE);
-    case ISTATUS_ALLOCATION_FAILED:
-      ReportOOM();
-    default:
-      assert(status == ISTATUS_SUCCESS);
+  auto* result = texture_manager.AllocatePngReflectorTexture(
+      filename.Get().second, algorithm, *maxanisotropy.Get(), wrap_mode,
+      *u_delta.Get(), *v_delta.Get(), *u_scale.Get(), *v_scale.Get(),
+      spectrum_manager);
+  if (!result) {
+    std::cerr << "ERROR: Failed to read PNG file: " << filename.Get().first
+              << std::endl;
+    exit(EXIT_FAILURE);
   }
 
-  return texture_manager.AllocateImageMapReflectorTexture(
-      std::move(mipmap), *u_delta.Get(), *v_delta.Get(), *u_scale.Get(),
-      *v_scale.Get());
+  return *result;
 }
 
 FloatTexture ParseImageMapFloat(
@@ -137,24 +129,16 @@ FloatTexture ParseImageMapFloat(
       trilinear.Get() ? TEXTURE_FILTERING_ALGORITHM_TRILINEAR
                       : TEXTURE_FILTERING_ALGORITHM_EWA;
 
-  FloatMipmap mipmap;
-  ISTATUS status = PngFloatMipmapAllocate(
-      filename.Get().second.c_str(), algorithm, *maxanisotropy.Get(), wrap_mode,
-      mipmap.release_and_get_address());
-  switch (status) {
-    case ISTATUS_IO_ERROR:
-      std::cerr << "ERROR: Failed to read PNG file: " << filename.Get().first
-                << std::endl;
-      exit(EXIT_FAILURE);
-    case ISTATUS_ALLOCATION_FAILED:
-      ReportOOM();
-    default:
-      assert(status == ISTATUS_SUCCESS);
+  auto* result = texture_manager.AllocatePngFloatTexture(
+      filename.Get().second, algorithm, *maxanisotropy.Get(), wrap_mode,
+      *u_delta.Get(), *v_delta.Get(), *u_scale.Get(), *v_scale.Get());
+  if (!result) {
+    std::cerr << "ERROR: Failed to read PNG file: " << filename.Get().first
+              << std::endl;
+    exit(EXIT_FAILURE);
   }
 
-  return texture_manager.AllocateImageMapFloatTexture(
-      std::move(mipmap), *u_delta.Get(), *v_delta.Get(), *u_scale.Get(),
-      *v_scale.Get());
+  return *result;
 }
 
 }  // namespace iris
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+#include "src/common/arena.h"
+#include "src/common/directive.h"
+#include "src/common/tokenizer.h"
+#include "src/param_matchers/list.h"
+
+using iris::Arena;
+using iris::ArenaAllocator;
+using iris::ArenaVector;
+using iris::Directive;
+using iris::IntParameter;
+using iris::ListValueMatcher;
+using iris::Parameters;
+using iris::ThreadArena;
+using iris::Tokenizer;
+
+namespace {
+
+typedef ListValueMatcher<IntParameter, int, 1, 1> IntListMatcher;
+typedef ListValueMatcher<IntParameter, int, 1, 1, 3> BoundedIntListMatcher;
+
+// Ints that fit in the arena and ints that are too large for it.
+static const size_t kSmallSize = 16;
+static const size_t kLargeSize = Arena::kMaxAllocation / sizeof(int) + 1;
+
+bool operator==(const Arena::Position& left, const Arena::Position& right) {
+  return left.blocks_used == right.blocks_used && left.offset == right.offset;
+}
+
+std::string WriteFile(const std::string& name, const std::string& contents) {
+  std::string path = testing::TempDir() + name;
+  std::ofstream output(path, std::ios::binary);
+  output << contents;
+  return path;
+}
+
+std::string IntList(size_t size, int first) {
+  std::string result = "Test \"list\" \"integer values\" [";
+  for (size_t i = 0; i < size; i++) {
+    result += " " + std::to_string(first + static_cast<int>(i));
+  }
+  return result + " ]\n";
+}
+
+// Parses a list directive and returns its values, which must outlive the
+// directive that parsed them.
+ArenaVector<int> ParseValues(Tokenizer& tokenizer) {
+  ArenaVector<int> result;
+  EXPECT_EQ("Test", tokenizer.Next());
+  Directive directive("Test", tokenizer);
+  directive.Invoke(Directive::Implementations<void>{
+      {"list", [&](Parameters& parameters) {
+         IntListMatcher values("values", true, {});
+         parameters.Match(values);
+         result = std::move(values.GetMutable());
+       }}});
+  return result;
+}
+
+void ExpectValues(const ArenaVector<int>& values, size_t size, int first) {
+  ASSERT_EQ(size, values.size());
+  for (size_t i = 0; i < size; i++) {
+    EXPECT_EQ(first + static_cast<int>(i), values[i]);
+  }
+}
+
+}  // namespace
+
+TEST(ArenaTests, MarkAndRewind) {
+  Arena arena;
+  void* first = arena.Allocate(16, 8);
+  Arena::Position mark = arena.Mark();
+
+  void* second = arena.Allocate(32, 16);
+  EXPECT_NE(first, second);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(second) % 16);
+  EXPECT_FALSE(arena.Mark() == mark);
+
+  arena.Release(second);
+  arena.Rewind(mark);
+  EXPECT_TRUE(arena.Mark() == mark);
+  EXPECT_EQ(second, arena.Allocate(32, 16));
+}
+
+TEST(ArenaTests, RewindReusesBlocks) {
+  Arena arena;
+  Arena::Position mark = arena.Mark();
+
+  std::vector<void*> allocations;
+  for (size_t i = 0; i < 2 * Arena::kBlockSize / Arena::kMaxAllocation; i++) {
+    allocations.push_back(arena.Allocate(Arena::kMaxAllocation, 8));
+  }
+  EXPECT_EQ(2u, arena.Mark().blocks_used);
+
+  for (void* allocation : allocations) {
+    arena.Release(allocation);
+  }
+  arena.Rewind(mark);
+
+  for (void* allocation : allocations) {
+    EXPECT_EQ(allocation, arena.Allocate(Arena::kMaxAllocation, 8));
+  }
+}
+
+TEST(ArenaTests, RewindPastLiveStorage) {
+  Arena arena;
+  Arena::Position mark = arena.Mark();
+  arena.Allocate(16, 8);
+  EXPECT_DEBUG_DEATH(arena.Rewind(mark), "");
+}
+
+TEST(ArenaTests, LargeAllocationsUseHeap) {
+  Arena arena;
+  Arena::Position mark = arena.Mark();
+
+  ArenaVector<int> large((ArenaAllocator<int>(arena)));
+  large.reserve(kLargeSize);
+  EXPECT_TRUE(arena.Mark() == mark);
+
+  ArenaVector<int> small((ArenaAllocator<int>(arena)));
+  small.reserve(kSmallSize);
+  EXPECT_FALSE(arena.Mark() == mark);
+}
+
+TEST(ArenaTests, NestedDirectives) {
+  Tokenizer tokenizer = Tokenizer::CreateFromFile(WriteFile(
+      "nested.pbrt", IntList(kSmallSize, 0) + IntList(kSmallSize, 100)));
+  Arena::Position mark = ThreadArena().Mark();
+
+  {
+    EXPECT_EQ("Test", tokenizer.Next());
+    Directive outer("Test", tokenizer);
+    outer.Invoke(Directive::Implementations<void>{
+        {"list", [&](Parameters& parameters) {
+           IntListMatcher values("values", true, {});
+           parameters.Match(values);
+           ExpectValues(values.Get(), kSmallSize, 0);
+           EXPECT_FALSE(ThreadArena().Mark() == mark);
+
+           ArenaVector<int> outer_values(values.Get().begin(),
+                                         values.Get().end(),
+                                         ArenaAllocator<int>(ThreadArena()));
+           Arena::Position outer_mark = ThreadArena().Mark();
+
+           ExpectValues(ParseValues(tokenizer), kSmallSize, 100);
+           EXPECT_TRUE(ThreadArena().Mark() == outer_mark);
+           ExpectValues(outer_values, kSmallSize, 0);
+         }}});
+  }
+
+  EXPECT_TRUE(ThreadArena().Mark() == mark);
+}
+
+TEST(ArenaTests, StealSmall) {
+  Tokenizer tokenizer = Tokenizer::CreateFromFile(WriteFile(
+      "small.pbrt", IntList(kSmallSize, 0) + IntList(kSmallSize, 100)));
+
+  ArenaVector<int> first = ParseValues(tokenizer);
+  ArenaVector<int> second = ParseValues(tokenizer);
+  ExpectValues(first, kSmallSize, 0);
+  ExpectValues(second, kSmallSize, 100);
+}
+
+TEST(ArenaTests, StealLarge) {
+  Tokenizer tokenizer = Tokenizer::CreateFromFile(WriteFile(
+      "large.pbrt", IntList(kLargeSize, 0) + IntList(kLargeSize, 100)));
+
+  ArenaVector<int> first = ParseValues(tokenizer);
+  ArenaVector<int> second = ParseValues(tokenizer);
+  ExpectValues(first, kLargeSize, 0);
+  ExpectValues(second, kLargeSize, 100);
+}
+
+TEST(ArenaTests, ListMaximum) {
+  testing::FLAGS_gtest_death_test_style = "threadsafe";
+
+  Tokenizer tokenizer = Tokenizer::CreateFromFile(
+      WriteFile("maximum.pbrt", IntList(3, 0) + IntList(4, 0)));
+
+  EXPECT_EQ("Test", tokenizer.Next());
+  Directive directive("Test", tokenizer);
+  directive.Invoke(Directive::Implementations<void>{
+      {"list", [&](Parameters& parameters) {
+         BoundedIntListMatcher values("values", true, {});
+         parameters.Match(values);
+         ExpectValues(values.Get(), 3, 0);
+       }}});
+
+  EXPECT_EXIT(
+      {
+        tokenizer.Next();
+        Directive directive("Test", tokenizer);
+        directive.Invoke(Directive::Implementations<void>{
+            {"list", [&](Parameters& parameters) {
+               BoundedIntListMatcher values("values", true, {});
+               parameters.Match(values);
+             }}});
+      },
+      testing::ExitedWithCode(EXIT_FAILURE),
+      "ERROR: Wrong number of values for list Test parameter: values");
+}
\ No newline at end of file
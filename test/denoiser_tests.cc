@@ -0,0 +1,168 @@
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+#include "src/common/denoiser.h"
+
+using iris::Aov;
+using iris::AovBuffer;
+using iris::Framebuffer;
+
+namespace {
+
+static const size_t kSize = 64;
+static const size_t kRadius = 5;
+static const size_t kNumThreads = 2;
+
+double NextUniform(uint64_t* state) {
+  *state = *state * 6364136223846793005u + 1442695040888963407u;
+  return (*state >> 11) * 0x1p-53;
+}
+
+AovBuffer MakeFeature(Aov aov,
+                      const std::function<std::vector<float>(size_t)>& value) {
+  AovBuffer result;
+  result.aov = aov;
+  result.num_columns = kSize;
+  result.num_rows = kSize;
+  for (size_t row = 0; row < kSize; row++) {
+    for (size_t column = 0; column < kSize; column++) {
+      for (float channel : value(column)) {
+        result.values.push_back(channel);
+      }
+    }
+  }
+
+  result.channels.resize(result.values.size() / (kSize * kSize));
+  return result;
+}
+
+// An image whose pixels are gray with the luminance returned by value.
+Framebuffer MakeImage(const std::function<double(size_t, size_t)>& value) {
+  Framebuffer result;
+  ISTATUS status = FramebufferAllocate(kSize, kSize,
+                                       result.release_and_get_address());
+  EXPECT_EQ(ISTATUS_SUCCESS, status);
+
+  for (size_t row = 0; row < kSize; row++) {
+    for (size_t column = 0; column < kSize; column++) {
+      float_t luminance = static_cast<float_t>(value(column, row));
+      float_t values[3] = {luminance, luminance, luminance};
+      status = FramebufferSetPixel(
+          result.get(), column, row,
+          ColorCreate(COLOR_SPACE_LINEAR_SRGB, values));
+      EXPECT_EQ(ISTATUS_SUCCESS, status);
+    }
+  }
+
+  return result;
+}
+
+double Pixel(const Framebuffer& framebuffer, size_t column, size_t row) {
+  COLOR3 color;
+  ISTATUS status =
+      FramebufferGetPixel(framebuffer.get(), column, row, &color);
+  EXPECT_EQ(ISTATUS_SUCCESS, status);
+  color = ColorConvert(color, COLOR_SPACE_LINEAR_SRGB);
+  EXPECT_EQ(color.values[0], color.values[1]);
+  EXPECT_EQ(color.values[0], color.values[2]);
+  return color.values[0];
+}
+
+// The mean and variance of the pixels of the columns [min_column,
+// max_column).
+void ColumnStatistics(const Framebuffer& framebuffer, size_t min_column,
+                      size_t max_column, double* mean, double* variance) {
+  double sum = 0.0;
+  double sum_of_squares = 0.0;
+  for (size_t row = 0; row < kSize; row++) {
+    for (size_t column = min_column; column < max_column; column++) {
+      double value = Pixel(framebuffer, column, row);
+      sum += value;
+      sum_of_squares += value * value;
+    }
+  }
+
+  double count = static_cast<double>(kSize * (max_column - min_column));
+  *mean = sum / count;
+  *variance = sum_of_squares / count - *mean * *mean;
+}
+
+std::vector<float> Gray(float albedo) { return {albedo, albedo, albedo}; }
+
+std::vector<float> Facing(float x, float z) { return {x, 0.0f, z}; }
+
+}  // namespace
+
+TEST(DenoiserTests, RemovesNoise) {
+  uint64_t state = 1;
+  Framebuffer framebuffer = MakeImage([&](size_t column, size_t row) {
+    return 0.25 + 0.5 * NextUniform(&state);
+  });
+
+  std::vector<AovBuffer> features = {
+      MakeFeature(Aov::ALBEDO, [](size_t column) { return Gray(0.5f); }),
+      MakeFeature(Aov::NORMAL,
+                  [](size_t column) { return Facing(0.0f, 1.0f); })};
+
+  double noisy_mean, noisy_variance;
+  ColumnStatistics(framebuffer, 0, kSize, &noisy_mean, &noisy_variance);
+
+  iris::Denoise(features, kRadius, kNumThreads, framebuffer);
+
+  double mean, variance;
+  ColumnStatistics(framebuffer, 0, kSize, &mean, &variance);
+  EXPECT_NEAR(noisy_mean, mean, 0.01);
+  EXPECT_LT(variance, 0.1 * noisy_variance);
+}
+
+// The left half of the image is dark and the right half is bright because
+// of their albedos, while the lighting of both is the same.
+TEST(DenoiserTests, KeepsAlbedoEdges) {
+  uint64_t state = 2;
+  Framebuffer framebuffer = MakeImage([&](size_t column, size_t row) {
+    double albedo = (column < kSize / 2) ? 0.2 : 0.8;
+    return albedo * (0.75 + 0.5 * NextUniform(&state));
+  });
+
+  std::vector<AovBuffer> features = {
+      MakeFeature(Aov::ALBEDO,
+                  [](size_t column) {
+                    return Gray((column < kSize / 2) ? 0.2f : 0.8f);
+                  }),
+      MakeFeature(Aov::NORMAL,
+                  [](size_t column) { return Facing(0.0f, 1.0f); })};
+
+  iris::Denoise(features, kRadius, kNumThreads, framebuffer);
+
+  double mean, variance;
+  ColumnStatistics(framebuffer, kSize / 2 - 1, kSize / 2, &mean, &variance);
+  EXPECT_NEAR(0.2, mean, 0.01);
+  ColumnStatistics(framebuffer, kSize / 2, kSize / 2 + 1, &mean, &variance);
+  EXPECT_NEAR(0.8, mean, 0.04);
+}
+
+// The left half of the image faces away from the light and is dark, while
+// the right half faces it and is bright, with the same albedo.
+TEST(DenoiserTests, KeepsNormalEdges) {
+  uint64_t state = 3;
+  Framebuffer framebuffer = MakeImage([&](size_t column, size_t row) {
+    double lighting = (column < kSize / 2) ? 0.2 : 1.0;
+    return 0.5 * lighting * (0.75 + 0.5 * NextUniform(&state));
+  });
+
+  std::vector<AovBuffer> features = {
+      MakeFeature(Aov::ALBEDO, [](size_t column) { return Gray(0.5f); }),
+      MakeFeature(Aov::NORMAL, [](size_t column) {
+        return (column < kSize / 2) ? Facing(1.0f, 0.0f) : Facing(0.0f, 1.0f);
+      })};
+
+  iris::Denoise(features, kRadius, kNumThreads, framebuffer);
+
+  double mean, variance;
+  ColumnStatistics(framebuffer, kSize / 2 - 1, kSize / 2, &mean, &variance);
+  EXPECT_NEAR(0.1, mean, 0.01);
+  ColumnStatistics(framebuffer, kSize / 2, kSize / 2 + 1, &mean, &variance);
+  EXPECT_NEAR(0.5, mean, 0.02);
+}
\ No newline at end of file
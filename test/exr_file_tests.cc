@@ -0,0 +1,213 @@
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+#include "src/films/output_writers/exr_file.h"
+#include "tinyexr.h"
+
+using iris::ExrCompression;
+using iris::ExrPixelType;
+using iris::WriteExr;
+
+namespace {
+
+static const size_t kNumColumns = 67;
+static const size_t kNumRows = 37;
+static const size_t kNumThreads = 3;
+
+// The channels of an image with an albedo and a depth AOV, in the order in
+// which the output writer passes them rather than the sorted order in which
+// they are stored.
+static const std::vector<std::string> kChannels = {
+    "R", "G", "B", "albedo.R", "albedo.G", "albedo.B", "depth.Y"};
+
+static const ExrCompression kCompressions[] = {
+    ExrCompression::NONE, ExrCompression::ZIPS, ExrCompression::ZIP};
+
+static const ExrPixelType kPixelTypes[] = {ExrPixelType::HALF,
+                                           ExrPixelType::FLOAT};
+
+// Values that are exactly representable as halves and that differ between
+// the channels of each pixel.
+float Value(size_t channel, size_t column, size_t row) {
+  float sign = (channel % 2 == 0) ? 1.0f : -1.0f;
+  return sign * (static_cast<float>((row * 7 + channel) % 16) +
+                 static_cast<float>(column) / 64.0f);
+}
+
+void ReadRow(size_t row, const std::vector<float*>& channels) {
+  for (size_t channel = 0; channel < channels.size(); channel++) {
+    for (size_t column = 0; column < kNumColumns; column++) {
+      channels[channel][column] = Value(channel, column, row);
+    }
+  }
+}
+
+std::string Path(ExrCompression compression, ExrPixelType pixel_type) {
+  return testing::TempDir() + "exr_file_" +
+         std::to_string(static_cast<int>(compression)) + "_" +
+         std::to_string(static_cast<int>(pixel_type)) + ".exr";
+}
+
+int CompressionType(ExrCompression compression) {
+  switch (compression) {
+    case ExrCompression::NONE:
+      return TINYEXR_COMPRESSIONTYPE_NONE;
+    case ExrCompression::ZIPS:
+      return TINYEXR_COMPRESSIONTYPE_ZIPS;
+    case ExrCompression::ZIP:
+      return TINYEXR_COMPRESSIONTYPE_ZIP;
+  }
+
+  return -1;
+}
+
+int PixelType(ExrPixelType pixel_type) {
+  return (pixel_type == ExrPixelType::HALF) ? TINYEXR_PIXELTYPE_HALF
+                                            : TINYEXR_PIXELTYPE_FLOAT;
+}
+
+// Reads the file back with tinyexr and checks its header and the values of
+// each of its channels.
+void CheckExr(const std::string& path, ExrCompression compression,
+              ExrPixelType pixel_type) {
+  EXRVersion version;
+  ASSERT_EQ(TINYEXR_SUCCESS, ParseEXRVersionFromFile(&version, path.c_str()));
+  EXPECT_FALSE(version.tiled);
+  EXPECT_FALSE(version.multipart);
+
+  EXRHeader header;
+  InitEXRHeader(&header);
+  const char* error = nullptr;
+  ASSERT_EQ(TINYEXR_SUCCESS, ParseEXRHeaderFromFile(&header, &version,
+                                                    path.c_str(), &error))
+      << error;
+  EXPECT_EQ(CompressionType(compression), header.compression_type);
+
+  std::map<std::string, size_t> channel_indices;
+  ASSERT_EQ(static_cast<int>(kChannels.size()), header.num_channels);
+  for (int i = 0; i < header.num_channels; i++) {
+    EXPECT_EQ(PixelType(pixel_type), header.pixel_types[i]);
+    header.requested_pixel_types[i] = TINYEXR_PIXELTYPE_FLOAT;
+    channel_indices[header.channels[i].name] = i;
+
+    // OpenEXR requires the channels to be sorted by name.
+    if (i != 0) {
+      EXPECT_LT(std::string(header.channels[i - 1].name),
+                std::string(header.channels[i].name));
+    }
+  }
+
+  EXRImage image;
+  InitEXRImage(&image);
+  int status = LoadEXRImageFromFile(&image, &header, path.c_str(), &error);
+  if (status != TINYEXR_SUCCESS) {
+    ADD_FAILURE() << error;
+    FreeEXRErrorMessage(error);
+    FreeEXRHeader(&header);
+    return;
+  }
+
+  EXPECT_EQ(static_cast<int>(kNumColumns), image.width);
+  EXPECT_EQ(static_cast<int>(kNumRows), image.height);
+  ASSERT_EQ(static_cast<int>(kChannels.size()), image.num_channels);
+
+  for (size_t channel = 0; channel < kChannels.size(); channel++) {
+    auto index = channel_indices.find(kChannels[channel]);
+    ASSERT_NE(channel_indices.end(), index) << kChannels[channel];
+
+    const float* values =
+        reinterpret_cast<const float*>(image.images[index->second]);
+    for (size_t row = 0; row < kNumRows; row++) {
+      for (size_t column = 0; column < kNumColumns; column++) {
+        ASSERT_EQ(Value(channel, column, row),
+                  values[row * kNumColumns + column])
+            << kChannels[channel] << " at " << column << ", " << row;
+      }
+    }
+  }
+
+  FreeEXRImage(&image);
+  FreeEXRHeader(&header);
+}
+
+long FileSize(const std::string& path) {
+  FILE* file = fopen(path.c_str(), "rb");
+  if (!file) {
+    return -1;
+  }
+  fseek(file, 0, SEEK_END);
+  long result = ftell(file);
+  fclose(file);
+  return result;
+}
+
+}  // namespace
+
+TEST(ExrFileTests, RoundTrip) {
+  for (ExrCompression compression : kCompressions) {
+    for (ExrPixelType pixel_type : kPixelTypes) {
+      std::string path = Path(compression, pixel_type);
+      ASSERT_TRUE(WriteExr(path, kNumColumns, kNumRows, kChannels,
+                           pixel_type, compression, kNumThreads, ReadRow));
+      CheckExr(path, compression, pixel_type);
+    }
+  }
+}
+
+TEST(ExrFileTests, LoadEXR) {
+  std::string path = Path(ExrCompression::ZIP, ExrPixelType::HALF);
+  ASSERT_TRUE(WriteExr(path, kNumColumns, kNumRows, kChannels,
+                       ExrPixelType::HALF, ExrCompression::ZIP, kNumThreads,
+                       ReadRow));
+
+  float* rgba = nullptr;
+  int width, height;
+  const char* error = nullptr;
+  ASSERT_EQ(TINYEXR_SUCCESS,
+            LoadEXR(&rgba, &width, &height, path.c_str(), &error))
+      << error;
+  ASSERT_EQ(static_cast<int>(kNumColumns), width);
+  ASSERT_EQ(static_cast<int>(kNumRows), height);
+
+  for (size_t row = 0; row < kNumRows; row++) {
+    for (size_t column = 0; column < kNumColumns; column++) {
+      const float* pixel = rgba + 4 * (row * kNumColumns + column);
+      EXPECT_EQ(Value(0, column, row), pixel[0]);
+      EXPECT_EQ(Value(1, column, row), pixel[1]);
+      EXPECT_EQ(Value(2, column, row), pixel[2]);
+      EXPECT_EQ(1.0f, pixel[3]);
+    }
+  }
+
+  free(rgba);
+}
+
+TEST(ExrFileTests, Compresses) {
+  for (ExrPixelType pixel_type : kPixelTypes) {
+    long uncompressed_size = 0;
+    for (ExrCompression compression : kCompressions) {
+      std::string path = Path(compression, pixel_type);
+      ASSERT_TRUE(WriteExr(path, kNumColumns, kNumRows, kChannels,
+                           pixel_type, compression, kNumThreads, ReadRow));
+      if (compression == ExrCompression::NONE) {
+        uncompressed_size = FileSize(path);
+      } else {
+        EXPECT_LT(FileSize(path), uncompressed_size);
+      }
+    }
+  }
+}
+
+TEST(ExrFileTests, EmptyImage) {
+  std::string path = Path(ExrCompression::ZIP, ExrPixelType::HALF);
+  EXPECT_FALSE(WriteExr(path, 0, kNumRows, kChannels, ExrPixelType::HALF,
+                        ExrCompression::ZIP, kNumThreads, ReadRow));
+  EXPECT_FALSE(WriteExr(path, kNumColumns, 0, kChannels, ExrPixelType::HALF,
+                        ExrCompression::ZIP, kNumThreads, ReadRow));
+  EXPECT_FALSE(WriteExr(path, kNumColumns, kNumRows, {}, ExrPixelType::HALF,
+                        ExrCompression::ZIP, kNumThreads, ReadRow));
+}
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "googletest/include/gtest/gtest.h"
+#include "src/common/live_preview.h"
+
+using iris::LivePreview;
+using iris::PixelBounds;
+
+namespace {
+
+static const size_t kNumColumns = 6;
+static const size_t kNumRows = 4;
+
+// The header described in live_preview.h.
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t complete;
+  uint64_t num_columns;
+  uint64_t num_rows;
+  uint64_t float_offset;
+  uint64_t rgba8_offset;
+  uint64_t sequence;
+};
+
+// A read only mapping of a preview file.
+class Mapping {
+ public:
+  explicit Mapping(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    EXPECT_LE(0, fd);
+
+    struct stat status;
+    EXPECT_EQ(0, fstat(fd, &status));
+    m_size = static_cast<size_t>(status.st_size);
+    m_data = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    EXPECT_NE(MAP_FAILED, m_data);
+    close(fd);
+  }
+
+  ~Mapping() { munmap(m_data, m_size); }
+
+  size_t Size() const { return m_size; }
+
+  const Header& GetHeader() const {
+    return *static_cast<const Header*>(m_data);
+  }
+
+  const float* Float(size_t column, size_t row) const {
+    return reinterpret_cast<const float*>(
+               static_cast<const char*>(m_data) + GetHeader().float_offset) +
+           3 * (row * kNumColumns + column);
+  }
+
+  const uint8_t* Rgba8(size_t column, size_t row) const {
+    return static_cast<const uint8_t*>(m_data) + GetHeader().rgba8_offset +
+           4 * (row * kNumColumns + column);
+  }
+
+ private:
+  void* m_data;
+  size_t m_size;
+};
+
+COLOR3 Color(float r, float g, float b) {
+  COLOR3 result;
+  result.values[0] = r;
+  result.values[1] = g;
+  result.values[2] = b;
+  result.color_space = COLOR_SPACE_LINEAR_SRGB;
+  return result;
+}
+
+// Linear values and their 8 bit sRGB encodings, including values on the
+// linear segment of the curve and values that are clamped.
+COLOR3 FirstColor(size_t column, size_t row) {
+  return Color(0.5f, 0.002f, 1.0f);
+}
+
+COLOR3 SecondColor(size_t column, size_t row) {
+  return Color(0.0f, 2.0f, -1.0f);
+}
+
+void CheckPixel(const Mapping& mapping, size_t column, size_t row,
+                const COLOR3& color, uint8_t r, uint8_t g, uint8_t b,
+                uint8_t a) {
+  const float* values = mapping.Float(column, row);
+  EXPECT_EQ(static_cast<float>(color.values[0]), values[0]);
+  EXPECT_EQ(static_cast<float>(color.values[1]), values[1]);
+  EXPECT_EQ(static_cast<float>(color.values[2]), values[2]);
+
+  const uint8_t* rgba8 = mapping.Rgba8(column, row);
+  EXPECT_EQ(r, rgba8[0]);
+  EXPECT_EQ(g, rgba8[1]);
+  EXPECT_EQ(b, rgba8[2]);
+  EXPECT_EQ(a, rgba8[3]);
+}
+
+}  // namespace
+
+TEST(LivePreviewTests, PublishAndFinish) {
+  std::string path = testing::TempDir() + "live_preview";
+  LivePreview preview(path, kNumColumns, kNumRows, std::chrono::hours(1));
+
+  Mapping mapping(path);
+  const Header& header = mapping.GetHeader();
+  EXPECT_EQ(0, std::memcmp("IRISPRV", header.magic, sizeof(header.magic)));
+  EXPECT_EQ(1u, header.version);
+  EXPECT_EQ(0u, header.complete);
+  EXPECT_EQ(kNumColumns, header.num_columns);
+  EXPECT_EQ(kNumRows, header.num_rows);
+  EXPECT_EQ(header.float_offset + kNumColumns * kNumRows * 3 * sizeof(float),
+            header.rgba8_offset);
+  EXPECT_EQ(header.rgba8_offset + kNumColumns * kNumRows * 4, mapping.Size());
+  EXPECT_EQ(0u, header.sequence);
+
+  PixelBounds first = {0, 3, 0, 2};
+  PixelBounds second = {3, 6, 1, 4};
+  preview.Publish(first, FirstColor, /*force=*/true);
+  EXPECT_EQ(2u, header.sequence);
+
+  // The interval has not elapsed, so only a forced update is made.
+  EXPECT_FALSE(preview.Due());
+  preview.Publish(second, SecondColor);
+  EXPECT_EQ(2u, header.sequence);
+  preview.Publish(second, SecondColor, /*force=*/true);
+  EXPECT_EQ(4u, header.sequence);
+  EXPECT_EQ(0u, header.complete);
+
+  for (size_t row = 0; row < kNumRows; row++) {
+    for (size_t column = 0; column < kNumColumns; column++) {
+      if (column < 3 && row < 2) {
+        CheckPixel(mapping, column, row, FirstColor(column, row), 188, 7,
+                   255, 255);
+      } else if (3 <= column && 1 <= row) {
+        CheckPixel(mapping, column, row, SecondColor(column, row), 0, 255, 0,
+                   255);
+      } else {
+        CheckPixel(mapping, column, row, Color(0.0f, 0.0f, 0.0f), 0, 0, 0,
+                   0);
+      }
+    }
+  }
+
+  preview.Finish();
+  EXPECT_EQ(6u, header.sequence);
+  EXPECT_NE(0u, header.complete);
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#include <array>
+#include <cstdint>
+
+#include "googletest/include/gtest/gtest.h"
+#include "src/randoms/philox.h"
+
+using iris::Philox4x32;
+
+// The Philox4x32-10 known answer tests from kat_vectors in Random123.
+TEST(PhiloxTests, Zeros) {
+  std::array<uint32_t, 4> expected = {0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu,
+                                      0x9b00dbd8u};
+  EXPECT_EQ(expected, Philox4x32({0u, 0u, 0u, 0u}, {0u, 0u}));
+}
+
+TEST(PhiloxTests, Ones) {
+  std::array<uint32_t, 4> expected = {0x408f276du, 0x41c83b0eu, 0xa20bc7c6u,
+                                      0x6d5451fdu};
+  EXPECT_EQ(expected,
+            Philox4x32({0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu},
+                       {0xffffffffu, 0xffffffffu}));
+}
+
+TEST(PhiloxTests, Pi) {
+  std::array<uint32_t, 4> expected = {0xd16cfe09u, 0x94fdccebu, 0x5001e420u,
+                                      0x24126ea1u};
+  EXPECT_EQ(expected,
+            Philox4x32({0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u},
+                       {0xa4093822u, 0x299f31d0u}));
+}
\ No newline at end of file
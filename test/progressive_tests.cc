@@ -0,0 +1,135 @@
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+#include "src/samplers/checkpoint.h"
+#include "src/samplers/progressive.h"
+
+using iris::Checkpoint;
+using iris::PixelStatistics;
+using iris::ProgressiveSampler;
+
+namespace {
+
+static const size_t kNumPasses = 64;
+static const size_t kSamplesPerPass = 16;
+
+double NextUniform(uint64_t* state) {
+  *state = *state * 6364136223846793005u + 1442695040888963407u;
+  return (*state >> 11) * 0x1p-53;
+}
+
+double VanDerCorput(uint32_t index) {
+  double result = 0.0;
+  for (double scale = 0.5; index != 0; index >>= 1, scale *= 0.5) {
+    result += (index & 1) * scale;
+  }
+  return result;
+}
+
+COLOR3 Gray(double luminance) {
+  float_t values[3] = {static_cast<float_t>(luminance),
+                       static_cast<float_t>(luminance),
+                       static_cast<float_t>(luminance)};
+  return ColorCreate(COLOR_SPACE_XYZ, values);
+}
+
+// Estimates the integral of f(x) = x over [0, 1], whose samples have a
+// variance of 1/12, from passes of independent uniform samples.
+PixelStatistics IndependentPasses() {
+  PixelStatistics statistics = {};
+  uint64_t state = 1;
+  for (size_t pass = 0; pass < kNumPasses; pass++) {
+    double sum = 0.0;
+    for (size_t i = 0; i < kSamplesPerPass; i++) {
+      sum += NextUniform(&state);
+    }
+    iris::AddPass(Gray(sum / kSamplesPerPass), kSamplesPerPass, &statistics);
+  }
+  return statistics;
+}
+
+// The same integral estimated from passes that take consecutive ranges of
+// the van der Corput sequence, as the progressive sequences do.
+PixelStatistics CorrelatedPasses() {
+  PixelStatistics statistics = {};
+  for (size_t pass = 0; pass < kNumPasses; pass++) {
+    double sum = 0.0;
+    for (size_t i = 0; i < kSamplesPerPass; i++) {
+      sum += VanDerCorput(pass * kSamplesPerPass + i);
+    }
+    iris::AddPass(Gray(sum / kSamplesPerPass), kSamplesPerPass, &statistics);
+  }
+  return statistics;
+}
+
+}  // namespace
+
+TEST(ProgressiveTests, ConvergedIndependentPasses) {
+  // The relative standard error of the mean of 1024 independent samples is
+  // sqrt(1/12/1024)/0.5, or about 0.018.
+  PixelStatistics statistics = IndependentPasses();
+  EXPECT_TRUE(iris::Converged(statistics, 0.024));
+  EXPECT_FALSE(iris::Converged(statistics, 0.012));
+}
+
+TEST(ProgressiveTests, ConvergedCorrelatedPasses) {
+  // The stratification of each pass hides most of the variance of the
+  // samples, so the estimate is a fraction of the independent one.
+  EXPECT_FALSE(iris::Converged(IndependentPasses(), 0.009));
+  EXPECT_TRUE(iris::Converged(CorrelatedPasses(), 0.009));
+}
+
+TEST(ProgressiveTests, ConvergedFlatPixel) {
+  PixelStatistics statistics = {};
+  iris::AddPass(Gray(0.5), 4, &statistics);
+  EXPECT_FALSE(iris::Converged(statistics, 0.001));
+  iris::AddPass(Gray(0.5), 4, &statistics);
+  EXPECT_TRUE(iris::Converged(statistics, 0.001));
+}
+
+TEST(ProgressiveTests, AdaptiveStopsOnFlatPixels) {
+  // The left pixel is the same in every pass and the right pixel is a new
+  // random value in every pass, however many samples the pass takes.
+  ProgressiveSampler::RenderPass render_pass =
+      [](uint32_t first_sample_index, size_t tile_index,
+         PCIMAGE_SAMPLER image_sampler, PFRAMEBUFFER framebuffer) {
+        uint64_t state = first_sample_index;
+        COLOR3 noise = Gray(NextUniform(&state));
+        EXPECT_EQ(ISTATUS_SUCCESS,
+                  FramebufferSetPixel(framebuffer, 0, 0, Gray(0.5)));
+        EXPECT_EQ(ISTATUS_SUCCESS,
+                  FramebufferSetPixel(framebuffer, 1, 0, noise));
+      };
+
+  std::string path = testing::TempDir() + "adaptive.checkpoint";
+  std::remove(path.c_str());
+
+  ProgressiveSampler::RenderOptions options = {
+      absl::InfiniteDuration(),
+      0,
+      ProgressiveSampler::CheckpointOptions{path, absl::InfiniteDuration(),
+                                            false},
+      nullptr,
+      absl::nullopt,
+      nullptr,
+      nullptr};
+
+  iris::Framebuffer framebuffer;
+  ISTATUS status =
+      FramebufferAllocate(2, 1, framebuffer.release_and_get_address());
+  ASSERT_EQ(ISTATUS_SUCCESS, status);
+
+  ProgressiveSampler sampler(ProgressiveSampler::Sequence::SOBOL, 16,
+                             ProgressiveSampler::AdaptiveOptions{256, 0.01});
+  EXPECT_EQ(256u, sampler.Render(render_pass, options, framebuffer));
+
+  auto checkpoint = iris::ReadCheckpoint(path);
+  ASSERT_TRUE(checkpoint);
+  ASSERT_EQ(2u, checkpoint->statistics.size());
+  EXPECT_EQ(16u, checkpoint->statistics[0].num_samples);
+  EXPECT_EQ(256u, checkpoint->statistics[1].num_samples);
+  EXPECT_EQ(0, checkpoint->active[0]);
+}
\ No newline at end of file
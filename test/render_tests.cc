@@ -2,10 +2,28 @@
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <string>
 
+#include "absl/flags/declare.h"
+#include "absl/flags/flag.h"
+#include "absl/time/time.h"
 #include "googletest/include/gtest/gtest.h"
+#include "src/common/run_statistics.h"
 #include "src/render.h"
+#include "src/samplers/checkpoint.h"
+
+ABSL_DECLARE_FLAG(bool, denoise);
+ABSL_DECLARE_FLAG(uint32_t, num_workers);
+ABSL_DECLARE_FLAG(bool, parallel_includes);
+ABSL_DECLARE_FLAG(std::string, pixel_bounds);
+ABSL_DECLARE_FLAG(absl::Duration, time_limit);
+ABSL_DECLARE_FLAG(std::string, checkpoint_file);
+ABSL_DECLARE_FLAG(bool, resume);
+ABSL_DECLARE_FLAG(uint32_t, tile_size);
+ABSL_DECLARE_FLAG(std::string, tile_order);
 
 using iris::Parser;
 
@@ -97,6 +115,168 @@ void CheckEquals(const char* expected, const iris::Framebuffer& actual,
   fclose(left);
 }
 
+void CheckIdentical(const iris::Framebuffer& expected,
+                    const iris::Framebuffer& actual) {
+  size_t expected_xres, expected_yres;
+  FramebufferGetSize(expected.get(), &expected_xres, &expected_yres);
+
+  size_t actual_xres, actual_yres;
+  FramebufferGetSize(actual.get(), &actual_xres, &actual_yres);
+  ASSERT_EQ(expected_xres, actual_xres);
+  ASSERT_EQ(expected_yres, actual_yres);
+
+  for (size_t y = 0; y < actual_yres; y++) {
+    for (size_t x = 0; x < actual_xres; x++) {
+      COLOR3 expected_color;
+      FramebufferGetPixel(expected.get(), x, y, &expected_color);
+
+      COLOR3 actual_color;
+      FramebufferGetPixel(actual.get(), x, y, &actual_color);
+
+      ASSERT_EQ(expected_color.color_space, actual_color.color_space);
+      ASSERT_EQ(expected_color.values[0], actual_color.values[0]);
+      ASSERT_EQ(expected_color.values[1], actual_color.values[1]);
+      ASSERT_EQ(expected_color.values[2], actual_color.values[2]);
+    }
+  }
+}
+
+void CheckNear(const iris::Framebuffer& expected,
+               const iris::Framebuffer& actual, float_t epsilon) {
+  size_t expected_xres, expected_yres;
+  FramebufferGetSize(expected.get(), &expected_xres, &expected_yres);
+
+  size_t actual_xres, actual_yres;
+  FramebufferGetSize(actual.get(), &actual_xres, &actual_yres);
+  ASSERT_EQ(expected_xres, actual_xres);
+  ASSERT_EQ(expected_yres, actual_yres);
+
+  for (size_t y = 0; y < actual_yres; y++) {
+    for (size_t x = 0; x < actual_xres; x++) {
+      COLOR3 expected_color;
+      FramebufferGetPixel(expected.get(), x, y, &expected_color);
+
+      COLOR3 actual_color;
+      FramebufferGetPixel(actual.get(), x, y, &actual_color);
+      actual_color = ColorConvert(actual_color, expected_color.color_space);
+
+      EXPECT_NEAR(expected_color.values[0], actual_color.values[0], epsilon);
+      EXPECT_NEAR(expected_color.values[1], actual_color.values[1], epsilon);
+      EXPECT_NEAR(expected_color.values[2], actual_color.values[2], epsilon);
+    }
+  }
+}
+
+// The Cornell box at a lower resolution with a sampler that renders in
+// progressive passes.
+std::string ProgressiveCornellBox() {
+  std::ifstream file("test/cornell_box/cornell_box.pbrt");
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  std::string scene = buffer.str();
+
+  const std::string kSampler =
+      "Sampler \"stratified\" \"integer xsamples\" [2] "
+      "\"integer ysamples\" [2] \"bool jitter\" \"false\"";
+  size_t sampler = scene.find(kSampler);
+  EXPECT_NE(std::string::npos, sampler);
+  scene.replace(sampler, kSampler.size(),
+                "Sampler \"halton\" \"integer pixelsamples\" [16]");
+
+  for (size_t resolution = scene.find("[250]"); resolution != std::string::npos;
+       resolution = scene.find("[250]")) {
+    scene.replace(resolution, 5, "[32]");
+  }
+
+  return scene;
+}
+
+// Compares the mean color of a render cropped to columns
+// [min_column, max_column) and rows [min_row, max_row) to the mean of the same
+// pixels of expected.
+void CheckRegionEquals(const char* expected, const iris::Framebuffer& actual,
+                       float epsilon, size_t min_column, size_t max_column,
+                       size_t min_row, size_t max_row) {
+  FILE* left = fopen(expected, "rb");
+  ASSERT_NE(left, nullptr);
+  ValidateMagicNumber(left);
+
+  size_t expected_xres, expected_yres;
+  GetSize(left, &expected_xres, &expected_yres);
+  ASSERT_LE(max_column, expected_xres);
+  ASSERT_LE(max_row, expected_yres);
+
+  size_t actual_xres, actual_yres;
+  FramebufferGetSize(actual.get(), &actual_xres, &actual_yres);
+  ASSERT_EQ(max_column - min_column, actual_xres);
+  ASSERT_EQ(max_row - min_row, actual_yres);
+
+  bool swap_needed = false;
+  ByteSwapNeeded(left, &swap_needed);
+
+  ASSERT_EQ('\n', fgetc(left));
+
+  double expected_sum[3] = {0.0, 0.0, 0.0};
+  double actual_sum[3] = {0.0, 0.0, 0.0};
+  for (size_t y = 0; y < expected_yres; y++) {
+    for (size_t x = 0; x < expected_xres; x++) {
+      float subpixels[3];
+      ASSERT_EQ(3u, fread(subpixels, sizeof(float), 3, left));
+
+      if (swap_needed) {
+        SwapBytes(&subpixels[0], sizeof(float));
+        SwapBytes(&subpixels[1], sizeof(float));
+        SwapBytes(&subpixels[2], sizeof(float));
+      }
+
+      size_t row = expected_yres - 1 - y;
+      if (x < min_column || max_column <= x || row < min_row ||
+          max_row <= row) {
+        continue;
+      }
+
+      COLOR3 actual_color;
+      FramebufferGetPixel(actual.get(), x - min_column, row - min_row,
+                          &actual_color);
+      actual_color = ColorConvert(actual_color, COLOR_SPACE_LINEAR_SRGB);
+
+      for (size_t i = 0; i < 3; i++) {
+        expected_sum[i] += subpixels[i];
+        actual_sum[i] += actual_color.values[i];
+      }
+    }
+  }
+
+  fclose(left);
+
+  double num_pixels = actual_xres * actual_yres;
+  for (size_t i = 0; i < 3; i++) {
+    EXPECT_NEAR(expected_sum[i] / num_pixels, actual_sum[i] / num_pixels,
+                epsilon);
+  }
+}
+
+// Copies the square of pixels of size by size whose top left corner is at
+// (min_column, min_row).
+iris::Framebuffer Crop(const iris::Framebuffer& framebuffer, size_t min_column,
+                       size_t min_row, size_t size) {
+  iris::Framebuffer result;
+  ISTATUS status =
+      FramebufferAllocate(size, size, result.release_and_get_address());
+  EXPECT_EQ(ISTATUS_SUCCESS, status);
+
+  for (size_t y = 0; y < size; y++) {
+    for (size_t x = 0; x < size; x++) {
+      COLOR3 color;
+      FramebufferGetPixel(framebuffer.get(), min_column + x, min_row + y,
+                          &color);
+      FramebufferSetPixel(result.get(), x, y, color);
+    }
+  }
+
+  return result;
+}
+
 std::pair<Parser, std::unique_ptr<std::stringstream>> CreateParserFromString(
     const std::string& string_to_parse) {
   auto buffer = absl::make_unique<std::stringstream>(string_to_parse);
@@ -121,7 +301,7 @@ TEST(RenderTests, CornellBox) {
       RenderToFramebuffer(parser, kRenderIndex, kEpsilon, kNumThreads,
                           kReportProgress, kOverrideSpectralRepresentation,
                           kRgbColorSpace, kSpectrumColorWorkaround);
-  CheckEquals("test/cornell_box/cornell_box.pfm", render_result.first,
+  CheckEquals("test/cornell_box/cornell_box.pfm", std::get<0>(render_result),
               (float_t)0.1);
 }
 
@@ -132,16 +312,315 @@ TEST(RenderTests, IncludeCornellBox) {
       RenderToFramebuffer(parser.first, kRenderIndex, kEpsilon, kNumThreads,
                           kReportProgress, kOverrideSpectralRepresentation,
                           kRgbColorSpace, kSpectrumColorWorkaround);
-  CheckEquals("test/cornell_box/cornell_box.pfm", render_result.first,
+  CheckEquals("test/cornell_box/cornell_box.pfm", std::get<0>(render_result),
               (float_t)0.1);
 }
 
 TEST(RenderTests, PbrtBook) {
+  uint64_t ply_bytes_read = iris::GetCounter(iris::Counter::PLY_BYTES_READ);
   auto parser = Parser::Create("test/pbrt_book/pbrt_book.pbrt");
   auto render_result =
       RenderToFramebuffer(parser, kRenderIndex, kEpsilon, kNumThreads,
                           kReportProgress, kOverrideSpectralRepresentation,
                           kRgbColorSpace, kSpectrumColorWorkaround);
-  CheckEquals("test/pbrt_book/pbrt_book.pfm", render_result.first,
+  CheckEquals("test/pbrt_book/pbrt_book.pfm", std::get<0>(render_result),
               (float_t)0.1);
+  EXPECT_LT(ply_bytes_read, iris::GetCounter(iris::Counter::PLY_BYTES_READ));
+}
+
+TEST(RenderTests, ParallelIncludePbrtBook) {
+  absl::SetFlag(&FLAGS_parallel_includes, true);
+  auto parser = Parser::Create("test/pbrt_book/pbrt_book_includes.pbrt");
+  auto render_result =
+      RenderToFramebuffer(parser, kRenderIndex, kEpsilon, kNumThreads,
+                          kReportProgress, kOverrideSpectralRepresentation,
+                          kRgbColorSpace, kSpectrumColorWorkaround);
+  absl::SetFlag(&FLAGS_parallel_includes, false);
+  CheckEquals("test/pbrt_book/pbrt_book.pfm", std::get<0>(render_result),
+              (float_t)0.1);
+}
+
+// Tiles are laid out over the whole image and those that cross the bounds are
+// still rendered whole, so with a generator keyed on the sample each pixel of
+// a cropped render is the same as in a render of the whole image.
+TEST(RenderTests, PixelBoundsCornellBox) {
+  std::string scene = ProgressiveCornellBox();
+  scene.insert(scene.find("WorldBegin"), "Random \"philox\"\n");
+  absl::SetFlag(&FLAGS_tile_size, 8);
+
+  auto full_parser = CreateParserFromString(scene);
+  auto full = RenderToFramebuffer(
+      full_parser.first, kRenderIndex, kEpsilon, kNumThreads, kReportProgress,
+      kOverrideSpectralRepresentation, kRgbColorSpace,
+      kSpectrumColorWorkaround);
+
+  absl::SetFlag(&FLAGS_pixel_bounds, "5,27,3,30");
+  auto cropped_parser = CreateParserFromString(scene);
+  auto cropped = RenderToFramebuffer(
+      cropped_parser.first, kRenderIndex, kEpsilon, kNumThreads,
+      kReportProgress, kOverrideSpectralRepresentation, kRgbColorSpace,
+      kSpectrumColorWorkaround);
+  absl::SetFlag(&FLAGS_pixel_bounds, "");
+  absl::SetFlag(&FLAGS_tile_size, 0);
+
+  size_t xres, yres;
+  FramebufferGetSize(std::get<0>(cropped).get(), &xres, &yres);
+  ASSERT_EQ(22u, xres);
+  ASSERT_EQ(27u, yres);
+
+  for (size_t y = 0; y < yres; y++) {
+    for (size_t x = 0; x < xres; x++) {
+      COLOR3 expected;
+      FramebufferGetPixel(std::get<0>(full).get(), x + 5, y + 3, &expected);
+
+      COLOR3 actual;
+      FramebufferGetPixel(std::get<0>(cropped).get(), x, y, &actual);
+
+      EXPECT_EQ(expected.color_space, actual.color_space);
+      EXPECT_EQ(expected.values[0], actual.values[0]);
+      EXPECT_EQ(expected.values[1], actual.values[1]);
+      EXPECT_EQ(expected.values[2], actual.values[2]);
+    }
+  }
+}
+
+// Denoising moves light between neighboring pixels of the same surface but
+// should not change the brightness of any part of the image.
+TEST(RenderTests, DenoiseCornellBox) {
+  absl::SetFlag(&FLAGS_denoise, true);
+  auto parser = Parser::Create("test/cornell_box/cornell_box.pbrt");
+  auto render_result =
+      RenderToFramebuffer(parser, kRenderIndex, kEpsilon, kNumThreads,
+                          kReportProgress, kOverrideSpectralRepresentation,
+                          kRgbColorSpace, kSpectrumColorWorkaround);
+  absl::SetFlag(&FLAGS_denoise, false);
+
+  // The AOVs rendered for the filter are not written unless the film
+  // requests them.
+  EXPECT_TRUE(std::get<2>(render_result).empty());
+
+  const auto& framebuffer = std::get<0>(render_result);
+  for (size_t y = 0; y < 250; y++) {
+    for (size_t x = 0; x < 250; x++) {
+      COLOR3 color;
+      FramebufferGetPixel(framebuffer.get(), x, y, &color);
+      ASSERT_TRUE(std::isfinite(color.values[0]));
+      ASSERT_TRUE(std::isfinite(color.values[1]));
+      ASSERT_TRUE(std::isfinite(color.values[2]));
+    }
+  }
+
+  for (size_t min_row : {0u, 125u}) {
+    for (size_t min_column : {0u, 125u}) {
+      CheckRegionEquals("test/cornell_box/cornell_box.pfm",
+                        Crop(framebuffer, min_column, min_row, 125),
+                        (float_t)0.02, min_column, min_column + 125, min_row,
+                        min_row + 125);
+    }
+  }
+}
+
+// block_2_textures.pbrt starts with a self-contained block but goes on to
+// define textures used by later includes, so it must be rolled back and
+// parsed serially.
+TEST(RenderTests, ParallelIncludeFallbackPbrtBook) {
+  absl::SetFlag(&FLAGS_parallel_includes, true);
+  auto parser = Parser::Create("test/pbrt_book/pbrt_book_fallback.pbrt");
+  auto render_result =
+      RenderToFramebuffer(parser, kRenderIndex, kEpsilon, kNumThreads,
+                          kReportProgress, kOverrideSpectralRepresentation,
+                          kRgbColorSpace, kSpectrumColorWorkaround);
+  absl::SetFlag(&FLAGS_parallel_includes, false);
+  CheckEquals("test/pbrt_book/pbrt_book.pfm", std::get<0>(render_result),
+              (float_t)0.1);
+}
+
+TEST(RenderTests, ResumeCornellBox) {
+  std::string scene = ProgressiveCornellBox();
+  std::string resumed_path = testing::TempDir() + "resumed.checkpoint";
+  std::string uninterrupted_path =
+      testing::TempDir() + "uninterrupted.checkpoint";
+  std::remove(resumed_path.c_str());
+  std::remove(uninterrupted_path.c_str());
+
+  // A time limit that has expired by the end of the first pass stops each of
+  // these renders after exactly one pass, which takes a single sample the
+  // first two times.
+  absl::SetFlag(&FLAGS_checkpoint_file, resumed_path);
+  absl::SetFlag(&FLAGS_resume, true);
+  absl::SetFlag(&FLAGS_time_limit, absl::Nanoseconds(1));
+  for (uint32_t samples = 1; samples <= 2; samples++) {
+    auto parser = CreateParserFromString(scene);
+    RenderToFramebuffer(parser.first, kRenderIndex, kEpsilon, kNumThreads,
+                        kReportProgress, kOverrideSpectralRepresentation,
+                        kRgbColorSpace, kSpectrumColorWorkaround);
+
+    auto checkpoint = iris::ReadCheckpoint(resumed_path);
+    ASSERT_TRUE(checkpoint);
+    ASSERT_EQ(samples, checkpoint->first_sample_index);
+  }
+
+  absl::SetFlag(&FLAGS_time_limit, absl::InfiniteDuration());
+  auto resumed_parser = CreateParserFromString(scene);
+  auto resumed =
+      RenderToFramebuffer(resumed_parser.first, kRenderIndex, kEpsilon,
+                          kNumThreads, kReportProgress,
+                          kOverrideSpectralRepresentation, kRgbColorSpace,
+                          kSpectrumColorWorkaround);
+
+  auto checkpoint = iris::ReadCheckpoint(resumed_path);
+  ASSERT_TRUE(checkpoint);
+  ASSERT_EQ(16u, checkpoint->first_sample_index);
+
+  absl::SetFlag(&FLAGS_checkpoint_file, uninterrupted_path);
+  absl::SetFlag(&FLAGS_resume, false);
+  auto uninterrupted_parser = CreateParserFromString(scene);
+  auto uninterrupted =
+      RenderToFramebuffer(uninterrupted_parser.first, kRenderIndex, kEpsilon,
+                          kNumThreads, kReportProgress,
+                          kOverrideSpectralRepresentation, kRgbColorSpace,
+                          kSpectrumColorWorkaround);
+  absl::SetFlag(&FLAGS_checkpoint_file, "");
+
+  CheckIdentical(std::get<0>(uninterrupted), std::get<0>(resumed));
+}
+
+// Philox draws the values of each sample from a counter formed from the pixel
+// and sample index, so the image must not depend on how the samples are
+// divided between threads, whether or not the image is split into tiles.
+TEST(RenderTests, PhiloxIndependentOfThreads) {
+  std::string scene = ProgressiveCornellBox();
+  scene.insert(scene.find("WorldBegin"), "Random \"philox\"\n");
+
+  for (uint32_t tile_size : {0u, 8u}) {
+    absl::SetFlag(&FLAGS_tile_size, tile_size);
+
+    auto single_parser = CreateParserFromString(scene);
+    auto single = RenderToFramebuffer(
+        single_parser.first, kRenderIndex, kEpsilon, 1, kReportProgress,
+        kOverrideSpectralRepresentation, kRgbColorSpace,
+        kSpectrumColorWorkaround);
+
+    auto threaded_parser = CreateParserFromString(scene);
+    auto threaded = RenderToFramebuffer(
+        threaded_parser.first, kRenderIndex, kEpsilon, 4, kReportProgress,
+        kOverrideSpectralRepresentation, kRgbColorSpace,
+        kSpectrumColorWorkaround);
+
+    CheckIdentical(std::get<0>(single), std::get<0>(threaded));
+  }
+
+  absl::SetFlag(&FLAGS_tile_size, 0);
+}
+
+// Tiles take the same samples of each pixel as an untiled render, with the
+// bounds of their pixels rescaled to the image, so with a generator keyed on
+// the sample the images only differ by the rounding of those bounds.
+TEST(RenderTests, TiledMatchesUntiled) {
+  std::string scene = ProgressiveCornellBox();
+  scene.insert(scene.find("WorldBegin"), "Random \"philox\"\n");
+
+  auto untiled_parser = CreateParserFromString(scene);
+  auto untiled = RenderToFramebuffer(
+      untiled_parser.first, kRenderIndex, kEpsilon, kNumThreads,
+      kReportProgress, kOverrideSpectralRepresentation, kRgbColorSpace,
+      kSpectrumColorWorkaround);
+
+  for (const char* tile_order : {"scanline", "morton", "hilbert"}) {
+    for (uint32_t tile_size : {8u, 12u}) {
+      absl::SetFlag(&FLAGS_tile_order, tile_order);
+      absl::SetFlag(&FLAGS_tile_size, tile_size);
+
+      auto tiled_parser = CreateParserFromString(scene);
+      auto tiled = RenderToFramebuffer(
+          tiled_parser.first, kRenderIndex, kEpsilon, 2, kReportProgress,
+          kOverrideSpectralRepresentation, kRgbColorSpace,
+          kSpectrumColorWorkaround);
+
+      CheckNear(std::get<0>(untiled), std::get<0>(tiled), (float_t)0.01);
+    }
+  }
+
+  absl::SetFlag(&FLAGS_tile_order, "hilbert");
+  absl::SetFlag(&FLAGS_tile_size, 0);
+}
+
+// The back wall of the Cornell box lies in the plane z = 559.2, facing the
+// camera at (278, 273, -800) which has a field of view of 37.5 degrees. The
+// pixels checked see the wall above the tall block and below the ceiling.
+TEST(RenderTests, AovsCornellBox) {
+  std::string scene = ProgressiveCornellBox();
+  scene.replace(scene.find("Film \"image\""), 12,
+                "Film \"image\" \"string aovs\" "
+                "[ \"albedo\" \"normal\" \"depth\" ]");
+  const std::string kBackWall = "# Back wall\n#\n\nAttributeBegin\n";
+  size_t back_wall = scene.find(kBackWall);
+  ASSERT_NE(std::string::npos, back_wall);
+  scene.insert(back_wall + kBackWall.size(),
+               "Material \"matte\" \"rgb Kd\" [0.25 0.5 0.75]\n");
+
+  auto parser = CreateParserFromString(scene);
+  auto render_result =
+      RenderToFramebuffer(parser.first, kRenderIndex, kEpsilon, kNumThreads,
+                          kReportProgress, kOverrideSpectralRepresentation,
+                          kRgbColorSpace, kSpectrumColorWorkaround);
+
+  const auto& aovs = std::get<2>(render_result);
+  ASSERT_EQ(3u, aovs.size());
+  EXPECT_EQ(iris::Aov::ALBEDO, aovs[0].aov);
+  EXPECT_EQ(iris::Aov::NORMAL, aovs[1].aov);
+  EXPECT_EQ(iris::Aov::DEPTH, aovs[2].aov);
+  for (const auto& aov : aovs) {
+    ASSERT_EQ(32u, aov.num_columns);
+    ASSERT_EQ(32u, aov.num_rows);
+    ASSERT_EQ(32u * 32u * aov.channels.size(), aov.values.size());
+  }
+
+  const double kPi = 3.1415926535897932384626433832;
+  const double kWallDistance = 559.2 + 800.0;
+  const double kHalfWidth = kWallDistance * std::tan(37.5 / 2.0 * kPi / 180.0);
+  for (size_t row = 8; row <= 10; row++) {
+    for (size_t column = 14; column <= 17; column++) {
+      size_t pixel = row * 32 + column;
+
+      EXPECT_NEAR(0.25, aovs[0].values[3 * pixel + 0], 0.01);
+      EXPECT_NEAR(0.5, aovs[0].values[3 * pixel + 1], 0.01);
+      EXPECT_NEAR(0.75, aovs[0].values[3 * pixel + 2], 0.01);
+
+      EXPECT_NEAR(0.0, aovs[1].values[3 * pixel + 0], 0.01);
+      EXPECT_NEAR(0.0, aovs[1].values[3 * pixel + 1], 0.01);
+      EXPECT_NEAR(1.0, std::abs(aovs[1].values[3 * pixel + 2]), 0.01);
+
+      // The depth at the center of the pixel, which varies by less than a
+      // percent over the pixel.
+      double x = ((column + 0.5) / 16.0 - 1.0) * kHalfWidth;
+      double y = (1.0 - (row + 0.5) / 16.0) * kHalfWidth;
+      double depth = std::sqrt(kWallDistance * kWallDistance + x * x + y * y);
+      EXPECT_NEAR(depth, aovs[2].values[pixel], 0.01 * depth);
+    }
+  }
+}
+
+// The regions rendered by the workers are aligned to their tiles, so each
+// tile is rendered with the same random number stream as in a single process.
+TEST(RenderTests, WorkersMatchSingleProcess) {
+  std::string scene = ProgressiveCornellBox();
+  absl::SetFlag(&FLAGS_tile_size, 4);
+
+  auto single_parser = CreateParserFromString(scene);
+  auto single = RenderToFramebuffer(
+      single_parser.first, kRenderIndex, kEpsilon, kNumThreads,
+      kReportProgress, kOverrideSpectralRepresentation, kRgbColorSpace,
+      kSpectrumColorWorkaround);
+
+  absl::SetFlag(&FLAGS_num_workers, 2);
+  auto workers_parser = CreateParserFromString(scene);
+  auto workers = RenderToFramebuffer(
+      workers_parser.first, kRenderIndex, kEpsilon, kNumThreads,
+      kReportProgress, kOverrideSpectralRepresentation, kRgbColorSpace,
+      kSpectrumColorWorkaround);
+  absl::SetFlag(&FLAGS_num_workers, 0);
+  absl::SetFlag(&FLAGS_tile_size, 0);
+
+  CheckIdentical(std::get<0>(single), std::get<0>(workers));
 }
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+#include "src/common/tile_scheduler.h"
+
+using iris::TileScheduler;
+
+namespace {
+
+static const TileScheduler::Order kOrders[] = {
+    TileScheduler::Order::SCANLINE, TileScheduler::Order::MORTON,
+    TileScheduler::Order::HILBERT};
+
+// Checks that the tiles cover each pixel of the image exactly once and that
+// their indices are their positions in row major order.
+void CheckCoverage(size_t tile_size, TileScheduler::Order order,
+                   size_t num_columns, size_t num_rows) {
+  TileScheduler scheduler(1, tile_size, order, false);
+  std::vector<TileScheduler::Tile> tiles =
+      scheduler.Tiles(num_columns, num_rows);
+
+  size_t tile_columns = (num_columns + tile_size - 1) / tile_size;
+  size_t tile_rows = (num_rows + tile_size - 1) / tile_size;
+  ASSERT_EQ(tile_columns * tile_rows, tiles.size());
+
+  std::vector<size_t> coverage(num_columns * num_rows, 0);
+  std::set<size_t> indices;
+  for (const auto& tile : tiles) {
+    ASSERT_NE(0u, tile.num_columns);
+    ASSERT_NE(0u, tile.num_rows);
+    ASSERT_LE(tile.num_columns, tile_size);
+    ASSERT_LE(tile.num_rows, tile_size);
+    ASSERT_LE(tile.column + tile.num_columns, num_columns);
+    ASSERT_LE(tile.row + tile.num_rows, num_rows);
+    EXPECT_EQ((tile.row / tile_size) * tile_columns + tile.column / tile_size,
+              tile.index);
+    EXPECT_TRUE(indices.insert(tile.index).second);
+
+    for (size_t row = tile.row; row < tile.row + tile.num_rows; row++) {
+      for (size_t column = tile.column;
+           column < tile.column + tile.num_columns; column++) {
+        coverage[row * num_columns + column] += 1;
+      }
+    }
+  }
+
+  for (size_t count : coverage) {
+    EXPECT_EQ(1u, count);
+  }
+}
+
+// Runs the scheduler over the tiles of an image and returns how many times
+// each tile was rendered, indexed by tile index.
+std::vector<size_t> CountRenders(
+    TileScheduler& scheduler, const std::vector<TileScheduler::Tile>& tiles,
+    const std::function<void(const TileScheduler::Tile&)>& render_tile) {
+  std::mutex mutex;
+  std::vector<size_t> renders(tiles.size(), 0);
+  scheduler.Run(tiles, [&](const TileScheduler::Tile& tile) {
+    render_tile(tile);
+    std::lock_guard<std::mutex> lock(mutex);
+    renders.at(tile.index) += 1;
+  });
+  return renders;
+}
+
+}  // namespace
+
+TEST(TileSchedulerTests, TilesCoverImage) {
+  for (TileScheduler::Order order : kOrders) {
+    CheckCoverage(8, order, 64, 64);
+    CheckCoverage(8, order, 250, 250);
+    CheckCoverage(8, order, 100, 37);
+    CheckCoverage(16, order, 37, 100);
+    CheckCoverage(7, order, 3, 50);
+    CheckCoverage(32, order, 1, 1);
+  }
+}
+
+TEST(TileSchedulerTests, ScanlineOrder) {
+  TileScheduler scheduler(1, 8, TileScheduler::Order::SCANLINE, false);
+  std::vector<TileScheduler::Tile> tiles = scheduler.Tiles(100, 37);
+  for (size_t i = 0; i < tiles.size(); i++) {
+    EXPECT_EQ(i, tiles[i].index);
+  }
+}
+
+TEST(TileSchedulerTests, MoreThreadsThanTiles) {
+  TileScheduler scheduler(8, 16, TileScheduler::Order::HILBERT, false);
+  std::vector<TileScheduler::Tile> tiles = scheduler.Tiles(40, 20);
+  ASSERT_EQ(6u, tiles.size());
+
+  std::vector<size_t> renders =
+      CountRenders(scheduler, tiles, [](const TileScheduler::Tile& tile) {});
+  for (size_t count : renders) {
+    EXPECT_EQ(1u, count);
+  }
+
+  std::stringstream statistics;
+  scheduler.WriteStatistics(statistics);
+  EXPECT_NE(std::string::npos, statistics.str().find("Thread 7: "));
+}
+
+// The first thread is held up on its first tile until every other tile has
+// been rendered, so the rest of its run must be stolen.
+TEST(TileSchedulerTests, StealsFromBlockedThread) {
+  TileScheduler scheduler(4, 8, TileScheduler::Order::MORTON, false);
+  std::vector<TileScheduler::Tile> tiles = scheduler.Tiles(100, 37);
+  size_t blocked_index = tiles.front().index;
+
+  std::atomic<size_t> rendered(0);
+  std::vector<size_t> renders = CountRenders(
+      scheduler, tiles, [&](const TileScheduler::Tile& tile) {
+        if (tile.index == blocked_index) {
+          while (rendered.load() + 1 != tiles.size()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          }
+        }
+        rendered += 1;
+      });
+
+  for (size_t count : renders) {
+    EXPECT_EQ(1u, count);
+  }
+
+  std::stringstream statistics;
+  scheduler.WriteStatistics(statistics);
+  size_t threads_without_steals = 0;
+  for (std::string line; std::getline(statistics, line);) {
+    threads_without_steals += line.find(", 0 stolen") != std::string::npos;
+  }
+  EXPECT_GT(4u, threads_without_steals);
+}
+
+TEST(TileSchedulerTests, RunsRepeatedly) {
+  TileScheduler scheduler(3, 8, TileScheduler::Order::SCANLINE, false);
+  std::vector<TileScheduler::Tile> tiles = scheduler.Tiles(50, 50);
+  for (size_t pass = 0; pass < 3; pass++) {
+    std::vector<size_t> renders = CountRenders(
+        scheduler, tiles, [](const TileScheduler::Tile& tile) {});
+    for (size_t count : renders) {
+      EXPECT_EQ(1u, count);
+    }
+  }
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+#include "src/common/tokenizer.h"
+#include "zlib.h"
+#include "zstd.h"
+
+using iris::Tokenizer;
+
+namespace {
+
+// Enough tokens to decompress to several slots of the ring buffer that the
+// background reader fills, drawn from 64 characters so that the data does not
+// compress well and zstd emits blocks larger than a single read.
+static const size_t kNumTokens = 400000;
+static const size_t kTokenLength = 15;
+static const char kAlphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+-";
+
+std::vector<std::string> MakeTokens() {
+  std::vector<std::string> result;
+  uint64_t state = 1;
+  for (size_t i = 0; i < kNumTokens; i++) {
+    std::string token;
+    for (size_t j = 0; j < kTokenLength; j++) {
+      state = state * 6364136223846793005u + 1442695040888963407u;
+      token += kAlphabet[state >> 58];
+    }
+    result.push_back(std::move(token));
+  }
+  return result;
+}
+
+std::string JoinTokens(const std::vector<std::string>& tokens) {
+  std::string result;
+  for (const auto& token : tokens) {
+    result += token;
+    result += '\n';
+  }
+  return result;
+}
+
+std::string Gzip(const std::string& data) {
+  z_stream stream = {};
+  EXPECT_EQ(Z_OK, deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                               15 + 16, 8, Z_DEFAULT_STRATEGY));
+
+  std::string result(deflateBound(&stream, data.size()), '\0');
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in = data.size();
+  stream.next_out = reinterpret_cast<Bytef*>(&result[0]);
+  stream.avail_out = result.size();
+  EXPECT_EQ(Z_STREAM_END, deflate(&stream, Z_FINISH));
+  result.resize(stream.total_out);
+  deflateEnd(&stream);
+
+  return result;
+}
+
+std::string Zstd(const std::string& data) {
+  std::string result(ZSTD_compressBound(data.size()), '\0');
+  size_t size =
+      ZSTD_compress(&result[0], result.size(), data.data(), data.size(), 3);
+  EXPECT_FALSE(ZSTD_isError(size));
+  result.resize(size);
+  return result;
+}
+
+std::string WriteFile(const std::string& name, const std::string& contents) {
+  std::string path = testing::TempDir() + name;
+  std::ofstream output(path, std::ios::binary);
+  output.write(contents.data(), contents.size());
+  return path;
+}
+
+void ExpectTokens(const std::string& path,
+                  const std::vector<std::string>& expected) {
+  auto tokenizer = Tokenizer::CreateFromFile(path);
+  for (const auto& token : expected) {
+    auto next = tokenizer.Next();
+    ASSERT_TRUE(next);
+    ASSERT_EQ(token, *next);
+  }
+  EXPECT_FALSE(tokenizer.Next());
+}
+
+}  // namespace
+
+TEST(TokenizerTests, Uncompressed) {
+  auto tokens = MakeTokens();
+  ExpectTokens(WriteFile("tokens.pbrt", JoinTokens(tokens)), tokens);
+}
+
+TEST(TokenizerTests, Gzip) {
+  auto tokens = MakeTokens();
+  ExpectTokens(WriteFile("tokens.pbrt.gz", Gzip(JoinTokens(tokens))), tokens);
+}
+
+TEST(TokenizerTests, Zstd) {
+  auto tokens = MakeTokens();
+  ExpectTokens(WriteFile("tokens.pbrt.zst", Zstd(JoinTokens(tokens))),
+               tokens);
+}
\ No newline at end of file
@@ -0,0 +1,318 @@
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+#include "src/common/trace.h"
+
+using iris::TraceScope;
+
+namespace {
+
+static const size_t kNumRounds = 3;
+static const size_t kNumThreads = 4;
+static const char kDetail[] = "file \"name\"\\with\ttab";
+
+// The subset of JSON used by the trace, parsed strictly enough to reject
+// anything that is not valid JSON.
+struct Json {
+  enum Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+  Type type = NUL;
+  bool boolean = false;
+  double number = 0.0;
+  std::string string;
+  std::vector<Json> array;
+  std::map<std::string, Json> object;
+
+  const Json& operator[](const std::string& key) const {
+    static const Json missing;
+    auto iter = object.find(key);
+    return (iter != object.end()) ? iter->second : missing;
+  }
+};
+
+class JsonParser {
+ public:
+  explicit JsonParser(const std::string& text) : m_text(text), m_next(0) {}
+
+  bool Parse(Json* value) {
+    if (!ParseValue(value)) {
+      return false;
+    }
+    SkipWhitespace();
+    return m_next == m_text.size();
+  }
+
+ private:
+  void SkipWhitespace() {
+    while (m_next < m_text.size() &&
+           (m_text[m_next] == ' ' || m_text[m_next] == '\n' ||
+            m_text[m_next] == '\r' || m_text[m_next] == '\t')) {
+      m_next++;
+    }
+  }
+
+  bool Consume(char c) {
+    SkipWhitespace();
+    if (m_next < m_text.size() && m_text[m_next] == c) {
+      m_next++;
+      return true;
+    }
+    return false;
+  }
+
+  bool ConsumeLiteral(const std::string& literal) {
+    if (m_text.compare(m_next, literal.size(), literal) != 0) {
+      return false;
+    }
+    m_next += literal.size();
+    return true;
+  }
+
+  bool ParseString(std::string* value) {
+    if (!Consume('"')) {
+      return false;
+    }
+
+    while (m_next < m_text.size() && m_text[m_next] != '"') {
+      char c = m_text[m_next++];
+      if (static_cast<unsigned char>(c) < 0x20) {
+        return false;
+      }
+
+      if (c != '\\') {
+        value->push_back(c);
+        continue;
+      }
+
+      if (m_next == m_text.size()) {
+        return false;
+      }
+
+      static const std::string kEscapes = "\"\\/bfnrt";
+      static const std::string kEscaped = "\"\\/\b\f\n\r\t";
+      c = m_text[m_next++];
+      if (c == 'u') {
+        if (m_text.size() < m_next + 4) {
+          return false;
+        }
+        std::string hex = m_text.substr(m_next, 4);
+        if (hex.find_first_not_of("0123456789abcdefABCDEF") !=
+            std::string::npos) {
+          return false;
+        }
+        unsigned long code = std::strtoul(hex.c_str(), nullptr, 16);
+        if (0x80 <= code) {
+          return false;
+        }
+        value->push_back(static_cast<char>(code));
+        m_next += 4;
+      } else if (kEscapes.find(c) != std::string::npos) {
+        value->push_back(kEscaped[kEscapes.find(c)]);
+      } else {
+        return false;
+      }
+    }
+
+    return Consume('"');
+  }
+
+  bool ParseNumber(double* value) {
+    size_t start = m_next;
+    if (m_next < m_text.size() && m_text[m_next] == '-') {
+      m_next++;
+    }
+    if (m_text.size() <= m_next || !isdigit(m_text[m_next])) {
+      return false;
+    }
+    if (m_text[m_next] == '0' && m_next + 1 < m_text.size() &&
+        isdigit(m_text[m_next + 1])) {
+      return false;
+    }
+    while (m_next < m_text.size() &&
+           (isdigit(m_text[m_next]) || m_text[m_next] == '.' ||
+            m_text[m_next] == 'e' || m_text[m_next] == 'E' ||
+            m_text[m_next] == '+' || m_text[m_next] == '-')) {
+      m_next++;
+    }
+
+    std::string number = m_text.substr(start, m_next - start);
+    char* end;
+    *value = std::strtod(number.c_str(), &end);
+    return *end == '\0' && number.back() != '.';
+  }
+
+  bool ParseValue(Json* value) {
+    SkipWhitespace();
+    if (m_next == m_text.size()) {
+      return false;
+    }
+
+    char c = m_text[m_next];
+    if (c == '{') {
+      value->type = Json::OBJECT;
+      m_next++;
+      if (Consume('}')) {
+        return true;
+      }
+      do {
+        std::string key;
+        if (!ParseString(&key) || !Consume(':') ||
+            !ParseValue(&value->object[key])) {
+          return false;
+        }
+      } while (Consume(','));
+      return Consume('}');
+    }
+
+    if (c == '[') {
+      value->type = Json::ARRAY;
+      m_next++;
+      if (Consume(']')) {
+        return true;
+      }
+      do {
+        value->array.emplace_back();
+        if (!ParseValue(&value->array.back())) {
+          return false;
+        }
+      } while (Consume(','));
+      return Consume(']');
+    }
+
+    if (c == '"') {
+      value->type = Json::STRING;
+      return ParseString(&value->string);
+    }
+
+    if (ConsumeLiteral("true")) {
+      value->type = Json::BOOLEAN;
+      value->boolean = true;
+      return true;
+    }
+
+    if (ConsumeLiteral("false")) {
+      value->type = Json::BOOLEAN;
+      return true;
+    }
+
+    if (ConsumeLiteral("null")) {
+      value->type = Json::NUL;
+      return true;
+    }
+
+    value->type = Json::NUMBER;
+    return ParseNumber(&value->number);
+  }
+
+  const std::string& m_text;
+  size_t m_next;
+};
+
+void TraceThread(size_t round) {
+  TraceScope outer("test", "Outer", round);
+  TraceScope inner("test", "Inner", kDetail);
+}
+
+// Events are written with microsecond timestamps rounded to nanoseconds.
+bool Contains(const Json& outer, const Json& inner) {
+  static const double kRounding = 0.002;
+  return outer["ts"].number <= inner["ts"].number + kRounding &&
+         inner["ts"].number + inner["dur"].number <=
+             outer["ts"].number + outer["dur"].number + kRounding;
+}
+
+}  // namespace
+
+TEST(TraceTests, WritesChromeTrace) {
+  iris::EnableTracing();
+  ASSERT_TRUE(iris::TracingEnabled());
+
+  {
+    TraceScope root("test", "Root");
+    for (size_t round = 0; round < kNumRounds; round++) {
+      std::vector<std::thread> threads;
+      for (size_t i = 0; i < kNumThreads; i++) {
+        threads.emplace_back(TraceThread, round);
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+    }
+  }
+
+  std::string path = testing::TempDir() + "trace.json";
+  ASSERT_TRUE(iris::WriteTrace(path));
+
+  std::ifstream input(path);
+  std::stringstream contents;
+  contents << input.rdbuf();
+  std::string text = contents.str();
+
+  Json trace;
+  ASSERT_TRUE(JsonParser(text).Parse(&trace)) << text;
+  ASSERT_EQ(Json::OBJECT, trace.type);
+  EXPECT_EQ("ms", trace["displayTimeUnit"].string);
+
+  const Json& events = trace["traceEvents"];
+  ASSERT_EQ(Json::ARRAY, events.type);
+  ASSERT_EQ(1 + 2 * kNumRounds * kNumThreads, events.array.size());
+
+  const Json* root = nullptr;
+  std::map<std::string, size_t> counts;
+  std::map<double, std::vector<const Json*>> outers_by_tid;
+  std::set<double> tids;
+  for (const auto& event : events.array) {
+    ASSERT_EQ(Json::OBJECT, event.type);
+    EXPECT_EQ("test", event["cat"].string);
+    EXPECT_EQ("X", event["ph"].string);
+    ASSERT_EQ(Json::NUMBER, event["ts"].type);
+    ASSERT_EQ(Json::NUMBER, event["dur"].type);
+    EXPECT_LE(0.0, event["ts"].number);
+    EXPECT_LE(0.0, event["dur"].number);
+    ASSERT_EQ(Json::NUMBER, event["pid"].type);
+    ASSERT_EQ(Json::NUMBER, event["tid"].type);
+
+    counts[event["name"].string] += 1;
+    tids.insert(event["tid"].number);
+    if (event["name"].string == "Root") {
+      root = &event;
+    } else if (event["name"].string == "Outer") {
+      outers_by_tid[event["tid"].number].push_back(&event);
+      EXPECT_EQ(Json::NUMBER, event["args"]["index"].type);
+      EXPECT_GT(kNumRounds, event["args"]["index"].number);
+    } else {
+      EXPECT_EQ(kDetail, event["args"]["detail"].string);
+    }
+  }
+
+  EXPECT_EQ(1u, counts["Root"]);
+  EXPECT_EQ(kNumRounds * kNumThreads, counts["Outer"]);
+  EXPECT_EQ(kNumRounds * kNumThreads, counts["Inner"]);
+
+  // The threads of each round reuse the buffers of the threads before them,
+  // and the buffer of the main thread is not handed to any of them.
+  EXPECT_GE(1 + kNumThreads, tids.size());
+
+  ASSERT_NE(nullptr, root);
+  for (const auto& event : events.array) {
+    EXPECT_TRUE(Contains(*root, event));
+    if (event["name"].string != "Inner") {
+      continue;
+    }
+
+    EXPECT_NE((*root)["tid"].number, event["tid"].number);
+    size_t enclosing = 0;
+    for (const Json* outer : outers_by_tid[event["tid"].number]) {
+      enclosing += Contains(*outer, event);
+    }
+    EXPECT_EQ(1u, enclosing);
+  }
+}
\ No newline at end of file
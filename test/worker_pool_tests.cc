@@ -0,0 +1,145 @@
+#include <signal.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "googletest/include/gtest/gtest.h"
+#include "src/common/worker_pool.h"
+
+using iris::PixelBounds;
+using iris::WorkerPool;
+
+namespace {
+
+static const size_t kRegionSize = 4;
+static const size_t kNumRegions = 6;
+
+std::vector<PixelBounds> Regions() {
+  std::vector<PixelBounds> result;
+  for (size_t i = 0; i < kNumRegions; i++) {
+    result.push_back(PixelBounds{i * kRegionSize, (i + 1) * kRegionSize, 0,
+                                 kRegionSize});
+  }
+  return result;
+}
+
+// Each pixel is colored by its position in the image.
+COLOR3 PixelColor(size_t column, size_t row) {
+  COLOR3 result;
+  result.values[0] = static_cast<float_t>(column);
+  result.values[1] = static_cast<float_t>(row);
+  result.values[2] = (float_t)1.0;
+  result.color_space = COLOR_SPACE_LINEAR_SRGB;
+  return result;
+}
+
+void RenderPixels(const PixelBounds& region, std::vector<COLOR3>* pixels) {
+  for (size_t row = region.min_row; row < region.max_row; row++) {
+    for (size_t column = region.min_column; column < region.max_column;
+         column++) {
+      pixels->push_back(PixelColor(column, row));
+    }
+  }
+}
+
+// Runs the pool and checks that every region was received exactly once with
+// the pixels rendered for it.
+void RunAndCheck(WorkerPool& pool,
+                 const WorkerPool::RenderRegion& render_region) {
+  std::vector<PixelBounds> regions = Regions();
+  std::vector<size_t> received(regions.size(), 0);
+  pool.Run(regions, render_region,
+           [&](const PixelBounds& region, const std::vector<COLOR3>& pixels) {
+             size_t index = region.min_column / kRegionSize;
+             ASSERT_LT(index, regions.size());
+             received[index] += 1;
+
+             ASSERT_EQ(region.NumColumns() * region.NumRows(), pixels.size());
+             auto pixel = pixels.begin();
+             for (size_t row = region.min_row; row < region.max_row; row++) {
+               for (size_t column = region.min_column;
+                    column < region.max_column; column++, pixel++) {
+                 COLOR3 expected = PixelColor(column, row);
+                 EXPECT_EQ(expected.values[0], pixel->values[0]);
+                 EXPECT_EQ(expected.values[1], pixel->values[1]);
+                 EXPECT_EQ(expected.values[2], pixel->values[2]);
+               }
+             }
+           });
+
+  for (size_t count : received) {
+    EXPECT_EQ(1u, count);
+  }
+}
+
+// Returns true the first time it is called for a path in any process.
+bool FirstTime(const std::string& path) {
+  FILE* file = fopen(path.c_str(), "wx");
+  if (!file) {
+    return false;
+  }
+  fclose(file);
+  return true;
+}
+
+}  // namespace
+
+TEST(WorkerPoolTests, RendersEachRegion) {
+  WorkerPool pool(2);
+  RunAndCheck(pool, RenderPixels);
+
+  std::stringstream statistics;
+  pool.WriteStatistics(statistics);
+  EXPECT_NE(std::string::npos, statistics.str().find("Worker 1: "));
+  EXPECT_EQ(std::string::npos, statistics.str().find(", 1 restarts"));
+}
+
+TEST(WorkerPoolTests, MoreWorkersThanRegions) {
+  WorkerPool pool(kNumRegions + 2);
+  RunAndCheck(pool, RenderPixels);
+}
+
+// The worker rendering the third region is killed partway through the
+// region, the first time only, so the region must be rendered again by its
+// replacement.
+TEST(WorkerPoolTests, ReplacesKilledWorker) {
+  std::string marker = testing::TempDir() + "killed_worker";
+  std::remove(marker.c_str());
+
+  WorkerPool pool(2);
+  RunAndCheck(pool, [&](const PixelBounds& region,
+                        std::vector<COLOR3>* pixels) {
+    RenderPixels(region, pixels);
+    if (region.min_column == 2 * kRegionSize && FirstTime(marker)) {
+      kill(getpid(), SIGKILL);
+    }
+  });
+
+  std::stringstream statistics;
+  pool.WriteStatistics(statistics);
+  EXPECT_NE(std::string::npos, statistics.str().find(", 1 restarts"))
+      << statistics.str();
+  std::remove(marker.c_str());
+}
+
+TEST(WorkerPoolTests, FailsAfterMaxAttempts) {
+  testing::FLAGS_gtest_death_test_style = "threadsafe";
+
+  EXPECT_EXIT(
+      {
+        WorkerPool pool(2);
+        RunAndCheck(pool, [](const PixelBounds& region,
+                             std::vector<COLOR3>* pixels) {
+          if (region.min_column == 0) {
+            kill(getpid(), SIGKILL);
+          }
+          RenderPixels(region, pixels);
+        });
+      },
+      testing::ExitedWithCode(EXIT_FAILURE),
+      "ERROR: Rendering pixels \\[0, 4\\) x \\[0, 4\\) failed in 3 workers");
+}
\ No newline at end of file